@@ -58,10 +58,11 @@ void EventHandler::startProgram(objects::Plane& plane, const std::vector<tgui::S
         sf::Vector2f plane_scale = plane_sprite.getScale();
         plane_sprite.setScale({ objects::PLANE_SIZE.x / texture_size.x, objects::PLANE_SIZE.y / texture_size.y });
         plane_sprite.setOrigin(texture_size.x/2,texture_size.y/2);
-        plane_sprite.setPosition({ global_parameters::PLANE_INITIAL_POS_X, global_parameters::PLANE_INITIAL_POS_Y });
         plane.SetPrimitive(plane_sprite);
+        plane.SetPosition(plane.GetInitialPosition());
+        plane.SetAltitude(global_parameters::PLANE_INITIAL_ALTITUDE);
         plane.SetToDraw(true);
-        plane.SetTargetPosition({ global_parameters::PLANE_INITIAL_POS_X, global_parameters::PLANE_INITIAL_POS_Y });
+        plane.SetTargetPosition(plane.GetInitialPosition());
         plane.SetAngle(0);
     }
 }
@@ -79,25 +80,103 @@ void EventHandler::finishProgram(objects::Plane& plane, const std::vector<tgui::
 // Метод, отвечающий за передвижение самолета
 void EventHandler::movePlane(objects::Plane& plane, const sf::Vector2f& mousePosition) {
     if (plane.GetToDraw()) {
-        logger_->LogTrivial(boost::log::trivial::severity_level::info, "Plane terminal point has been set to " + std::to_string(mousePosition.x) + ", " + std::to_string(mousePosition.y));
+        logger_->Log(boost::log::trivial::severity_level::info, "Plane terminal point has been set to ", mousePosition.x, ", ", mousePosition.y);
 
         plane.SetTargetPosition(mousePosition);
     }
 }
 
+// Щелчок с Shift (fly-by) или Ctrl (fly-over) продолжает маршрут самолета
+void EventHandler::addWaypoint(objects::Plane& plane, const sf::Vector2f& mousePosition, sim::WaypointType type) {
+    if (plane.GetToDraw()) {
+        const char* kind = type == sim::WaypointType::FLY_OVER ? "fly-over" : "fly-by";
+        logger_->Log(boost::log::trivial::severity_level::info, "Plane ", kind, " waypoint has been added at ", mousePosition.x, ", ", mousePosition.y);
+
+        plane.AddWaypoint(mousePosition, type);
+    }
+}
+
 void EventHandler::changeSliderValue(gui_wrapper::TextLabel& slider_label, objects::Plane& plane, bool change_linear, float value) {
-    slider_label.SetLabelText(objects::Plane::FloatToStringWithPrecision(value));
+    gui_wrapper::NumberFormatter formatter;
+    slider_label.UpdateLabelText(formatter.AppendFixed(value, 2).GetView());
 
     if (change_linear) {
-        logger_->LogTrivial(boost::log::trivial::severity_level::info, "Plane linear speed has been set to " + std::to_string(value));
+        logger_->Log(boost::log::trivial::severity_level::info, "Plane linear speed has been set to ", value);
         plane.SetLinearSpeed(value);
     }
     else {
-        logger_->LogTrivial(boost::log::trivial::severity_level::info, "Plane angle speed has been set to " + std::to_string(value));
+        logger_->Log(boost::log::trivial::severity_level::info, "Plane angle speed has been set to ", value);
         plane.SetAngleSpeed(value);
     }
 }
 
+// Метод, отвечающий за кнопки Simulation -> 20/60/240 Hz
+void EventHandler::changeSimulationRate(sim::Simulation& simulation, const std::vector<tgui::String>& menuItem) {
+    if (menuItem.size() == 2 && menuItem[0] == "Simulation") {
+        float rate = 0.f;
+        if (menuItem[1] == "20 Hz") {
+            rate = global_parameters::SIM_LOW_RATE;
+        }
+        else if (menuItem[1] == "60 Hz") {
+            rate = global_parameters::SIM_DEFAULT_RATE;
+        }
+        else if (menuItem[1] == "240 Hz") {
+            rate = global_parameters::SIM_HIGH_RATE;
+        }
+
+        if (rate > 0.f) {
+            logger_->Log(boost::log::trivial::severity_level::info, "Simulation rate has been set to ", rate, " Hz");
+            simulation.Post({ sim::CommandType::SET_RATE, 0, 0.f, 0.f, rate });
+        }
+    }
+}
+
+// Метод, отвечающий за кнопки Simulation -> x1/x10/x100
+void EventHandler::changeTimeScale(sim::Simulation& simulation, const std::vector<tgui::String>& menuItem) {
+    if (menuItem.size() == 2 && menuItem[0] == "Simulation") {
+        float time_scale = 0.f;
+        if (menuItem[1] == "x1") {
+            time_scale = 1.f;
+        }
+        else if (menuItem[1] == "x10") {
+            time_scale = 10.f;
+        }
+        else if (menuItem[1] == "x100") {
+            time_scale = 100.f;
+        }
+
+        if (time_scale > 0.f) {
+            logger_->Log(boost::log::trivial::severity_level::info, "Simulation time scale has been set to x", time_scale);
+            simulation.Post({ sim::CommandType::SET_TIME_SCALE, 0, 0.f, 0.f, time_scale });
+        }
+    }
+}
+
+// Метод, отвечающий за кнопки Altitude -> FL100/FL200/FL300/FL400
+void EventHandler::changeFlightLevel(objects::Plane& plane, const std::vector<tgui::String>& menuItem) {
+    if (menuItem.size() == 2 && menuItem[0] == "Altitude") {
+        // Эшелон - высота в сотнях футов
+        int flight_level = 0;
+        if (menuItem[1] == "FL100") {
+            flight_level = 100;
+        }
+        else if (menuItem[1] == "FL200") {
+            flight_level = 200;
+        }
+        else if (menuItem[1] == "FL300") {
+            flight_level = 300;
+        }
+        else if (menuItem[1] == "FL400") {
+            flight_level = 400;
+        }
+
+        if (flight_level > 0) {
+            const float altitude = flight_level * 100 * 0.3048f;
+            logger_->Log(boost::log::trivial::severity_level::info, "Plane target altitude has been set to FL", flight_level);
+            plane.SetTargetAltitude(altitude);
+        }
+    }
+}
 
 // Системный метод для передачи логгера в EventHandler
 void EventHandler::SetLogger(utils::log_handler::LogHandler* logger) {
@@ -2,8 +2,10 @@
 
 #include "gui/coords.h"
 #include "gui/fps.h"
+#include "gui/number_formatter.h"
 #include "gui/text_label.h"
 #include "objects/plane.h"
+#include "sim/simulation.h"
 #include "../utils/log_handler.h"
 
 #include <TGUI/TGUI.hpp>
@@ -39,9 +41,17 @@ public:
     static void finishProgram(objects::Plane& plane, const std::vector<tgui::String>& menuItem);
 
     static void movePlane(objects::Plane& plane, const sf::Vector2f& mousePosition);
+
+    static void addWaypoint(objects::Plane& plane, const sf::Vector2f& mousePosition, sim::WaypointType type);
     
     static void changeSliderValue(gui_wrapper::TextLabel& slider_label, objects::Plane& plane, bool change_linear, float value);
 
+    static void changeSimulationRate(sim::Simulation& simulation, const std::vector<tgui::String>& menuItem);
+
+    static void changeTimeScale(sim::Simulation& simulation, const std::vector<tgui::String>& menuItem);
+
+    static void changeFlightLevel(objects::Plane& plane, const std::vector<tgui::String>& menuItem);
+
     static void SetLogger(utils::log_handler::LogHandler* logger);
 
     ~EventHandler();
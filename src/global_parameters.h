@@ -20,13 +20,79 @@ constexpr size_t MENU_FONTSIZE = HEIGHT * 0.02;
 constexpr size_t CANVAS_WIDTH = WIDTH * 0.6;
 constexpr size_t CANVAS_HEIGHT = HEIGHT * 0.6;
 
+// Больше грязных областей за кадр - холст перерисовывается целиком
+constexpr size_t CANVAS_MAX_DIRTY_REGIONS = 32;
+
+// Пределы масштаба холста (во сколько раз вид меньше или больше исходного)
+constexpr float CANVAS_MIN_ZOOM = 1.f / 256.f;
+constexpr float CANVAS_MAX_ZOOM = 4.f;
+constexpr float CANVAS_ZOOM_STEP = 1.25f;
+
+// Data refresh
+// Периоды опроса погоды и рейсов задаются в их файлах настроек. Пауза
+// растягивается или сжимается случайно на долю DATA_REFRESH_JITTER,
+// после неудачи повтор через DATA_RETRY_DELAY секунд, и каждая
+// следующая неудача подряд удваивает паузу до DATA_MAX_BACKOFF
+constexpr double DATA_REFRESH_JITTER = 0.1;
+constexpr double DATA_RETRY_DELAY = 5.;
+constexpr double DATA_MAX_BACKOFF = 600.;
+
+// Logging
+// Журнал пишется фоновым потоком: вызов только кладет запись в буфер
+// на LOG_QUEUE_CAPACITY записей, поток забирает их пачками и, когда
+// записей нет, ждет LOG_FLUSH_INTERVAL секунд
+constexpr size_t LOG_QUEUE_CAPACITY = 8192;
+constexpr double LOG_FLUSH_INTERVAL = 0.05;
+
+// Новый файл журнала начинается после LOG_ROTATION_SIZE байт и каждые
+// LOG_ROTATION_INTERVAL секунд от полуночи; старые части сжимаются в
+// .gz, хранятся последние LOG_ROTATION_KEEP
+constexpr uint64_t LOG_ROTATION_SIZE = 16 * 1024 * 1024;
+constexpr int64_t LOG_ROTATION_INTERVAL = 24 * 60 * 60;
+constexpr size_t LOG_ROTATION_KEEP = 30;
+constexpr bool LOG_ROTATION_COMPRESS = true;
+
+// Двоичный журнал событий симуляции (разбирается утилитой logdump).
+// EVENT_LOG_AIRCRAFT_STATE - писать состояние каждого самолета на
+// каждом шаге симуляции
+constexpr const char* EVENT_LOG_PATH = "../logs/events.bin";
+constexpr size_t EVENT_LOG_CAPACITY = 65536;
+constexpr double EVENT_LOG_FLUSH_INTERVAL = 0.05;
+constexpr bool EVENT_LOG_AIRCRAFT_STATE = true;
+
+// Запись сеанса для воспроизведения утилитой replay. Каждый запуск
+// пишет свой файл "session.ГГГГММДД-ЧЧММСС.rec" рядом с
+// SESSION_RECORD_PATH, хранятся последние SESSION_RECORD_KEEP
+constexpr const char* SESSION_RECORD_PATH = "../logs/session.rec";
+constexpr size_t SESSION_RECORD_KEEP = 20;
+
+// Записи сеанса пишет в файл фоновый поток: буфер на
+// SESSION_RECORD_CAPACITY записей, SESSION_KEYFRAME_BUFFERS буферов
+// опорных кадров; когда записей нет, поток ждет
+// SESSION_RECORD_FLUSH_INTERVAL секунд
+constexpr size_t SESSION_RECORD_CAPACITY = 4096;
+constexpr size_t SESSION_KEYFRAME_BUFFERS = 4;
+constexpr double SESSION_RECORD_FLUSH_INTERVAL = 0.05;
+
+// Map tiles
+// Плитки лежат в MAP_TILES_PATH/z/x/y.png, плитка уровня 0 покрывает
+// MAP_TILE_WORLD_SIZE единиц мира от левого верхнего угла map.png
+constexpr const char* MAP_TILES_PATH = "../meta/tiles/";
+constexpr size_t MAP_TILE_SIZE = 256;
+constexpr float MAP_TILE_WORLD_SIZE = 512.f;
+constexpr uint32_t MAP_TILE_MAX_ZOOM = 12;
+
+constexpr size_t MAP_TILE_CACHE_SIZE = 256;
+constexpr size_t MAP_TILE_DECODE_THREADS = 2;
+constexpr size_t MAP_TILE_UPLOADS_PER_FRAME = 4;
+
 // Separator lines
 constexpr size_t LINE_WIDTH = 2;
 
 constexpr size_t TW_HLINE_Y = 100;
 
 constexpr size_t AT_HLINE_X = 320;
-constexpr size_t AT_HLINE_Y = 540;
+constexpr size_t AT_HLINE_Y = 420;
 constexpr size_t AT_HLINE_LENGTH = WIDTH - AT_HLINE_X;
 constexpr size_t AT_HLINE_OFFSET = 60;
 
@@ -41,20 +107,92 @@ constexpr size_t MAIN_HLINE_LENGTH = WIDTH - AT_HLINE_LENGTH;
 constexpr size_t MAIN_VLINE_X = CANVAS_WIDTH;
 constexpr size_t MAIN_VLINE_LENGTH = CANVAS_HEIGHT;
 
+// Projection
+// Опорная точка локальной системы ENU - аэропорт Вашингтон Рейган (KDCA)
+constexpr double REFERENCE_LATITUDE = 38.8521;
+constexpr double REFERENCE_LONGITUDE = -77.0377;
+
 // Plane
-constexpr float PLANE_INITIAL_POS_X = 100.f;
-constexpr float PLANE_INITIAL_POS_Y = 100.f;
+// Начальное положение самолета, градусы
+constexpr double PLANE_INITIAL_LATITUDE = 38.989216;
+constexpr double PLANE_INITIAL_LONGITUDE = -77.220134;
+
+constexpr float PLANE_CRITICAL_ANGLE = 0.02f;
 
-constexpr int PLANE_ANGLE_ROTATION_X = 480;
-constexpr int PLANE_ANGLE_ROTATION_Y = 360;
+// Метры в секунду и радианы в секунду
+constexpr float PLANE_DEFAULT_SPEED = 250.f;
+constexpr float PLANE_DEFAULT_ANGLE_SPEED = 0.05f;
 
-constexpr float PLANE_ROTATION_COEFFICIENT_X = 0.61268f;
-constexpr float PLANE_ROTATION_COEFFICIENT_Y = -0.36113f;
+// Начальная высота, метры (FL100)
+constexpr float PLANE_INITIAL_ALTITUDE = 3048.f;
 
-constexpr float PLANE_INITIAL_ANGLE_POS_X = -77.347776f;
-constexpr float PLANE_INITIAL_ANGLE_POS_Y = 39.089530f;
+// Simulation
+// Частота шагов симуляции, Гц
+constexpr float SIM_LOW_RATE = 20.f;
+constexpr float SIM_DEFAULT_RATE = 60.f;
+constexpr float SIM_HIGH_RATE = 240.f;
 
-constexpr float PLANE_CRITICAL_ANGLE = 0.02f;
+// Предел шагов за один кадр, защита от лавинного отставания
+constexpr size_t SIM_MAX_STEPS_PER_FRAME = 1000;
+
+// Емкость очереди команд от интерфейса к потоку симуляции (степень двойки)
+constexpr size_t SIM_COMMAND_QUEUE_CAPACITY = 1024;
+
+// Число потоков планировщика задач вместе с потоком симуляции, 0 - по числу ядер
+constexpr size_t SIM_WORKER_THREADS = 0;
+
+// Самолетов в одном куске параллельного шага (кратно ширине AVX2)
+constexpr size_t SIM_STEP_GRAIN = 1024;
+
+// Минимальный горизонтальный интервал между самолетами, метры (5 морских миль)
+constexpr float SIM_CONFLICT_SEPARATION = 9260.f;
+
+// Нижний предел интервала, метры. Интервал задает размер ячейки
+// SpatialGrid, и при почти нулевом координата в ячейках переполняется
+constexpr float SIM_MIN_CONFLICT_SEPARATION = 1.f;
+
+// Минимальный вертикальный интервал, метры (1000 футов). Самолеты,
+// разнесенные по высоте хотя бы на него, в конфликт не попадают
+constexpr float SIM_VERTICAL_SEPARATION = 304.8f;
+
+// Записей сетки в одном куске параллельного поиска конфликтов
+constexpr size_t SIM_CONFLICT_GRAIN = 2048;
+
+// Прогноз траекторий: горизонт, шаг отсчетов и подшаг расчета, секунды
+constexpr float SIM_PREDICTION_HORIZON = 600.f;
+constexpr float SIM_PREDICTION_STEP = 10.f;
+constexpr float SIM_PREDICTION_SUBSTEP = 1.f;
+
+// Путей в одном куске параллельного прогноза
+constexpr size_t SIM_PREDICTION_GRAIN = 256;
+
+// Период поиска конфликтов по прогнозу в модельном времени, секунды,
+// и число срезов прогноза в одном куске параллельного поиска
+constexpr float SIM_PROBE_INTERVAL = 1.f;
+constexpr size_t SIM_PROBE_SLICE_GRAIN = 4;
+
+// Период опорных кадров записи сеанса в модельном времени, секунды:
+// перемотка при воспроизведении пересчитывает не больше этого
+constexpr float SIM_KEYFRAME_INTERVAL = 10.f;
+
+// Маршруты: угловая скорость, ниже которой радиус разворота
+// перестает расти, радианы в секунду
+constexpr float SIM_ROUTE_MIN_ANGLE_SPEED = 1e-3f;
+
+// Поле ветра: ячейка кеша по горизонтали и по высоте, метры
+constexpr float SIM_WIND_CELL_SIZE = 20000.f;
+constexpr float SIM_WIND_BAND_HEIGHT = 1000.f;
+
+// Сеточная погода (формат в sim/weather_grid.h). Если файла нет,
+// ветер берется из приземного наблюдения WeatherHandler
+constexpr const char* WEATHER_GRID_PATH = "../utils/weather_grid.bin";
+
+// Вертикальный профиль: скороподъемность у земли и скорость снижения, м/с,
+// наибольшее вертикальное ускорение, м/с^2, и потолок, метры
+constexpr float SIM_CLIMB_RATE = 15.f;
+constexpr float SIM_DESCENT_RATE = 12.5f;
+constexpr float SIM_VERTICAL_ACCELERATION = 1.f;
+constexpr float SIM_SERVICE_CEILING = 12500.f;
 
 // Labels
 constexpr size_t TT_LABEL_X = WIDTH - 190;
@@ -93,10 +231,15 @@ constexpr size_t WIND_DIR_LABEL_Y = WIND_SPEED_LABEL_Y;
 constexpr size_t TIMES_OF_DAY_TEXT_LABEL_X = WIDTH - 200;
 constexpr size_t TIMES_OF_DAY_TEXT_LABEL_Y = 280;
 
-constexpr float MAP_TOP_COORDINATES = 39.089530f;
-constexpr float MAP_LEFT_COORDINATES = -77.347776f;
-constexpr float MAP_WIDTH = 0.61268f;
-constexpr float MAP_HEIGHT = -0.36113f;
+// Географические границы map.png, градусы. Единица мира на экране
+// равна пикселю map.png по горизонтали
+constexpr double MAP_TOP_COORDINATES = 39.089530;
+constexpr double MAP_LEFT_COORDINATES = -77.347776;
+constexpr double MAP_WIDTH = 0.61268;
+constexpr double MAP_HEIGHT = -0.36113;
+
+constexpr double MAP_IMAGE_WIDTH = 480.;
+constexpr double MAP_IMAGE_HEIGHT = 360.;
 
 constexpr size_t TIMES_OF_DAY_LABEL_X = TIMES_OF_DAY_TEXT_LABEL_X + 20;
 constexpr size_t TIMES_OF_DAY_LABEL_Y = TIMES_OF_DAY_TEXT_LABEL_Y + 20;
@@ -138,8 +281,15 @@ constexpr size_t FLIGHT_STATUS_TEXT_LABEL_Y = FLIGHT_NUMBER_TEXT_LABEL_Y;
 
 constexpr size_t FLIGHT_STATUS_LABEL_X = 710;
 
-constexpr size_t AVIATION_PARAMETERS_START_Y = 445;
-constexpr size_t AVIATION_PARAMETERS_OFFSET = 60;
+// Табло рейсов под шапкой таблицы: метки создаются только для
+// помещающихся строк, колесо прокручивает FLIGHT_BOARD_SCROLL_ROWS строк
+constexpr size_t FLIGHT_BOARD_X = AT_HLINE_X;
+constexpr size_t FLIGHT_BOARD_Y = AT_HLINE_Y + LINE_WIDTH;
+constexpr size_t FLIGHT_BOARD_WIDTH = AT_HLINE_LENGTH;
+constexpr size_t FLIGHT_BOARD_HEIGHT = HEIGHT - FLIGHT_BOARD_Y;
+constexpr size_t FLIGHT_BOARD_ROW_HEIGHT = 20;
+constexpr size_t FLIGHT_BOARD_SCROLLBAR_WIDTH = 12;
+constexpr unsigned int FLIGHT_BOARD_SCROLL_ROWS = 3;
 
 constexpr size_t PLANE_INFO_TEXT_LABEL_X = 40;
 constexpr size_t PLANE_INFO_TEXT_LABEL_Y = 390;
@@ -156,6 +306,13 @@ constexpr size_t LATITUDE_TEXT_LABEL_Y = LONGTITUDE_TEXT_LABEL_Y + 30;
 constexpr size_t LATITUDE_LABEL_X = LONGTITUDE_LABEL_X;
 constexpr size_t LATITUDE_LABEL_Y = LATITUDE_TEXT_LABEL_Y;
 
+// Высота и вертикальная скорость справа от долготы и широты
+constexpr size_t ALTITUDE_LABEL_X = LONGTITUDE_LABEL_X + 110;
+constexpr size_t ALTITUDE_LABEL_Y = LONGTITUDE_LABEL_Y;
+
+constexpr size_t VERTICAL_RATE_LABEL_X = ALTITUDE_LABEL_X;
+constexpr size_t VERTICAL_RATE_LABEL_Y = LATITUDE_LABEL_Y;
+
 constexpr size_t LINEAR_SPEED_TEXT_LABEL_X = LONGTITUDE_TEXT_LABEL_X;
 constexpr size_t LINEAR_SPEED_TEXT_LABEL_Y = LATITUDE_TEXT_LABEL_Y + 50;
 
@@ -166,16 +323,18 @@ constexpr size_t ANGLE_SPEED_TEXT_LABEL_Y = LINEAR_SPEED_TEXT_LABEL_Y + 30;
 constexpr size_t LINEAR_SPEED_SLIDER_X = LINEAR_SPEED_TEXT_LABEL_X + 150;
 constexpr size_t LINEAR_SPEED_SLIDER_Y = LINEAR_SPEED_TEXT_LABEL_Y;
 
+// Метры в секунду
 constexpr float LINEAR_SPEED_SLIDER_MINIMUM = 0.f;
-constexpr float LINEAR_SPEED_SLIDER_MAXIMUM = 5.f;
-constexpr float LINEAR_SPEED_SLIDER_STEP = 0.05f;
+constexpr float LINEAR_SPEED_SLIDER_MAXIMUM = 1000.f;
+constexpr float LINEAR_SPEED_SLIDER_STEP = 10.f;
 
 constexpr size_t ANGLE_SPEED_SLIDER_X = LINEAR_SPEED_SLIDER_X;
 constexpr size_t ANGLE_SPEED_SLIDER_Y = ANGLE_SPEED_TEXT_LABEL_Y;
 
+// Радианы в секунду
 constexpr float ANGLE_SPEED_SLIDER_MINIMUM = 0.f;
-constexpr float ANGLE_SPEED_SLIDER_MAXIMUM = 0.2f;
-constexpr float ANGLE_SPEED_SLIDER_STEP = 0.005f;
+constexpr float ANGLE_SPEED_SLIDER_MAXIMUM = 0.5f;
+constexpr float ANGLE_SPEED_SLIDER_STEP = 0.01f;
 
 constexpr size_t LINEAR_SPEED_SLIDER_VALUE_LABEL_X = LINEAR_SPEED_SLIDER_X + 110;
 constexpr size_t LINEAR_SPEED_SLIDER_VALUE_LABEL_Y = LINEAR_SPEED_SLIDER_Y;
@@ -192,5 +351,9 @@ struct RGB {
 
 constexpr RGB CANVAS_DEFAULT_COLOR = { 211, 211, 211 };
 constexpr RGB BACKGROUND_DEFAULT_COLOR = { 255, 255, 255 };
+// Самолеты в конфликте (нарушен горизонтальный интервал)
+constexpr RGB PLANE_CONFLICT_COLOR = { 230, 40, 40 };
+// Самолеты, у которых конфликт ожидается по прогнозу
+constexpr RGB PLANE_PREDICTED_CONFLICT_COLOR = { 240, 170, 30 };
 
 } // namespace global_parameters
\ No newline at end of file
@@ -1,14 +1,30 @@
 #include "canvas.h"
 
+#include <algorithm>
+
 using namespace event_handler;
 
 namespace gui_wrapper {
 
-void Canvas::InitializeCanvas(objects::Plane& plane) {
+void Canvas::InitializeCanvas(objects::Plane& plane, const sim::Projection* projection) {
     canvas_->setWidth(global_parameters::CANVAS_WIDTH);
     canvas_->setHeight(global_parameters::CANVAS_HEIGHT);
     canvas_->setAutoLayout(tgui::AutoLayout::Manual);
-    canvas_->onMousePress(&EventHandler::movePlane, std::ref(plane));
+
+    // Щелчок приходит в пикселях холста, а цель самолета задается в метрах ENU.
+    // Простой щелчок - прямой полет на точку, с Shift или Ctrl - точка маршрута
+    canvas_->onMousePress([this, &plane, projection](tgui::Vector2f position) {
+        const sf::Vector2f target = projection->ScreenToEnu(MapPixelToWorld({ position.x, position.y }));
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::LShift) || sf::Keyboard::isKeyPressed(sf::Keyboard::RShift)) {
+            EventHandler::addWaypoint(plane, target, sim::WaypointType::FLY_BY);
+        }
+        else if (sf::Keyboard::isKeyPressed(sf::Keyboard::LControl) || sf::Keyboard::isKeyPressed(sf::Keyboard::RControl)) {
+            EventHandler::addWaypoint(plane, target, sim::WaypointType::FLY_OVER);
+        }
+        else {
+            EventHandler::movePlane(plane, target);
+        }
+    });
 }
 
 tgui::CanvasSFML::Ptr Canvas::GetCanvas() const {
@@ -27,4 +43,37 @@ tgui::Vector2f Canvas::GetSize() const {
     return canvas_->getSize();
 }
 
+const sf::View& Canvas::GetView() const {
+    return view_;
+}
+
+void Canvas::Zoom(float factor, const sf::Vector2f& pixel) {
+    const float current = view_.getSize().x / global_parameters::CANVAS_WIDTH;
+    const float target = std::clamp(current * factor, global_parameters::CANVAS_MIN_ZOOM, global_parameters::CANVAS_MAX_ZOOM);
+
+    const sf::Vector2f anchor = MapPixelToWorld(pixel);
+    view_.zoom(target / current);
+
+    // Возвращаем точку под курсором на прежнее место
+    view_.move(anchor - MapPixelToWorld(pixel));
+}
+
+void Canvas::Pan(const sf::Vector2f& delta) {
+    view_.move(-delta.x * view_.getSize().x / global_parameters::CANVAS_WIDTH,
+               -delta.y * view_.getSize().y / global_parameters::CANVAS_HEIGHT);
+}
+
+sf::Vector2f Canvas::MapPixelToWorld(const sf::Vector2f& pixel) const {
+    const sf::Vector2f top_left = view_.getCenter() - view_.getSize() / 2.f;
+    return { top_left.x + pixel.x * view_.getSize().x / global_parameters::CANVAS_WIDTH,
+             top_left.y + pixel.y * view_.getSize().y / global_parameters::CANVAS_HEIGHT
+           };
+}
+
+bool Canvas::MapWindowToPixel(const sf::Vector2f& window_position, sf::Vector2f& pixel) const {
+    const tgui::Vector2f position = canvas_->getAbsolutePosition();
+    pixel = { window_position.x - position.x, window_position.y - position.y };
+    return pixel.x >= 0 && pixel.y >= 0 && pixel.x < global_parameters::CANVAS_WIDTH && pixel.y < global_parameters::CANVAS_HEIGHT;
+}
+
 } // namespace gui_wrapper
\ No newline at end of file
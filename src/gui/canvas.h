@@ -9,7 +9,7 @@ class Canvas {
 public:
     Canvas() = default;
 
-    void InitializeCanvas(objects::Plane& plane);
+    void InitializeCanvas(objects::Plane& plane, const sim::Projection* projection);
 
     tgui::CanvasSFML::Ptr GetCanvas() const;
 
@@ -19,8 +19,23 @@ public:
 
     tgui::Vector2f GetSize() const;
 
+    // Вид на мир: масштаб и сдвиг карты и самолетов
+    const sf::View& GetView() const;
+
+    // Масштабирует вид в factor раз, оставляя на месте точку под пикселем холста
+    void Zoom(float factor, const sf::Vector2f& pixel);
+
+    // Сдвигает вид вслед за курсором на delta пикселей холста
+    void Pan(const sf::Vector2f& delta);
+
+    sf::Vector2f MapPixelToWorld(const sf::Vector2f& pixel) const;
+
+    // Переводит точку окна в пиксель холста, false - если точка вне холста
+    bool MapWindowToPixel(const sf::Vector2f& window_position, sf::Vector2f& pixel) const;
+
 private:
     tgui::CanvasSFML::Ptr canvas_ = tgui::CanvasSFML::create();
+    sf::View view_{ sf::FloatRect(0.f, 0.f, global_parameters::CANVAS_WIDTH, global_parameters::CANVAS_HEIGHT) };
 };
 
 } // namespace gui_wrapper
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include "fleet_renderer.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace global_parameters;
+
+namespace gui_wrapper {
+
+namespace {
+
+sf::FloatRect GetQuadBounds(const sf::Vector2f* corners) {
+    float left = corners[0].x;
+    float top = corners[0].y;
+    float right = corners[0].x;
+    float bottom = corners[0].y;
+    for (size_t i = 1; i < 4; ++i) {
+        left = std::min(left, corners[i].x);
+        top = std::min(top, corners[i].y);
+        right = std::max(right, corners[i].x);
+        bottom = std::max(bottom, corners[i].y);
+    }
+    return { left, top, right - left, bottom - top };
+}
+
+} // namespace
+
+void FleetRenderer::InitializeRenderer(const std::string& texture_path, const sf::Vector2f& plane_size, const sim::Projection* projection) {
+    projection_ = projection;
+    texture_.loadFromFile(texture_path);
+    texture_.setSmooth(true);
+    plane_size_ = plane_size;
+}
+
+void FleetRenderer::Update(const sim::FleetSnapshot& snapshot) {
+    const float alpha = snapshot.GetAlpha();
+    const sf::Vector2f texture_size(texture_.getSize());
+    const sf::Vector2f half = plane_size_ / 2.f;
+    const sf::Color conflict_color(PLANE_CONFLICT_COLOR.r, PLANE_CONFLICT_COLOR.g, PLANE_CONFLICT_COLOR.b);
+    const sf::Color predicted_color(PLANE_PREDICTED_CONFLICT_COLOR.r, PLANE_PREDICTED_CONFLICT_COLOR.g, PLANE_PREDICTED_CONFLICT_COLOR.b);
+
+    // Углы четырехугольника относительно центра и соответствующие им
+    // точки текстуры, в порядке обхода sf::Quads
+    const sf::Vector2f corners[4] = { { -half.x, -half.y }, { half.x, -half.y }, { half.x, half.y }, { -half.x, half.y } };
+    const sf::Vector2f tex_coords[4] = { { 0.f, 0.f }, { texture_size.x, 0.f }, { texture_size.x, texture_size.y }, { 0.f, texture_size.y } };
+
+    // resize не освобождает память, поэтому при неизменном числе
+    // самолетов кадр обходится без выделений
+    vertices_.resize(snapshot.Size() * 4);
+    slot_corners_.resize(snapshot.Size() * 4);
+    slot_drawn_.resize(snapshot.Size(), 0);
+    slot_conflict_.resize(snapshot.Size(), 0);
+    dirty_regions_.clear();
+
+    const size_t count = snapshot.Size();
+    east_.resize(count);
+    north_.resize(count);
+    heading_.resize(count);
+    screen_x_.resize(count);
+    screen_y_.resize(count);
+    screen_heading_.resize(count);
+
+    for (size_t slot = 0; slot < count; ++slot) {
+        const sf::Vector2f position = snapshot.GetInterpolatedPosition(slot, alpha);
+        east_[slot] = position.x;
+        north_[slot] = position.y;
+        heading_[slot] = snapshot.GetInterpolatedAngle(slot, alpha);
+    }
+
+    projection_->ToScreen(east_.data(), north_.data(), heading_.data(), count,
+                          screen_x_.data(), screen_y_.data(), screen_heading_.data());
+
+    size_t vertex = 0;
+    for (size_t slot = 0; slot < snapshot.Size(); ++slot) {
+        sf::Vector2f* previous = &slot_corners_[slot * 4];
+
+        if (!snapshot.active[slot]) {
+            if (slot_drawn_[slot]) {
+                dirty_regions_.push_back(GetQuadBounds(previous));
+                slot_drawn_[slot] = 0;
+            }
+            continue;
+        }
+
+        const sf::Vector2f position(screen_x_[slot], screen_y_[slot]);
+
+        // Картинка самолета смотрит вверх, а нулевой курс - вправо
+        const float rotation = screen_heading_[slot] + static_cast<float>(M_PI) / 2;
+        const float cos_rotation = std::cos(rotation);
+        const float sin_rotation = std::sin(rotation);
+
+        sf::Vector2f current[4];
+        for (size_t i = 0; i < 4; ++i) {
+            current[i] = { position.x + corners[i].x * cos_rotation - corners[i].y * sin_rotation,
+                           position.y + corners[i].x * sin_rotation + corners[i].y * cos_rotation
+                         };
+        }
+
+        // 2 - интервал нарушен сейчас, 1 - будет нарушен по прогнозу
+        uint8_t conflict = 0;
+        if (slot < snapshot.conflict.size() && snapshot.conflict[slot]) {
+            conflict = 2;
+        }
+        else if (slot < snapshot.predicted_conflict.size() && snapshot.predicted_conflict[slot]) {
+            conflict = 1;
+        }
+
+        // Неподвижный самолет не пачкает холст, если не сменил цвет
+        if (!slot_drawn_[slot] || conflict != slot_conflict_[slot] || !std::equal(current, current + 4, previous)) {
+            if (slot_drawn_[slot]) {
+                dirty_regions_.push_back(GetQuadBounds(previous));
+            }
+            dirty_regions_.push_back(GetQuadBounds(current));
+            std::copy(current, current + 4, previous);
+            slot_drawn_[slot] = 1;
+            slot_conflict_[slot] = conflict;
+        }
+
+        // Самолеты в конфликте перекрашиваются
+        const sf::Color color = conflict == 2 ? conflict_color : (conflict == 1 ? predicted_color : sf::Color::White);
+
+        for (size_t i = 0; i < 4; ++i) {
+            sf::Vertex& v = vertices_[vertex++];
+            v.position = current[i];
+            v.texCoords = tex_coords[i];
+            v.color = color;
+        }
+    }
+
+    vertices_.resize(vertex);
+}
+
+size_t FleetRenderer::GetDrawnCount() const {
+    return vertices_.getVertexCount() / 4;
+}
+
+const std::vector<sf::FloatRect>& FleetRenderer::GetDirtyRegions() const {
+    return dirty_regions_;
+}
+
+void FleetRenderer::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    if (vertices_.getVertexCount() == 0) {
+        return;
+    }
+    states.texture = &texture_;
+    target.draw(vertices_, states);
+}
+
+} // namespace gui_wrapper
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "../global_parameters.h"
+#include "../sim/fleet_snapshot.h"
+#include "../sim/projection.h"
+
+#include <string>
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+/*
+   Пакетная отрисовка самолетов. Каждый активный слот снимка
+   превращается в один четырехугольник общего массива вершин,
+   повернутый на процессоре, и весь флот рисуется одним вызовом
+   draw с общей текстурой plane.png. Положения и курсы из ENU
+   переводятся в экранные координаты одним пакетным вызовом Projection.
+   Самолеты в конфликте рисуются цветом PLANE_CONFLICT_COLOR, а с
+   конфликтом по прогнозу - PLANE_PREDICTED_CONFLICT_COLOR.
+*/
+
+namespace gui_wrapper {
+
+class FleetRenderer : public sf::Drawable {
+public:
+    FleetRenderer() = default;
+
+    void InitializeRenderer(const std::string& texture_path, const sf::Vector2f& plane_size, const sim::Projection* projection);
+
+    // Перестраивает вершины по снимку, интерполируя между шагами симуляции
+    void Update(const sim::FleetSnapshot& snapshot);
+
+    size_t GetDrawnCount() const;
+
+    // Области холста, изменившиеся при последнем Update: старое и
+    // новое место каждого сдвинувшегося, появившегося или исчезнувшего самолета
+    const std::vector<sf::FloatRect>& GetDirtyRegions() const;
+
+private:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+private:
+    const sim::Projection* projection_ = nullptr;
+    sf::Texture texture_;
+    sf::Vector2f plane_size_;
+    sf::VertexArray vertices_{ sf::Quads };
+
+    // Углы четырехугольника каждого слота в прошлом кадре
+    std::vector<sf::Vector2f> slot_corners_;
+    std::vector<uint8_t> slot_drawn_;
+    std::vector<uint8_t> slot_conflict_;
+    std::vector<sf::FloatRect> dirty_regions_;
+
+    // Интерполированные положения и курсы в ENU и их экранные значения
+    std::vector<float> east_;
+    std::vector<float> north_;
+    std::vector<float> heading_;
+    std::vector<float> screen_x_;
+    std::vector<float> screen_y_;
+    std::vector<float> screen_heading_;
+};
+
+} // namespace gui_wrapper
\ No newline at end of file
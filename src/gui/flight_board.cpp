@@ -0,0 +1,113 @@
+#include "flight_board.h"
+
+#include "../global_parameters.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace global_parameters;
+
+namespace gui_wrapper {
+
+void FlightBoard::InitializeBoard(const sf::Vector2f& position, const sf::Vector2f& size, float row_height,
+                                  const std::array<float, FLIGHT_BOARD_COLUMNS>& columns, int text_size) {
+    board_->setPosition(position.x, position.y);
+    board_->setSize(size.x, size.y);
+
+    const float scrollbar_width = static_cast<float>(FLIGHT_BOARD_SCROLLBAR_WIDTH);
+    scrollbar_->setPosition(size.x - scrollbar_width, 0.f);
+    scrollbar_->setSize(scrollbar_width, size.y);
+    scrollbar_->setScrollAmount(FLIGHT_BOARD_SCROLL_ROWS);
+    scrollbar_->setAutoHide(true);
+    scrollbar_->onValueChange([this](unsigned int value) {
+        if (value != first_row_) {
+            first_row_ = value;
+            FillRows();
+        }
+    });
+    board_->add(scrollbar_);
+
+    rows_area_ = { position.x, position.y, size.x - scrollbar_width, size.y };
+    visible_rows_ = static_cast<size_t>(size.y / row_height);
+
+    // Текст по центру строки по вертикали
+    const float text_offset = std::max(0.f, (row_height - static_cast<float>(text_size)) / 2.f);
+    labels_.resize(visible_rows_ * FLIGHT_BOARD_COLUMNS);
+    for (size_t row = 0; row < visible_rows_; ++row) {
+        for (size_t column = 0; column < FLIGHT_BOARD_COLUMNS; ++column) {
+            TextLabel& label = labels_[row * FLIGHT_BOARD_COLUMNS + column];
+            label.InitializeLabel({ columns[column], row * row_height + text_offset }, text_size);
+            board_->add(label.GetLabel());
+        }
+    }
+
+    scrollbar_->setViewportSize(static_cast<unsigned int>(visible_rows_));
+    scrollbar_->setMaximum(0);
+}
+
+tgui::Group::Ptr FlightBoard::GetBoard() const {
+    return board_;
+}
+
+void FlightBoard::SetTable(std::shared_ptr<const utils::flight_table::FlightTable> table) {
+    table_ = std::move(table);
+
+    // setMaximum сам сдвигает значение, если строк стало меньше, и
+    // тогда FillRows вызывается из onValueChange; здесь - на случай,
+    // если позиция не изменилась
+    const size_t count = table_ ? table_->GetSize() : 0;
+    scrollbar_->setMaximum(static_cast<unsigned int>(count));
+    first_row_ = scrollbar_->getValue();
+    FillRows();
+}
+
+bool FlightBoard::Scroll(float wheel_delta, const sf::Vector2f& window_position) {
+    if (!rows_area_.contains(window_position)) {
+        return false;
+    }
+
+    const long long step = std::lround(wheel_delta * FLIGHT_BOARD_SCROLL_ROWS);
+    const long long last = static_cast<long long>(scrollbar_->getMaximum()) - static_cast<long long>(scrollbar_->getViewportSize());
+    const long long value = std::clamp(static_cast<long long>(first_row_) - step, 0ll, std::max(0ll, last));
+    scrollbar_->setValue(static_cast<unsigned int>(value));
+    return true;
+}
+
+size_t FlightBoard::GetVisibleRowCount() const {
+    return visible_rows_;
+}
+
+size_t FlightBoard::GetFirstRow() const {
+    return first_row_;
+}
+
+void FlightBoard::FillRows() {
+    utils::flight_table::FlightTable::Rows order{ nullptr, nullptr };
+    if (table_) {
+        order = table_->GetByDeparture();
+    }
+
+    auto format_time = [this](utils::flight_table::FlightTime time) {
+        return formatter_.Clear().AppendInteger(time / 60, 2).Append(":").AppendInteger(time % 60, 2).GetView();
+    };
+
+    // UpdateLabelText не трогает метку, если текст не изменился
+    for (size_t slot = 0; slot < visible_rows_; ++slot) {
+        TextLabel* row = &labels_[slot * FLIGHT_BOARD_COLUMNS];
+        const size_t index = first_row_ + slot;
+        if (index >= order.size()) {
+            for (size_t column = 0; column < FLIGHT_BOARD_COLUMNS; ++column) {
+                row[column].UpdateLabelText("");
+            }
+            continue;
+        }
+
+        const uint32_t flight = order.begin()[index];
+        row[0].UpdateLabelText(table_->GetFlightNumber(flight));
+        row[1].UpdateLabelText(format_time(table_->GetDepartureTime(flight)));
+        row[2].UpdateLabelText(format_time(table_->GetArrivalTime(flight)));
+        row[3].UpdateLabelText(utils::flight_table::GetStatusName(table_->GetStatus(flight)));
+    }
+}
+
+} // namespace gui_wrapper
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "number_formatter.h"
+#include "text_label.h"
+#include "../../utils/flight_table.h"
+
+#include <array>
+#include <memory>
+#include <vector>
+#include <SFML/Graphics.hpp>
+#include <TGUI/TGUI.hpp>
+#include <TGUI/Backend/SFML-Graphics.hpp>
+
+/*
+   Виртуальное табло рейсов с прокруткой. Метки создаются только для
+   строк, помещающихся в область табло, - по FLIGHT_BOARD_COLUMNS на
+   строку. При прокрутке и новой публикации метки не пересоздаются, а
+   получают текст других рейсов, который берется прямо из FlightTable
+   по индексу вылета. Память и отрисовка - O(видимых строк), а не
+   O(рейсов).
+*/
+
+namespace gui_wrapper {
+
+class FlightBoard {
+public:
+    static constexpr size_t FLIGHT_BOARD_COLUMNS = 4;
+
+    FlightBoard() = default;
+
+    // columns - отступы столбцов от левого края табло
+    void InitializeBoard(const sf::Vector2f& position, const sf::Vector2f& size, float row_height,
+                         const std::array<float, FLIGHT_BOARD_COLUMNS>& columns, int text_size);
+
+    tgui::Group::Ptr GetBoard() const;
+
+    // Табло держит опубликованную таблицу, пока не придет следующая.
+    // Позиция прокрутки сохраняется, насколько позволяет новый размер
+    void SetTable(std::shared_ptr<const utils::flight_table::FlightTable> table);
+
+    // Прокрутка колесом над строками табло (над полосой прокрутки
+    // колесо обрабатывает сама TGUI). false, если точка вне табло
+    bool Scroll(float wheel_delta, const sf::Vector2f& window_position);
+
+    size_t GetVisibleRowCount() const;
+
+    size_t GetFirstRow() const;
+
+private:
+    // Перезаполняет все видимые строки начиная с first_row_
+    void FillRows();
+
+private:
+    tgui::Group::Ptr board_ = tgui::Group::create();
+    tgui::Scrollbar::Ptr scrollbar_ = tgui::Scrollbar::create();
+
+    sf::FloatRect rows_area_;
+    size_t visible_rows_ = 0;
+    size_t first_row_ = 0;
+
+    // Метки видимых строк, по FLIGHT_BOARD_COLUMNS на строку
+    std::vector<TextLabel> labels_;
+
+    std::shared_ptr<const utils::flight_table::FlightTable> table_;
+
+    NumberFormatter formatter_;
+};
+
+} // namespace gui_wrapper
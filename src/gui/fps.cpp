@@ -23,7 +23,8 @@ void FrameRateLabel::CalculateFrameRate() {
     if (frame_clock_.getElapsedTime().asSeconds() >= 1.0f) {
         frame_rate_ = static_cast<float>(frame_count_) / frame_clock_.restart().asSeconds();
         frame_count_ = 0;
-        SetLabelText("FPS " + std::to_string(static_cast<int>(frame_rate_)));
+        NumberFormatter formatter;
+        UpdateLabelText(formatter.Append("FPS ").AppendInteger(static_cast<int>(frame_rate_)).GetView());
     }
     ++frame_count_;
 }
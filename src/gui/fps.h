@@ -2,6 +2,7 @@
 
 #include "../global_parameters.h"
 #include "label_base.h"
+#include "number_formatter.h"
 
 namespace gui_wrapper {
 
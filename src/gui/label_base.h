@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+#include <string_view>
 #include <TGUI/TGUI.hpp>
 #include <TGUI/Backend/SFML-Graphics.hpp>
 
@@ -11,6 +13,23 @@ public:
     virtual tgui::Label::Ptr GetLabel() const = 0;
     virtual void SetLabelText(const tgui::String& text) = 0;
     virtual ~LabelBase() {};
+
+    // Меняет текст, только если он отличается от заданного прошлым
+    // вызовом: setText в TGUI выделяет память и перестраивает метку.
+    // Для меток, обновляемых каждый кадр, вместо SetLabelText
+    bool UpdateLabelText(std::string_view text) {
+        if (text_set_ && text == text_) {
+            return false;
+        }
+        text_.assign(text.data(), text.size());
+        text_set_ = true;
+        SetLabelText(tgui::String(text));
+        return true;
+    }
+
+private:
+    std::string text_;
+    bool text_set_ = false;
 };
 
 } // namespace gui_wrapper
\ No newline at end of file
@@ -0,0 +1,183 @@
+#include "layered_canvas.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace global_parameters;
+
+namespace gui_wrapper {
+
+void LayeredCanvas::InitializeLayers(const sf::Vector2u& size) {
+    size_ = size;
+    view_ = sf::View(sf::FloatRect(0.f, 0.f, static_cast<float>(size.x), static_cast<float>(size.y)));
+    static_texture_.create(size.x, size.y);
+    static_sprite_.setTexture(static_texture_.getTexture(), true);
+    InvalidateStatic();
+}
+
+void LayeredCanvas::AddStaticDrawable(const sf::Drawable* drawable) {
+    static_drawables_.push_back(drawable);
+    InvalidateStatic();
+}
+
+void LayeredCanvas::AddDynamicDrawable(const sf::Drawable* drawable) {
+    dynamic_drawables_.push_back(drawable);
+    InvalidateAll();
+}
+
+void LayeredCanvas::SetView(const sf::View& view) {
+    if (view.getCenter() != view_.getCenter() || view.getSize() != view_.getSize()) {
+        view_ = view;
+        InvalidateStatic();
+    }
+}
+
+void LayeredCanvas::InvalidateStatic() {
+    static_dirty_ = true;
+    InvalidateAll();
+}
+
+void LayeredCanvas::Invalidate(const sf::FloatRect& region) {
+    if (full_redraw_) {
+        return;
+    }
+
+    // Переводим область в пиксели холста и расширяем до целых
+    // пикселей с запасом на сглаживание текстуры
+    const sf::Vector2f top_left = view_.getCenter() - view_.getSize() / 2.f;
+    const float scale_x = size_.x / view_.getSize().x;
+    const float scale_y = size_.y / view_.getSize().y;
+    const float pixel_left = (region.left - top_left.x) * scale_x;
+    const float pixel_top = (region.top - top_left.y) * scale_y;
+
+    const int left = std::max(static_cast<int>(std::floor(pixel_left)) - 1, 0);
+    const int top = std::max(static_cast<int>(std::floor(pixel_top)) - 1, 0);
+    const int right = std::min(static_cast<int>(std::ceil(pixel_left + region.width * scale_x)) + 1, static_cast<int>(size_.x));
+    const int bottom = std::min(static_cast<int>(std::ceil(pixel_top + region.height * scale_y)) + 1, static_cast<int>(size_.y));
+
+    if (left < right && top < bottom) {
+        dirty_regions_.emplace_back(left, top, right - left, bottom - top);
+    }
+
+    // Слияние квадратично по числу областей, поэтому при массовом
+    // движении сразу переходим к полной перерисовке
+    if (dirty_regions_.size() > CANVAS_MAX_DIRTY_REGIONS * 4) {
+        InvalidateAll();
+    }
+}
+
+void LayeredCanvas::InvalidateAll() {
+    full_redraw_ = true;
+    dirty_regions_.clear();
+}
+
+bool LayeredCanvas::Compose(sf::RenderTarget& target) {
+    if (static_dirty_) {
+        RenderStaticLayer();
+    }
+
+    if (!full_redraw_) {
+        MergeDirtyRegions();
+    }
+
+    if (!full_redraw_ && dirty_regions_.empty()) {
+        return false;
+    }
+
+    const sf::View original_view = target.getView();
+
+    if (full_redraw_) {
+        DrawRegion(target, { 0, 0, static_cast<int>(size_.x), static_cast<int>(size_.y) });
+    }
+    else {
+        for (const sf::IntRect& region : dirty_regions_) {
+            DrawRegion(target, region);
+        }
+    }
+
+    target.setView(original_view);
+
+    dirty_regions_.clear();
+    full_redraw_ = false;
+    return true;
+}
+
+void LayeredCanvas::RenderStaticLayer() {
+    static_texture_.clear(sf::Color{ CANVAS_DEFAULT_COLOR.r, CANVAS_DEFAULT_COLOR.g, CANVAS_DEFAULT_COLOR.b });
+    static_texture_.setView(view_);
+    for (const sf::Drawable* drawable : static_drawables_) {
+        static_texture_.draw(*drawable);
+    }
+    static_texture_.setView(static_texture_.getDefaultView());
+    static_texture_.display();
+    static_dirty_ = false;
+}
+
+void LayeredCanvas::MergeDirtyRegions() {
+    // Сливаем пересекающиеся области, чтобы не рисовать одно место дважды
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < dirty_regions_.size() && !merged; ++i) {
+            for (size_t j = i + 1; j < dirty_regions_.size(); ++j) {
+                if (dirty_regions_[i].intersects(dirty_regions_[j])) {
+                    const sf::IntRect& a = dirty_regions_[i];
+                    const sf::IntRect& b = dirty_regions_[j];
+                    const int left = std::min(a.left, b.left);
+                    const int top = std::min(a.top, b.top);
+                    const int right = std::max(a.left + a.width, b.left + b.width);
+                    const int bottom = std::max(a.top + a.height, b.top + b.height);
+                    dirty_regions_[i] = { left, top, right - left, bottom - top };
+                    dirty_regions_.erase(dirty_regions_.begin() + j);
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Каждая область - отдельный проход по всему динамическому слою,
+    // поэтому при большом числе или площади областей дешевле
+    // перерисовать холст целиком
+    size_t area = 0;
+    for (const sf::IntRect& region : dirty_regions_) {
+        area += static_cast<size_t>(region.width) * region.height;
+    }
+
+    if (dirty_regions_.size() > CANVAS_MAX_DIRTY_REGIONS || area * 2 > static_cast<size_t>(size_.x) * size_.y) {
+        InvalidateAll();
+    }
+}
+
+void LayeredCanvas::DrawRegion(sf::RenderTarget& target, const sf::IntRect& region) {
+    // Viewport совпадает с областью, поэтому все, что рисуется
+    // дальше, обрезается по ее границам
+    const sf::Vector2f target_size(target.getSize());
+    const sf::FloatRect viewport(region.left / target_size.x, region.top / target_size.y,
+                                 region.width / target_size.x, region.height / target_size.y);
+
+    // Статический слой уже в пикселях холста и непрозрачен,
+    // поэтому заменяет очистку области
+    sf::View pixel_view{ sf::FloatRect(region) };
+    pixel_view.setViewport(viewport);
+    target.setView(pixel_view);
+
+    static_sprite_.setTextureRect(region);
+    static_sprite_.setPosition(static_cast<float>(region.left), static_cast<float>(region.top));
+    target.draw(static_sprite_, sf::BlendNone);
+
+    // Динамический слой рисуется в координатах мира
+    const sf::Vector2f top_left = view_.getCenter() - view_.getSize() / 2.f;
+    const float scale_x = view_.getSize().x / size_.x;
+    const float scale_y = view_.getSize().y / size_.y;
+    sf::View world_view{ sf::FloatRect(top_left.x + region.left * scale_x, top_left.y + region.top * scale_y,
+                                       region.width * scale_x, region.height * scale_y) };
+    world_view.setViewport(viewport);
+    target.setView(world_view);
+
+    for (const sf::Drawable* drawable : dynamic_drawables_) {
+        target.draw(*drawable);
+    }
+}
+
+} // namespace gui_wrapper
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "../global_parameters.h"
+
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+/*
+   Послойная сборка холста. Статический слой (карта) рисуется в
+   отдельную текстуру один раз на каждый вид и дальше только копируется.
+   Динамический слой (самолеты) перерисовывается лишь в грязных
+   областях: в каждой из них восстанавливается кусок статического
+   слоя, а поверх рисуется динамический, обрезанный по области
+   через viewport. Если грязных областей нет, холст не трогается.
+*/
+
+namespace gui_wrapper {
+
+class LayeredCanvas {
+public:
+    LayeredCanvas() = default;
+
+    void InitializeLayers(const sf::Vector2u& size);
+
+    void AddStaticDrawable(const sf::Drawable* drawable);
+
+    void AddDynamicDrawable(const sf::Drawable* drawable);
+
+    // Вид на мир для обоих слоев. Смена вида перерисовывает статический слой
+    void SetView(const sf::View& view);
+
+    // Статический слой будет перерисован при следующей сборке
+    void InvalidateStatic();
+
+    // Область мира, которую нужно перерисовать в следующей сборке
+    void Invalidate(const sf::FloatRect& region);
+
+    void InvalidateAll();
+
+    // Перерисовывает грязные области. Возвращает false, если холст
+    // не изменился и вызывать display() не нужно
+    bool Compose(sf::RenderTarget& target);
+
+private:
+    void RenderStaticLayer();
+
+    void MergeDirtyRegions();
+
+    void DrawRegion(sf::RenderTarget& target, const sf::IntRect& region);
+
+private:
+    sf::Vector2u size_;
+    sf::View view_;
+    sf::RenderTexture static_texture_;
+    sf::Sprite static_sprite_;
+
+    std::vector<const sf::Drawable*> static_drawables_;
+    std::vector<const sf::Drawable*> dynamic_drawables_;
+
+    std::vector<sf::IntRect> dirty_regions_;
+    bool static_dirty_ = true;
+    bool full_redraw_ = true;
+};
+
+} // namespace gui_wrapper
\ No newline at end of file
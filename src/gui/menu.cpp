@@ -4,7 +4,7 @@ using namespace event_handler;
 
 namespace gui_wrapper {
 
-void UpperMenu::InitializeMenu(tgui::Gui& gui, objects::Plane& plane, FrameRateLabel& fps, CoordsLabel& coords_label) {
+void UpperMenu::InitializeMenu(tgui::Gui& gui, objects::Plane& plane, sim::Simulation& simulation, FrameRateLabel& fps, CoordsLabel& coords_label) {
     upper_menu_->setWidth(global_parameters::MENU_WIDTH);
     upper_menu_->setHeight(global_parameters::MENU_HEIGHT);
     upper_menu_->setAutoLayout(tgui::AutoLayout::Manual);
@@ -16,6 +16,23 @@ void UpperMenu::InitializeMenu(tgui::Gui& gui, objects::Plane& plane, FrameRateL
     upper_menu_->addMenuItem("Finish");
     upper_menu_->onMenuItemClick(&EventHandler::finishProgram, std::ref(plane));
 
+    upper_menu_->addMenu("Simulation");
+    upper_menu_->addMenuItem("20 Hz");
+    upper_menu_->addMenuItem("60 Hz");
+    upper_menu_->addMenuItem("240 Hz");
+    upper_menu_->onMenuItemClick(&EventHandler::changeSimulationRate, std::ref(simulation));
+    upper_menu_->addMenuItem("x1");
+    upper_menu_->addMenuItem("x10");
+    upper_menu_->addMenuItem("x100");
+    upper_menu_->onMenuItemClick(&EventHandler::changeTimeScale, std::ref(simulation));
+
+    upper_menu_->addMenu("Altitude");
+    upper_menu_->addMenuItem("FL100");
+    upper_menu_->addMenuItem("FL200");
+    upper_menu_->addMenuItem("FL300");
+    upper_menu_->addMenuItem("FL400");
+    upper_menu_->onMenuItemClick(&EventHandler::changeFlightLevel, std::ref(plane));
+
     upper_menu_->addMenu("Debug");
     upper_menu_->addMenuItem("Show FPS");
     upper_menu_->onMenuItemClick(&EventHandler::showFPS, std::ref(fps));
@@ -0,0 +1,48 @@
+#include "number_formatter.h"
+
+#include <algorithm>
+#include <charconv>
+
+namespace gui_wrapper {
+
+NumberFormatter& NumberFormatter::Clear() {
+    size_ = 0;
+    return *this;
+}
+
+NumberFormatter& NumberFormatter::AppendFixed(double value, int precision) {
+    char* const begin = buffer_.data() + size_;
+    const std::to_chars_result result = std::to_chars(begin, buffer_.data() + CAPACITY, value, std::chars_format::fixed, precision);
+    if (result.ec == std::errc()) {
+        size_ = result.ptr - buffer_.data();
+    }
+    return *this;
+}
+
+NumberFormatter& NumberFormatter::AppendInteger(long long value, int width) {
+    char digits[24];
+    const unsigned long long magnitude = value < 0 ? 0ull - static_cast<unsigned long long>(value) : value;
+    const std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), magnitude);
+    const size_t length = result.ptr - digits;
+
+    if (value < 0) {
+        Append("-");
+    }
+    for (size_t i = length; i < static_cast<size_t>(std::max(width, 0)); ++i) {
+        Append("0");
+    }
+    return Append(std::string_view(digits, length));
+}
+
+NumberFormatter& NumberFormatter::Append(std::string_view text) {
+    const size_t length = std::min(text.size(), CAPACITY - size_);
+    std::copy(text.begin(), text.begin() + length, buffer_.data() + size_);
+    size_ += length;
+    return *this;
+}
+
+std::string_view NumberFormatter::GetView() const {
+    return { buffer_.data(), size_ };
+}
+
+} // namespace gui_wrapper
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+/*
+   Форматирование чисел в буфер фиксированного размера через
+   std::to_chars, без выделений памяти. Вызовы Append можно
+   сцеплять, а результат брать через GetView до следующего Clear.
+   Если буфер переполнен, лишние символы отбрасываются.
+*/
+
+namespace gui_wrapper {
+
+class NumberFormatter {
+public:
+    static constexpr size_t CAPACITY = 64;
+
+    NumberFormatter() = default;
+
+    NumberFormatter& Clear();
+
+    // Число с фиксированным количеством знаков после точки
+    NumberFormatter& AppendFixed(double value, int precision);
+
+    // Целое, дополненное слева нулями до width цифр
+    NumberFormatter& AppendInteger(long long value, int width = 0);
+
+    NumberFormatter& Append(std::string_view text);
+
+    std::string_view GetView() const;
+
+private:
+    std::array<char, CAPACITY> buffer_;
+    size_t size_ = 0;
+};
+
+} // namespace gui_wrapper
\ No newline at end of file
@@ -1,19 +1,23 @@
 #include "stamp.h"
-#include <iostream>
 
 namespace gui_wrapper {
 
-void DateStamp::SetTimezone(const std::string& timezone) {
-    timezone_ = timezone;
+void ToShiftedTime(time_t now, int utc_offset, tm& result) {
+    const time_t shifted = now + utc_offset;
+    #ifdef _WIN32
+        gmtime_s(&result, &shifted);
+    #else
+        gmtime_r(&shifted, &result);
+    #endif
+}
+
+void DateStamp::SetUtcOffset(int utc_offset) {
+    utc_offset_ = utc_offset;
 }
 
 void DateStamp::InitializeLabel() {
     label_->setPosition({ global_parameters::DATESTAMP_LABEL_X, global_parameters::DATESTAMP_LABEL_Y });
     label_->setTextSize(global_parameters::DATESTAMP_LABEL_FONTSIZE);
-
-    year = std::move(std::to_string(1900 + ltm->tm_year));
-    month = std::move(std::to_string(ltm->tm_mon));
-    day = std::move(std::to_string(ltm->tm_mday));
 }
 
 tgui::Label::Ptr DateStamp::GetLabel() const {
@@ -26,33 +30,20 @@ void DateStamp::SetLabelText(const tgui::String& text) {
 
 void DateStamp::Update() {
     now = time(0);
-    ltm = localtime(&now);
-
-    year = std::move(std::to_string(1900 + ltm->tm_year));
-    month = (1 + ltm->tm_mon < 10) ? month = std::move("0" + std::to_string(1 + ltm->tm_mon)) : std::move(std::to_string(1 + ltm->tm_mon));
-    day = (ltm->tm_mday < 10) ? std::move("0" + std::to_string(ltm->tm_mday)) : std::move(std::to_string(ltm->tm_mday));
+    ToShiftedTime(now, utc_offset_, ltm);
 
-    SetLabelText(day + "." + month + "." + year);
+    // Метка обновляется каждый кадр, а текст меняется раз в сутки
+    formatter_.Clear().AppendInteger(ltm.tm_mday, 2).Append(".").AppendInteger(1 + ltm.tm_mon, 2).Append(".").AppendInteger(1900 + ltm.tm_year);
+    UpdateLabelText(formatter_.GetView());
 }
 
-void TimeStamp::SetTimezone(const std::string& timezone) {
-    timezone_ = timezone;
+void TimeStamp::SetUtcOffset(int utc_offset) {
+    utc_offset_ = utc_offset;
 }
 
 void TimeStamp::InitializeLabel() {
-    #ifdef _WIN32
-        _putenv_s("TZ", "EST5EDT");
-        _tzset();
-    #else
-        setenv("TZ", timezone_.c_str(), 1);
-    #endif
-
     label_->setPosition({ global_parameters::TIMESTAMP_LABEL_X, global_parameters::TIMESTAMP_LABEL_Y });
     label_->setTextSize(global_parameters::TIMESTAMP_LABEL_FONTSIZE);
-
-    hour = std::move(std::to_string(ltm->tm_hour));
-    minute = std::move(std::to_string(ltm->tm_min));
-    second = std::move(std::to_string(ltm->tm_sec));
 }
 
 tgui::Label::Ptr TimeStamp::GetLabel() const {
@@ -65,13 +56,10 @@ void TimeStamp::SetLabelText(const tgui::String& text) {
 
 void TimeStamp::Update() {
     now = time(0);
-    ltm = localtime(&now);
-
-    hour = (ltm->tm_hour < 10) ? std::move("0" + std::to_string(ltm->tm_hour)) : std::move(std::to_string(ltm->tm_hour));
-    minute = (ltm->tm_min < 10) ? std::move("0" + std::to_string(ltm->tm_min)) : std::move(std::to_string(ltm->tm_min));
-    second = (ltm->tm_sec < 10) ? std::move("0" + std::to_string(ltm->tm_sec)) : std::move(std::to_string(ltm->tm_sec));
+    ToShiftedTime(now, utc_offset_, ltm);
 
-    SetLabelText(hour + ":" + minute + ":" + second);
+    formatter_.Clear().AppendInteger(ltm.tm_hour, 2).Append(":").AppendInteger(ltm.tm_min, 2).Append(":").AppendInteger(ltm.tm_sec, 2);
+    UpdateLabelText(formatter_.GetView());
 }
 
 } // namespace gui_wrapper
\ No newline at end of file
@@ -2,16 +2,28 @@
 
 #include "../global_parameters.h"
 #include "label_base.h"
+#include "number_formatter.h"
 
 #include <ctime>
 
+/*
+   Метки даты и времени показывают местное время точки погоды: UTC
+   плюс сдвиг из ответа погоды. Переменная TZ процесса не меняется -
+   setenv при работающих потоках с localtime_r небезопасен, а
+   ротация логов должна жить по местному времени машины.
+*/
+
 namespace gui_wrapper {
 
+// Разбирает момент now, сдвинутый на utc_offset секунд, как UTC
+void ToShiftedTime(time_t now, int utc_offset, tm& result);
+
 class DateStamp : public LabelBase {
 public:
     DateStamp() = default;
 
-    void SetTimezone(const std::string& timezone);
+    // Сдвиг местного времени от UTC, секунды
+    void SetUtcOffset(int utc_offset);
 
     void InitializeLabel() override;
 
@@ -22,22 +34,20 @@ public:
     void Update();
 
 private:
-    std::string timezone_;
+    int utc_offset_ = 0;
 
     tgui::Label::Ptr label_ = tgui::Label::create();
     time_t now = time(0);
-    tm* ltm = localtime(&now);
-
-    tgui::String year = std::move(std::to_string(1900 + ltm->tm_year));
-    tgui::String month = std::move(std::to_string(1 + ltm->tm_mon));
-    tgui::String day = std::move(std::to_string(ltm->tm_mday));
+    tm ltm = {};
+    NumberFormatter formatter_;
 };
 
 class TimeStamp : public LabelBase {
 public:
     TimeStamp() = default;
 
-    void SetTimezone(const std::string& timezone);
+    // Сдвиг местного времени от UTC, секунды
+    void SetUtcOffset(int utc_offset);
 
     void InitializeLabel() override;
 
@@ -48,15 +58,12 @@ public:
     void Update();
 
 private:
-    std::string timezone_;
+    int utc_offset_ = 0;
 
     tgui::Label::Ptr label_ = tgui::Label::create();
     time_t now = time(0);
-    tm* ltm = localtime(&now);
-
-    tgui::String hour = std::move(std::to_string(ltm->tm_hour));
-    tgui::String minute = std::move(std::to_string(ltm->tm_min));
-    tgui::String second = std::move(std::to_string(ltm->tm_sec));
+    tm ltm = {};
+    NumberFormatter formatter_;
 };
 
 } // namespace gui_wrapper
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "tile_loader.h"
+
+#include <algorithm>
+#include <fstream>
+
+namespace gui_wrapper {
+
+TileLoader::TileLoader(const std::string& root, size_t thread_count)
+    : root_(root) {
+    for (size_t i = 0; i < thread_count; ++i) {
+        threads_.push_back(std::make_unique<sf::Thread>(&TileLoader::WorkerLoop, this));
+        threads_.back()->launch();
+    }
+}
+
+TileLoader::~TileLoader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+
+    for (auto& thread : threads_) {
+        thread->wait();
+    }
+}
+
+void TileLoader::Request(const std::vector<TileKey>& keys) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.clear();
+        for (const TileKey& key : keys) {
+            if (in_flight_.count(key) == 0) {
+                queue_.push_back(key);
+            }
+        }
+    }
+    wake_.notify_all();
+}
+
+void TileLoader::Collect(std::vector<LoadedTile>& loaded, size_t max_count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t count = std::min(max_count, loaded_.size());
+    for (size_t i = 0; i < count; ++i) {
+        in_flight_.erase(loaded_[i].key);
+        loaded.push_back(std::move(loaded_[i]));
+    }
+    loaded_.erase(loaded_.begin(), loaded_.begin() + count);
+}
+
+std::string TileLoader::GetTilePath(const TileKey& key) const {
+    return root_ + std::to_string(key.z) + "/" + std::to_string(key.x) + "/" + std::to_string(key.y) + ".png";
+}
+
+void TileLoader::WorkerLoop() {
+    while (true) {
+        TileKey key;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            key = queue_.front();
+            queue_.pop_front();
+            in_flight_.insert(key);
+        }
+
+        // Отсутствие плитки - обычное дело на краях пирамиды, поэтому
+        // проверяем файл заранее, чтобы SFML не писал ошибку в консоль
+        LoadedTile tile{ key, false, {} };
+        const std::string path = GetTilePath(key);
+        if (std::ifstream(path).good()) {
+            tile.found = tile.image.loadFromFile(path);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        loaded_.push_back(std::move(tile));
+    }
+}
+
+} // namespace gui_wrapper
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/System/Thread.hpp>
+
+/*
+   Фоновая загрузка плиток карты. Рабочие потоки читают и
+   декодируют PNG в sf::Image, а в текстуры их переводит поток
+   интерфейса (только у него есть контекст OpenGL). Очередь
+   заменяется целиком при каждом запросе, поэтому плитки, которые
+   успели уйти из вида, не загружаются зря.
+*/
+
+namespace gui_wrapper {
+
+struct TileKey {
+    uint32_t z;
+    uint32_t x;
+    uint32_t y;
+
+    bool operator==(const TileKey& other) const {
+        return z == other.z && x == other.x && y == other.y;
+    }
+};
+
+struct TileKeyHash {
+    size_t operator()(const TileKey& key) const {
+        return (static_cast<size_t>(key.z) << 58) ^ (static_cast<size_t>(key.x) << 29) ^ key.y;
+    }
+};
+
+struct LoadedTile {
+    TileKey key;
+    bool found;
+    sf::Image image;
+};
+
+class TileLoader {
+public:
+    TileLoader(const std::string& root, size_t thread_count);
+
+    ~TileLoader();
+
+    TileLoader(const TileLoader&) = delete;
+    TileLoader& operator=(const TileLoader&) = delete;
+
+    // Заменяет очередь на keys (первые важнее). Плитки, которые уже
+    // декодируются, повторно не ставятся
+    void Request(const std::vector<TileKey>& keys);
+
+    // Забирает не больше max_count готовых плиток
+    void Collect(std::vector<LoadedTile>& loaded, size_t max_count);
+
+    std::string GetTilePath(const TileKey& key) const;
+
+private:
+    void WorkerLoop();
+
+private:
+    std::string root_;
+    std::vector<std::unique_ptr<sf::Thread>> threads_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<TileKey> queue_;
+    std::unordered_set<TileKey, TileKeyHash> in_flight_;
+    std::vector<LoadedTile> loaded_;
+    bool stopping_ = false;
+};
+
+} // namespace gui_wrapper
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include "tile_map.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace global_parameters;
+
+namespace gui_wrapper {
+
+void TileMap::InitializeTileMap(const std::string& root) {
+    loader_ = std::make_unique<TileLoader>(root, MAP_TILE_DECODE_THREADS);
+}
+
+bool TileMap::Update(const sf::View& view, const sf::Vector2u& target_size) {
+    if (!loader_) {
+        return false;
+    }
+
+    zoom_ = SelectZoomLevel(view, target_size);
+
+    const float tile_world_size = MAP_TILE_WORLD_SIZE / static_cast<float>(1u << zoom_);
+    const float tiles_per_side = static_cast<float>(1u << zoom_);
+    const sf::Vector2f top_left = view.getCenter() - view.getSize() / 2.f;
+    const sf::Vector2f bottom_right = view.getCenter() + view.getSize() / 2.f;
+
+    // За пределами пирамиды плиток нет
+    const float first_x = std::max(std::floor(top_left.x / tile_world_size), 0.f);
+    const float first_y = std::max(std::floor(top_left.y / tile_world_size), 0.f);
+    const float last_x = std::min(std::ceil(bottom_right.x / tile_world_size), tiles_per_side);
+    const float last_y = std::min(std::ceil(bottom_right.y / tile_world_size), tiles_per_side);
+
+    std::vector<TileKey> visible;
+    for (uint32_t y = static_cast<uint32_t>(first_y); y < static_cast<uint32_t>(std::max(last_y, first_y)); ++y) {
+        for (uint32_t x = static_cast<uint32_t>(first_x); x < static_cast<uint32_t>(std::max(last_x, first_x)); ++x) {
+            visible.push_back({ zoom_, x, y });
+        }
+    }
+
+    bool changed = visible != visible_;
+    visible_ = std::move(visible);
+
+    // Для каждой видимой плитки запрашиваем ее саму, а если ее нет
+    // на диске - ближайшего предка, которого еще не пробовали
+    requests_.clear();
+    for (const TileKey& key : visible_) {
+        TileKey wanted = key;
+        while (missing_.count(wanted) != 0 && wanted.z > 0) {
+            wanted = { wanted.z - 1, wanted.x / 2, wanted.y / 2 };
+        }
+
+        auto it = cache_.find(wanted);
+        if (it != cache_.end()) {
+            Touch(it->second, wanted);
+        }
+        else if (missing_.count(wanted) == 0 && std::find(requests_.begin(), requests_.end(), wanted) == requests_.end()) {
+            requests_.push_back(wanted);
+        }
+    }
+    loader_->Request(requests_);
+
+    changed |= IntegrateLoaded();
+    return changed;
+}
+
+uint32_t TileMap::GetZoomLevel() const {
+    return zoom_;
+}
+
+uint32_t TileMap::SelectZoomLevel(const sf::View& view, const sf::Vector2u& target_size) {
+    // На уровне z на единицу мира приходится MAP_TILE_SIZE * 2^z / MAP_TILE_WORLD_SIZE
+    // пикселей плитки, берем наименьший уровень, где их не меньше, чем пикселей экрана
+    const float screen_per_world = target_size.x / view.getSize().x;
+    const float level = std::ceil(std::log2(screen_per_world * MAP_TILE_WORLD_SIZE / MAP_TILE_SIZE));
+    return static_cast<uint32_t>(std::clamp(level, 0.f, static_cast<float>(MAP_TILE_MAX_ZOOM)));
+}
+
+sf::FloatRect TileMap::GetTileBounds(const TileKey& key) {
+    const float size = MAP_TILE_WORLD_SIZE / static_cast<float>(1u << key.z);
+    return { key.x * size, key.y * size, size, size };
+}
+
+void TileMap::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    for (const TileKey& key : visible_) {
+        TileKey source_key;
+        const CachedTile* source = FindSource(key, source_key);
+        if (source == nullptr) {
+            continue;
+        }
+
+        // Если рисуем предка, берем из него кусок, соответствующий плитке
+        const uint32_t levels_up = key.z - source_key.z;
+        const float part = static_cast<float>(MAP_TILE_SIZE) / static_cast<float>(1u << levels_up);
+        const float u = (key.x - (source_key.x << levels_up)) * part;
+        const float v = (key.y - (source_key.y << levels_up)) * part;
+
+        const sf::FloatRect bounds = GetTileBounds(key);
+        const sf::Vertex quad[4] = {
+            sf::Vertex({ bounds.left, bounds.top }, { u, v }),
+            sf::Vertex({ bounds.left + bounds.width, bounds.top }, { u + part, v }),
+            sf::Vertex({ bounds.left + bounds.width, bounds.top + bounds.height }, { u + part, v + part }),
+            sf::Vertex({ bounds.left, bounds.top + bounds.height }, { u, v + part })
+        };
+
+        states.texture = &source->texture;
+        target.draw(quad, 4, sf::Quads, states);
+    }
+}
+
+bool TileMap::IntegrateLoaded() {
+    // Загрузка текстуры в видеопамять не бесплатна, поэтому за кадр
+    // переносим не больше MAP_TILE_UPLOADS_PER_FRAME плиток
+    loaded_.clear();
+    loader_->Collect(loaded_, MAP_TILE_UPLOADS_PER_FRAME);
+
+    for (LoadedTile& tile : loaded_) {
+        if (!tile.found) {
+            missing_.insert(tile.key);
+            continue;
+        }
+
+        if (cache_.count(tile.key) != 0) {
+            continue;
+        }
+
+        // Вытесняем давно не использованные плитки
+        while (cache_.size() >= MAP_TILE_CACHE_SIZE && !lru_.empty()) {
+            cache_.erase(lru_.back());
+            lru_.pop_back();
+        }
+
+        lru_.push_front(tile.key);
+        CachedTile& cached = cache_[tile.key];
+        cached.texture.loadFromImage(tile.image);
+        cached.texture.setSmooth(true);
+        cached.lru_position = lru_.begin();
+    }
+
+    return !loaded_.empty();
+}
+
+void TileMap::Touch(CachedTile& tile, const TileKey& key) {
+    lru_.erase(tile.lru_position);
+    lru_.push_front(key);
+    tile.lru_position = lru_.begin();
+}
+
+const TileMap::CachedTile* TileMap::FindSource(TileKey key, TileKey& source_key) const {
+    while (true) {
+        auto it = cache_.find(key);
+        if (it != cache_.end()) {
+            source_key = key;
+            return &it->second;
+        }
+        if (key.z == 0) {
+            return nullptr;
+        }
+        key = { key.z - 1, key.x / 2, key.y / 2 };
+    }
+}
+
+} // namespace gui_wrapper
\ No newline at end of file
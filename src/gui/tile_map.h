@@ -0,0 +1,71 @@
+#pragma once
+
+#include "../global_parameters.h"
+#include "tile_loader.h"
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+/*
+   Многоуровневая карта из плиток root/z/x/y.png. Плитка уровня z
+   покрывает MAP_TILE_WORLD_SIZE / 2^z единиц мира, начало мира -
+   левый верхний угол map.png, мир - в проекции Web Mercator. Для текущего вида выбирается уровень,
+   при котором на пиксель экрана приходится не меньше пикселя
+   плитки, и загружаются только видимые плитки этого уровня. Пока
+   плитки нет, вместо нее рисуется кусок ближайшего загруженного
+   предка. Текстуры хранятся в LRU-кэше на MAP_TILE_CACHE_SIZE плиток.
+*/
+
+namespace gui_wrapper {
+
+class TileMap : public sf::Drawable {
+public:
+    TileMap() = default;
+
+    void InitializeTileMap(const std::string& root);
+
+    // Выбирает уровень и видимые плитки для вида, ставит недостающие
+    // в очередь загрузки и забирает готовые. Возвращает true, если
+    // картинка карты изменилась
+    bool Update(const sf::View& view, const sf::Vector2u& target_size);
+
+    uint32_t GetZoomLevel() const;
+
+    static uint32_t SelectZoomLevel(const sf::View& view, const sf::Vector2u& target_size);
+
+    static sf::FloatRect GetTileBounds(const TileKey& key);
+
+private:
+    struct CachedTile {
+        sf::Texture texture;
+        std::list<TileKey>::iterator lru_position;
+    };
+
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    bool IntegrateLoaded();
+
+    void Touch(CachedTile& tile, const TileKey& key);
+
+    // Ближайшая к плитке загруженная плитка (она сама или предок)
+    const CachedTile* FindSource(TileKey key, TileKey& source_key) const;
+
+private:
+    std::unique_ptr<TileLoader> loader_;
+    uint32_t zoom_ = 0;
+
+    std::unordered_map<TileKey, CachedTile, TileKeyHash> cache_;
+    std::list<TileKey> lru_;
+    std::unordered_set<TileKey, TileKeyHash> missing_;
+
+    std::vector<TileKey> visible_;
+    std::vector<TileKey> requests_;
+    std::vector<LoadedTile> loaded_;
+};
+
+} // namespace gui_wrapper
\ No newline at end of file
@@ -6,11 +6,13 @@ namespace gui_wrapper {
 
 InterfaceBuilder::InterfaceBuilder(sf::RenderWindow* window, 
                                    tgui::Gui* gui, objects::Plane* plane, 
+                                   sim::Simulation* simulation,
                                    utils::weather_handler::WeatherHandler* weather_handler,
                                    utils::aviation_handler::AviationHandler* aviation_handler) 
     : window_(window)
     , gui_(gui)
     , plane_(plane)
+    , simulation_(simulation)
     , weather_handler_(weather_handler)
     , aviation_handler_(aviation_handler) {
 }
@@ -21,6 +23,9 @@ void InterfaceBuilder::CreateAsyncComponents() {
     CreateFlightsTableLines();
     CreateCanvas();
     CreateMapSprite();
+    CreateTileMap();
+    CreateFleetRenderer();
+    CreateCanvasLayers();
     CreateFrameRateLabel();
     CreateCoordinateLabel();
     CreateUpperMenu();
@@ -36,6 +41,29 @@ void InterfaceBuilder::CreateAwaitComponents() {
     CreateStampLabels();
 }
 
+void InterfaceBuilder::UpdateAwaitComponents() {
+    // Обработчики публикуют данные целиком, здесь достаточно сравнить
+    // номер публикации с уже показанным
+    const uint64_t weather_version = weather_handler_->GetVersion();
+    if (weather_version != weather_version_) {
+        weather_version_ = weather_version;
+        FillWeatherLabels(*weather_handler_->GetData());
+    }
+    else if (weather_version_ == 0 && weather_handler_->GetFailureCount() > 0) {
+        temperature_label_.UpdateLabelText("нет данных");
+    }
+
+    const uint64_t flights_version = aviation_handler_->GetVersion();
+    if (flights_version != flights_version_) {
+        flights_version_ = flights_version;
+        flights_status_label_.UpdateLabelText("");
+        flight_board_.SetTable(aviation_handler_->GetData());
+    }
+    else if (flights_version_ == 0 && aviation_handler_->GetFailureCount() > 0) {
+        flights_status_label_.UpdateLabelText("Нет данных о рейсах");
+    }
+}
+
 void InterfaceBuilder::CreateMainLines() {
     HorizontalLine main_hline;
     main_hline.InitializeLine(0, MAIN_HLINE_Y, MAIN_HLINE_LENGTH, LINE_WIDTH);
@@ -54,8 +82,9 @@ void InterfaceBuilder::CreateTimeWeatherHline() {
 
 void InterfaceBuilder::CreateFlightsTableLines() {
     // Horizontal lines
-    std::array<HorizontalLine, 4> aviation_table_hlines;
-    for (int i = 0; i < 4; ++i) {
+    // Шапка таблицы; строки рисует табло рейсов
+    std::array<HorizontalLine, 2> aviation_table_hlines;
+    for (int i = 0; i < 2; ++i) {
         aviation_table_hlines[i].InitializeLine(AT_HLINE_X, AT_HLINE_Y - i * AT_HLINE_OFFSET, AT_HLINE_LENGTH, LINE_WIDTH);
         gui_->add(aviation_table_hlines[i].GetLine());
     }
@@ -69,13 +98,37 @@ void InterfaceBuilder::CreateFlightsTableLines() {
 }
 
 void InterfaceBuilder::CreateCanvas() {
-    canvas_.InitializeCanvas(*plane_);
+    canvas_.InitializeCanvas(*plane_, &projection_);
     gui_->add(canvas_.GetCanvas());
 }
 
 void InterfaceBuilder::CreateMapSprite() {
     map_texture_.loadFromFile("../meta/map.png");
     map_sprite_.setTexture(map_texture_);
+
+    // map.png линейна по широте, а мир на экране - в Меркаторе,
+    // поэтому по вертикали картинку нужно растянуть
+    const sf::Vector2f texture_size(map_texture_.getSize());
+    const sf::Vector2f bottom_right = projection_.GeoToScreen({ MAP_TOP_COORDINATES + MAP_HEIGHT, MAP_LEFT_COORDINATES + MAP_WIDTH });
+    if (texture_size.x > 0.f && texture_size.y > 0.f) {
+        map_sprite_.setScale(bottom_right.x / texture_size.x, bottom_right.y / texture_size.y);
+    }
+}
+
+void InterfaceBuilder::CreateTileMap() {
+    tile_map_.InitializeTileMap(MAP_TILES_PATH);
+}
+
+void InterfaceBuilder::CreateFleetRenderer() {
+    fleet_renderer_.InitializeRenderer("../meta/plane.png", objects::PLANE_SIZE, &projection_);
+}
+
+void InterfaceBuilder::CreateCanvasLayers() {
+    canvas_layers_.InitializeLayers({ CANVAS_WIDTH, CANVAS_HEIGHT });
+    // map.png остается подложкой там, где плиток нет
+    canvas_layers_.AddStaticDrawable(&map_sprite_);
+    canvas_layers_.AddStaticDrawable(&tile_map_);
+    canvas_layers_.AddDynamicDrawable(&fleet_renderer_);
 }
 
 void InterfaceBuilder::CreateFrameRateLabel() {
@@ -90,16 +143,15 @@ void InterfaceBuilder::CreateCoordinateLabel() {
 
 void InterfaceBuilder::CreateUpperMenu() {
     UpperMenu menu;
-    menu.InitializeMenu(*gui_, *plane_, frame_rate_label_, coords_label_);
+    menu.InitializeMenu(*gui_, *plane_, *simulation_, frame_rate_label_, coords_label_);
     gui_->add(menu.GetMenu());
 }
 
 void InterfaceBuilder::CreateStampLabels() {
-    time_label_.SetTimezone(weather_handler_->timezone);
+    // Часовой пояс придет вместе с погодой, до этого время в UTC
     time_label_.InitializeLabel();
     gui_->add(time_label_.GetLabel());
 
-    date_label_.SetTimezone(weather_handler_->timezone);
     date_label_.InitializeLabel();
     gui_->add(date_label_.GetLabel());
 }
@@ -187,69 +239,72 @@ void InterfaceBuilder::CreateTextLabels() {
 }
 
 void InterfaceBuilder::CreateWeatherLabels() {
-    TextLabel temperature_label;
-    temperature_label.SetLabelText(weather_handler_->temperature + " °C");
-    temperature_label.InitializeLabel({ TEMP_LABEL_X, TEMP_LABEL_Y }, SUBTEXT_LABELS_FONTSIZE);
-    gui_->add(temperature_label.GetLabel());
+    temperature_label_.SetLabelText("...");
+    temperature_label_.InitializeLabel({ TEMP_LABEL_X, TEMP_LABEL_Y }, SUBTEXT_LABELS_FONTSIZE);
+    gui_->add(temperature_label_.GetLabel());
 
-    TextLabel pressure_label;
-    pressure_label.SetLabelText(weather_handler_->pressure + "  мбар");
-    pressure_label.InitializeLabel({ PRESSURE_LABEL_X, PRESSURE_LABEL_Y }, SUBTEXT_LABELS_FONTSIZE);
-    gui_->add(pressure_label.GetLabel());
+    pressure_label_.InitializeLabel({ PRESSURE_LABEL_X, PRESSURE_LABEL_Y }, SUBTEXT_LABELS_FONTSIZE);
+    gui_->add(pressure_label_.GetLabel());
 
-    TextLabel humidity_label;
-    humidity_label.SetLabelText(weather_handler_->humidity + " %");
-    humidity_label.InitializeLabel({ HUMIDITY_LABEL_X, HUMIDITY_LABEL_Y }, SUBTEXT_LABELS_FONTSIZE);
-    gui_->add(humidity_label.GetLabel());
+    humidity_label_.InitializeLabel({ HUMIDITY_LABEL_X, HUMIDITY_LABEL_Y }, SUBTEXT_LABELS_FONTSIZE);
+    gui_->add(humidity_label_.GetLabel());
 
-    TextLabel wind_speed_label;
-    wind_speed_label.SetLabelText(weather_handler_->wind_speed + " км/ч");
-    wind_speed_label.InitializeLabel({ WIND_SPEED_LABEL_X, WIND_SPEED_LABEL_Y }, SUBTEXT_LABELS_FONTSIZE);
-    gui_->add(wind_speed_label.GetLabel());
+    wind_speed_label_.InitializeLabel({ WIND_SPEED_LABEL_X, WIND_SPEED_LABEL_Y }, SUBTEXT_LABELS_FONTSIZE);
+    gui_->add(wind_speed_label_.GetLabel());
 
-    TextLabel wind_dir_label;
-    wind_dir_label.SetLabelText(weather_handler_->wind_dir);
-    wind_dir_label.InitializeLabel({ WIND_DIR_LABEL_X, WIND_DIR_LABEL_Y }, SUBTEXT_LABELS_FONTSIZE);
-    gui_->add(wind_dir_label.GetLabel());
+    wind_dir_label_.InitializeLabel({ WIND_DIR_LABEL_X, WIND_DIR_LABEL_Y }, SUBTEXT_LABELS_FONTSIZE);
+    gui_->add(wind_dir_label_.GetLabel());
 
-    TextLabel times_of_day_label;
-    times_of_day_label.SetLabelText(weather_handler_->times_of_day);
-    times_of_day_label.InitializeLabel({ TIMES_OF_DAY_LABEL_X, TIMES_OF_DAY_LABEL_Y }, SUBTEXT_LABELS_FONTSIZE);
-    gui_->add(times_of_day_label.GetLabel());
+    times_of_day_label_.InitializeLabel({ TIMES_OF_DAY_LABEL_X, TIMES_OF_DAY_LABEL_Y }, SUBTEXT_LABELS_FONTSIZE);
+    gui_->add(times_of_day_label_.GetLabel());
+}
+
+void InterfaceBuilder::FillWeatherLabels(const utils::weather_handler::WeatherData& weather) {
+    temperature_label_.UpdateLabelText(label_formatter_.Clear().AppendFixed(weather.temperature, 1).Append(" °C").GetView());
+    pressure_label_.UpdateLabelText(label_formatter_.Clear().AppendFixed(weather.pressure, 1).Append("  мбар").GetView());
+    humidity_label_.UpdateLabelText(label_formatter_.Clear().AppendInteger(weather.humidity).Append(" %").GetView());
+    wind_speed_label_.UpdateLabelText(label_formatter_.Clear().AppendFixed(weather.wind_kph, 1).Append(" км/ч").GetView());
+    wind_dir_label_.UpdateLabelText(weather.GetWindDirection());
+    times_of_day_label_.UpdateLabelText(weather.GetTimesOfDay());
+
+    time_label_.SetUtcOffset(weather.utc_offset);
+    date_label_.SetUtcOffset(weather.utc_offset);
+
+    // Приземный ветер из погоды сносит самолеты
+    const sf::Vector2f wind = weather.GetWindVector();
+    simulation_->Post({ sim::CommandType::SET_WIND, 0, wind.x, wind.y, 0.f });
 }
 
 void InterfaceBuilder::CreatePlaneCoordsLabel() {
-    longtitude_label_.SetLabelText(plane_->longtitude);
     longtitude_label_.InitializeLabel({ LONGTITUDE_LABEL_X, LONGTITUDE_LABEL_Y }, SUBTEXT_LABELS_FONTSIZE);
     gui_->add(longtitude_label_.GetLabel());
 
-    latitude_label_.SetLabelText(plane_->latitude);
     latitude_label_.InitializeLabel({ LATITUDE_LABEL_X, LATITUDE_LABEL_Y }, SUBTEXT_LABELS_FONTSIZE);
     gui_->add(latitude_label_.GetLabel());
+
+    altitude_label_.InitializeLabel({ ALTITUDE_LABEL_X, ALTITUDE_LABEL_Y }, SUBTEXT_LABELS_FONTSIZE);
+    gui_->add(altitude_label_.GetLabel());
+
+    vertical_rate_label_.InitializeLabel({ VERTICAL_RATE_LABEL_X, VERTICAL_RATE_LABEL_Y }, SUBTEXT_LABELS_FONTSIZE);
+    gui_->add(vertical_rate_label_.GetLabel());
+
+    UpdatePlaneCoordsLabel();
 }
 
 void InterfaceBuilder::CreateFlightsTableLabels() {
-    for (int i = 0; i < aviation_handler_->fcount; ++i) {
-        TextLabel flight_number_label;
-        flight_number_label.SetLabelText(aviation_handler_->flight_numbers[i]);
-        flight_number_label.InitializeLabel({ FLIGHT_NUMBER_LABEL_X, AVIATION_PARAMETERS_START_Y + AVIATION_PARAMETERS_OFFSET * i }, SUBTEXT_LABELS_FONTSIZE);
-        gui_->add(flight_number_label.GetLabel());
-
-        TextLabel departure_time_label;
-        departure_time_label.SetLabelText(aviation_handler_->departure_times[i]);
-        departure_time_label.InitializeLabel({ DEPARTURE_TIME_LABEL_X, AVIATION_PARAMETERS_START_Y + AVIATION_PARAMETERS_OFFSET * i }, SUBTEXT_LABELS_FONTSIZE);
-        gui_->add(departure_time_label.GetLabel());
-
-        TextLabel arrival_time_label;
-        arrival_time_label.SetLabelText(aviation_handler_->arrival_times[i]);
-        arrival_time_label.InitializeLabel({ ARRIVAL_TIME_LABEL_X, AVIATION_PARAMETERS_START_Y + AVIATION_PARAMETERS_OFFSET * i }, SUBTEXT_LABELS_FONTSIZE);
-        gui_->add(arrival_time_label.GetLabel());
-
-        TextLabel flight_status_label;
-        flight_status_label.SetLabelText(aviation_handler_->flight_statuses[i]);
-        flight_status_label.InitializeLabel({ FLIGHT_STATUS_LABEL_X, AVIATION_PARAMETERS_START_Y + AVIATION_PARAMETERS_OFFSET * i }, SUBTEXT_LABELS_FONTSIZE);
-        gui_->add(flight_status_label.GetLabel());
-    }
+    const std::array<float, FlightBoard::FLIGHT_BOARD_COLUMNS> columns = {
+        static_cast<float>(FLIGHT_NUMBER_LABEL_X - FLIGHT_BOARD_X),
+        static_cast<float>(DEPARTURE_TIME_LABEL_X - FLIGHT_BOARD_X),
+        static_cast<float>(ARRIVAL_TIME_LABEL_X - FLIGHT_BOARD_X),
+        static_cast<float>(FLIGHT_STATUS_LABEL_X - FLIGHT_BOARD_X),
+    };
+    flight_board_.InitializeBoard({ FLIGHT_BOARD_X, FLIGHT_BOARD_Y }, { FLIGHT_BOARD_WIDTH, FLIGHT_BOARD_HEIGHT }, FLIGHT_BOARD_ROW_HEIGHT, columns, SUBTEXT_LABELS_FONTSIZE);
+    gui_->add(flight_board_.GetBoard());
+
+    // Заглушка поверх пустого табло до первой публикации
+    flights_status_label_.SetLabelText("Загрузка рейсов...");
+    flights_status_label_.InitializeLabel({ FLIGHT_NUMBER_LABEL_X, FLIGHT_BOARD_Y }, SUBTEXT_LABELS_FONTSIZE);
+    gui_->add(flights_status_label_.GetLabel());
 }
 
 void InterfaceBuilder::CreateSlider() {
@@ -261,11 +316,11 @@ void InterfaceBuilder::CreateSlider() {
 }
 
 void InterfaceBuilder::CreateSliderValueLabel() {
-    linear_speed_slider_value_label_.SetLabelText(objects::Plane::FloatToStringWithPrecision(LINEAR_SPEED_SLIDER_MINIMUM));
+    linear_speed_slider_value_label_.UpdateLabelText(label_formatter_.Clear().AppendFixed(LINEAR_SPEED_SLIDER_MINIMUM, 2).GetView());
     linear_speed_slider_value_label_.InitializeLabel({ LINEAR_SPEED_SLIDER_VALUE_LABEL_X, LINEAR_SPEED_SLIDER_VALUE_LABEL_Y }, SUBTEXT_LABELS_FONTSIZE);
     gui_->add(linear_speed_slider_value_label_.GetLabel());
 
-    angle_speed_slider_value_label_.SetLabelText(objects::Plane::FloatToStringWithPrecision(ANGLE_SPEED_SLIDER_MINIMUM));
+    angle_speed_slider_value_label_.UpdateLabelText(label_formatter_.Clear().AppendFixed(ANGLE_SPEED_SLIDER_MINIMUM, 2).GetView());
     angle_speed_slider_value_label_.InitializeLabel({ ANGLE_SPEED_SLIDER_VALUE_LABEL_X, ANGLE_SPEED_SLIDER_VALUE_LABEL_Y }, SUBTEXT_LABELS_FONTSIZE);
     gui_->add(angle_speed_slider_value_label_.GetLabel());
 }
@@ -274,8 +329,8 @@ void InterfaceBuilder::UpdateFrameRateLabel() {
     frame_rate_label_.CalculateFrameRate();
 }
 
-void InterfaceBuilder::UpdateCoordsLabel(const tgui::String& text) {
-    coords_label_.SetLabelText(text);
+void InterfaceBuilder::UpdateCoordsLabel(int x, int y) {
+    coords_label_.UpdateLabelText(label_formatter_.Clear().AppendInteger(x).Append(" ").AppendInteger(y).GetView());
 }
 
 void InterfaceBuilder::UpdateStampLabels() {
@@ -284,17 +339,62 @@ void InterfaceBuilder::UpdateStampLabels() {
 }
 
 void InterfaceBuilder::UpdatePlaneCoordsLabel() {
-    longtitude_label_.SetLabelText(plane_->longtitude);
-    latitude_label_.SetLabelText(plane_->latitude);
+    // Метки меняются только при сдвиге самолета больше чем на 1e-6 градуса
+    const sim::GeoPoint position = plane_->GetGeoPosition();
+    longtitude_label_.UpdateLabelText(label_formatter_.Clear().AppendFixed(position.longitude, 6).Append("°").GetView());
+    latitude_label_.UpdateLabelText(label_formatter_.Clear().AppendFixed(position.latitude, 6).Append("°").GetView());
+    altitude_label_.UpdateLabelText(label_formatter_.Clear().AppendInteger(std::lround(plane_->GetAltitude())).Append(" м").GetView());
+    vertical_rate_label_.UpdateLabelText(label_formatter_.Clear().AppendFixed(plane_->GetVerticalRate(), 1).Append(" м/с").GetView());
 }
 
-void InterfaceBuilder::UpdateCanvas() {
-    canvas_.GetCanvas()->clear(sf::Color{ CANVAS_DEFAULT_COLOR.r, CANVAS_DEFAULT_COLOR.g, CANVAS_DEFAULT_COLOR.b });
-    canvas_.GetCanvas()->draw(map_sprite_);
-    if (plane_->GetToDraw()) {
-        canvas_.GetCanvas()->draw(plane_->GetPrimitive()); 
+void InterfaceBuilder::UpdateCanvas(const sim::FleetSnapshot& snapshot) {
+    canvas_layers_.SetView(canvas_.GetView());
+    if (tile_map_.Update(canvas_.GetView(), { CANVAS_WIDTH, CANVAS_HEIGHT })) {
+        canvas_layers_.InvalidateStatic();
+    }
+
+    // Все самолеты рисуются одним вызовом draw
+    fleet_renderer_.Update(snapshot);
+
+    // Карта лежит в статическом слое, перерисовываются только
+    // области, где самолеты сдвинулись
+    for (const sf::FloatRect& region : fleet_renderer_.GetDirtyRegions()) {
+        canvas_layers_.Invalidate(region);
     }
-    canvas_.GetCanvas()->display();
+
+    if (canvas_layers_.Compose(canvas_.GetCanvas()->getRenderTexture())) {
+        canvas_.GetCanvas()->display();
+    }
+}
+
+void InterfaceBuilder::ScrollFlightBoard(float wheel_delta, const sf::Vector2f& window_position) {
+    flight_board_.Scroll(wheel_delta, window_position);
+}
+
+void InterfaceBuilder::ZoomCanvas(float wheel_delta, const sf::Vector2f& window_position) {
+    sf::Vector2f pixel;
+    if (canvas_.MapWindowToPixel(window_position, pixel)) {
+        canvas_.Zoom(std::pow(CANVAS_ZOOM_STEP, -wheel_delta), pixel);
+    }
+}
+
+void InterfaceBuilder::BeginCanvasPan(const sf::Vector2f& window_position) {
+    sf::Vector2f pixel;
+    if (canvas_.MapWindowToPixel(window_position, pixel)) {
+        canvas_panning_ = true;
+        pan_position_ = window_position;
+    }
+}
+
+void InterfaceBuilder::UpdateCanvasPan(const sf::Vector2f& window_position) {
+    if (canvas_panning_) {
+        canvas_.Pan(window_position - pan_position_);
+        pan_position_ = window_position;
+    }
+}
+
+void InterfaceBuilder::EndCanvasPan() {
+    canvas_panning_ = false;
 }
 
 } // namespace gui_wrapper
\ No newline at end of file
@@ -2,12 +2,17 @@
 
 #include "gui/canvas.h"
 #include "gui/coords.h"
+#include "gui/flight_board.h"
+#include "gui/fleet_renderer.h"
+#include "gui/layered_canvas.h"
 #include "gui/fps.h"
 #include "gui/menu.h"
+#include "gui/number_formatter.h"
 #include "gui/separator.h"
 #include "gui/slider.h"
 #include "gui/stamp.h"
 #include "gui/text_label.h"
+#include "gui/tile_map.h"
 
 #include "../utils/aviation_handler.h"
 #include "../utils/weather_handler.h"
@@ -18,51 +23,97 @@ class InterfaceBuilder {
 public:
     InterfaceBuilder(sf::RenderWindow* window, 
                     tgui::Gui* gui, objects::Plane* plane, 
+                    sim::Simulation* simulation,
                     utils::weather_handler::WeatherHandler* weather_handler, 
                     utils::aviation_handler::AviationHandler* aviation_handler);
 
     void CreateAsyncComponents();
+
+    // Метки погоды, рейсов и времени создаются сразу с заглушками и
+    // заполняются в UpdateAwaitComponents, когда данные загрузятся
     void CreateAwaitComponents();
 
+    // Раз в кадр: если обработчики опубликовали новые данные, метки
+    // обновляются. Окно загрузку не ждет
+    void UpdateAwaitComponents();
+
     void UpdateFrameRateLabel();
-    void UpdateCoordsLabel(const tgui::String& text);
+    void UpdateCoordsLabel(int x, int y);
     void UpdateStampLabels();
     void UpdatePlaneCoordsLabel();
-    void UpdateCanvas();
+    void UpdateCanvas(const sim::FleetSnapshot& snapshot);
+
+    // Прокрутка табло рейсов колесом мыши, координаты - в окне
+    void ScrollFlightBoard(float wheel_delta, const sf::Vector2f& window_position);
+
+    // Масштаб колесом мыши и сдвиг правой кнопкой, координаты - в окне
+    void ZoomCanvas(float wheel_delta, const sf::Vector2f& window_position);
+    void BeginCanvasPan(const sf::Vector2f& window_position);
+    void UpdateCanvasPan(const sf::Vector2f& window_position);
+    void EndCanvasPan();
 
 private:
     sf::RenderWindow* window_;
     tgui::Gui* gui_;
     objects::Plane* plane_;
+    sim::Simulation* simulation_;
     utils::weather_handler::WeatherHandler* weather_handler_;
     utils::aviation_handler::AviationHandler* aviation_handler_;
 
+    sim::Projection projection_;
     gui_wrapper::Canvas canvas_;
     sf::Texture map_texture_;
     sf::Sprite map_sprite_;
+    gui_wrapper::TileMap tile_map_;
+    bool canvas_panning_ = false;
+    sf::Vector2f pan_position_;
+    gui_wrapper::FleetRenderer fleet_renderer_;
+    gui_wrapper::LayeredCanvas canvas_layers_;
     gui_wrapper::FrameRateLabel frame_rate_label_;
     gui_wrapper::CoordsLabel coords_label_;;
     gui_wrapper::TimeStamp time_label_;
     gui_wrapper::DateStamp date_label_;
     gui_wrapper::TextLabel longtitude_label_;
     gui_wrapper::TextLabel latitude_label_;
+    gui_wrapper::TextLabel altitude_label_;
+    gui_wrapper::TextLabel vertical_rate_label_;
     gui_wrapper::ValueSlider linear_speed_slider_;
     gui_wrapper::ValueSlider angle_speed_slider_;
     gui_wrapper::TextLabel linear_speed_slider_value_label_;
     gui_wrapper::TextLabel angle_speed_slider_value_label_;
 
+    // Номера последних показанных публикаций, 0 - данных еще не было
+    uint64_t weather_version_ = 0;
+    uint64_t flights_version_ = 0;
+    gui_wrapper::TextLabel temperature_label_;
+    gui_wrapper::TextLabel pressure_label_;
+    gui_wrapper::TextLabel humidity_label_;
+    gui_wrapper::TextLabel wind_speed_label_;
+    gui_wrapper::TextLabel wind_dir_label_;
+    gui_wrapper::TextLabel times_of_day_label_;
+    gui_wrapper::TextLabel flights_status_label_;
+
+    gui_wrapper::FlightBoard flight_board_;
+
+    // Общий буфер для текста меток, обновляемых каждый кадр
+    gui_wrapper::NumberFormatter label_formatter_;
+
 private:
     void CreateMainLines();
     void CreateTimeWeatherHline();
     void CreateFlightsTableLines();
     void CreateCanvas();
     void CreateMapSprite();
+    void CreateTileMap();
+    void CreateFleetRenderer();
+    void CreateCanvasLayers();
     void CreateFrameRateLabel();
     void CreateCoordinateLabel();
     void CreateUpperMenu();
     void CreateStampLabels();
     void CreateTextLabels();
     void CreateWeatherLabels();
+    void FillWeatherLabels(const utils::weather_handler::WeatherData& weather);
     void CreatePlaneCoordsLabel();
     void CreateFlightsTableLabels();
     void CreateSlider();
@@ -1,4 +1,8 @@
 #include "gui_builder.h"
+#include "../utils/refresh_scheduler.h"
+
+#include <cstdlib>
+#include <cstring>
 
 using namespace global_parameters;
 using namespace gui_wrapper;
@@ -11,32 +15,50 @@ int main(int argc, char* argv[]) {
     tgui::Gui gui{ window };
     window.setFramerateLimit(MAX_FPS); // ограничитель кадров
 
-    // Погода
+    // Погода и авиация опрашиваются в фоне и обновляются периодически,
+    // окно их не ждет
     weather_handler::WeatherHandler weather_handler;
-    sf::Thread weather_thread(&weather_handler::WeatherHandler::Initialize, &weather_handler);
-    weather_thread.launch();
-
-    // Авиация
     aviation_handler::AviationHandler aviation_handler;
-    sf::Thread aviation_thread(&aviation_handler::AviationHandler::Initialize, &aviation_handler);
-    aviation_thread.launch(); 
-
-    // Объект самолета
-    Plane plane;
+    // --seed N повторяет рейсы прошлого сеанса (зерно есть в его записи)
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--seed") == 0) {
+            aviation_handler.SetSeed(static_cast<uint32_t>(std::strtoul(argv[i + 1], nullptr, 10)));
+        }
+    }
+    refresh_scheduler::RefreshScheduler refresher(DATA_REFRESH_JITTER, DATA_RETRY_DELAY, DATA_MAX_BACKOFF);
+    refresher.Add([&weather_handler]() { return weather_handler.Refresh(); }, weather_handler.GetRefreshInterval());
+    refresher.Add([&aviation_handler]() { return aviation_handler.Refresh(); }, aviation_handler.GetRefreshInterval());
+    refresher.Start();
 
-    InterfaceBuilder builder(&window, &gui, &plane, &weather_handler, &aviation_handler);
-    builder.CreateAsyncComponents();
+    // Двоичный журнал событий симуляции. Объявлен раньше симуляции,
+    // чтобы пережить ее поток
+    event_log::EventLog event_log(EVENT_LOG_PATH, EVENT_LOG_CAPACITY, EVENT_LOG_FLUSH_INTERVAL);
+    // Запись сеанса для утилиты replay: команды и опорные кадры, свой
+    // файл на каждый запуск
+    sim::SessionRecorder recorder(SESSION_RECORD_PATH, aviation_handler.GetSeed(), SESSION_RECORD_KEEP);
 
-    weather_thread.wait();
-    aviation_thread.wait();
+    // Модель полета в отдельном потоке и объект самолета, смотрящий в свой слот
+    sim::Simulation simulation;
+    simulation.SetEventLog(&event_log);
+    simulation.SetRecorder(&recorder);
+    Plane plane(&simulation);
 
+    InterfaceBuilder builder(&window, &gui, &plane, &simulation, &weather_handler, &aviation_handler);
+    builder.CreateAsyncComponents();
     builder.CreateAwaitComponents();
 
-    // Создаем логгер, выводящий все в файл (папка logs)
-    log_handler::LogHandler logger("../logs/sample.log");
+    // Создаем логгер, выводящий все в файл (папка logs) из фонового
+    // потока. При переполнении буфера записи отбрасываются, а их число
+    // попадает в журнал. Файл ротируется по размеру и раз в сутки,
+    // старые части сжимаются в фоне
+    log_handler::LogHandler logger("../logs/sample.log", { LOG_QUEUE_CAPACITY, async_logger::OverflowPolicy::COUNT, LOG_FLUSH_INTERVAL,
+                                                           { LOG_ROTATION_SIZE, LOG_ROTATION_INTERVAL, LOG_ROTATION_KEEP, LOG_ROTATION_COMPRESS } });
     logger.LogTrivial(boost::log::trivial::severity_level::info, "-------------------- LOGGER HAS BEEN INITIALIZED --------------------");
     event_handler::EventHandler::SetLogger(&logger);
 
+    event_log.Message("Program has been started");
+    simulation.Start();
+
     // ОСНОВНОЙ ПРОГРАММНЫЙ ЦИКЛ
     while (window.isOpen()) {
         sf::Event event;
@@ -47,28 +69,55 @@ int main(int argc, char* argv[]) {
             switch (event.type) {
                 case sf::Event::Closed:
                     logger.LogTrivial(boost::log::trivial::severity_level::info, "Program has been closed");
+                    event_log.Message("Program has been closed");
                     window.close();
                     break;
+                case sf::Event::MouseWheelScrolled: {
+                    const sf::Vector2f position(static_cast<float>(event.mouseWheelScroll.x), static_cast<float>(event.mouseWheelScroll.y));
+                    builder.ScrollFlightBoard(event.mouseWheelScroll.delta, position);
+                    builder.ZoomCanvas(event.mouseWheelScroll.delta, position);
+                    break;
+                }
+                case sf::Event::MouseButtonPressed:
+                    if (event.mouseButton.button == sf::Mouse::Right) {
+                        builder.BeginCanvasPan({ static_cast<float>(event.mouseButton.x), static_cast<float>(event.mouseButton.y) });
+                    }
+                    break;
+                case sf::Event::MouseButtonReleased:
+                    if (event.mouseButton.button == sf::Mouse::Right) {
+                        builder.EndCanvasPan();
+                    }
+                    break;
                 case sf::Event::MouseMoved:
-                    tgui::String text{ std::to_string(event.mouseMove.x) + " " + std::to_string(event.mouseMove.y) };
-                    builder.UpdateCoordsLabel(text);
+                    builder.UpdateCanvasPan({ static_cast<float>(event.mouseMove.x), static_cast<float>(event.mouseMove.y) });
+                    builder.UpdateCoordsLabel(event.mouseMove.x, event.mouseMove.y);
                     break;
             }
         }
         
+        // Команды, не поместившиеся в очередь в прошлых кадрах
+        simulation.FlushCommands();
+
+        builder.UpdateAwaitComponents();
+
         builder.UpdateStampLabels();
 
         builder.UpdateFrameRateLabel();
 
-        plane.Control();
+        // Последний готовый кадр симуляции, без ожидания ее потока
+        const sim::FleetSnapshot& snapshot = simulation.AcquireSnapshot();
+        plane.Control(snapshot);
         builder.UpdatePlaneCoordsLabel();
         
-        builder.UpdateCanvas();
+        builder.UpdateCanvas(snapshot);
 
         window.clear(sf::Color{ BACKGROUND_DEFAULT_COLOR.r, BACKGROUND_DEFAULT_COLOR.g, BACKGROUND_DEFAULT_COLOR.b });
         gui.draw();
         window.display();
     }
 
+    refresher.Stop();
+    simulation.Stop();
+
     return 0;
 }
\ No newline at end of file
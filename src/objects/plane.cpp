@@ -2,34 +2,64 @@
 
 namespace objects {
 
+Plane::Plane(sim::Simulation* simulation)
+    : simulation_(simulation)
+    , slot_(simulation->AddAircraft(GetInitialPosition()))
+    , current_position_(GetInitialPosition()) {
+}
+
 void Plane::SetPrimitive(const sf::Sprite& circle) {
     plane_ = circle;
 }
 
+void Plane::SetPosition(const sf::Vector2f& position) {
+    current_position_ = position;
+    simulation_->Post({ sim::CommandType::SET_POSITION, static_cast<uint32_t>(slot_), position.x, position.y, 0.f });
+}
+
 void Plane::SetToDraw(bool to_draw) {
     to_draw_ = to_draw;
-    longtitude = "0°";
-    latitude = "0°";
+    simulation_->Post({ sim::CommandType::SET_ACTIVE, static_cast<uint32_t>(slot_), 0.f, 0.f, to_draw ? 1.f : 0.f });
+    geo_position_ = { 0.0, 0.0 };
 }
 
 void Plane::SetTargetPosition(const sf::Vector2f& target_position) {
     target_position_ = target_position;
-    tracking_target_ = true;
+    simulation_->Post({ sim::CommandType::SET_TARGET, static_cast<uint32_t>(slot_), target_position.x, target_position.y, 0.f });
+}
+
+void Plane::AddWaypoint(const sf::Vector2f& position, sim::WaypointType type) {
+    target_position_ = position;
+    simulation_->Post({ sim::CommandType::ADD_WAYPOINT, static_cast<uint32_t>(slot_), position.x, position.y, static_cast<float>(type) });
+}
+
+void Plane::ClearRoute() {
+    simulation_->Post({ sim::CommandType::CLEAR_ROUTE, static_cast<uint32_t>(slot_), 0.f, 0.f, 0.f });
+}
+
+void Plane::SetAltitude(float altitude) {
+    altitude_ = altitude;
+    simulation_->Post({ sim::CommandType::SET_ALTITUDE, static_cast<uint32_t>(slot_), 0.f, 0.f, altitude });
+}
+
+void Plane::SetTargetAltitude(float target_altitude) {
+    simulation_->Post({ sim::CommandType::SET_TARGET_ALTITUDE, static_cast<uint32_t>(slot_), 0.f, 0.f, target_altitude });
 }
 
 void Plane::SetAngle(float angle) {
-    angle_ = angle;
+    simulation_->Post({ sim::CommandType::SET_ANGLE, static_cast<uint32_t>(slot_), 0.f, 0.f, angle });
 }
 
 void Plane::SetLinearSpeed(float linear_speed) {
     speed_ = linear_speed;
+    simulation_->Post({ sim::CommandType::SET_SPEED, static_cast<uint32_t>(slot_), 0.f, 0.f, linear_speed });
 }
 
 void Plane::SetAngleSpeed(float angle_speed) {
-    angle_speed_ = angle_speed;
+    simulation_->Post({ sim::CommandType::SET_ANGLE_SPEED, static_cast<uint32_t>(slot_), 0.f, 0.f, angle_speed });
 }
 
-sf::Sprite Plane::GetPrimitive() const {
+const sf::Sprite& Plane::GetPrimitive() const {
     return plane_;
 }
 
@@ -46,7 +76,23 @@ sf::Vector2f Plane::GetTargetPosition() const {
 }
 
 sf::Vector2f Plane::GetCurrentPosition() const {
-    return plane_.getPosition();
+    return current_position_;
+}
+
+float Plane::GetAltitude() const {
+    return altitude_;
+}
+
+float Plane::GetVerticalRate() const {
+    return vertical_rate_;
+}
+
+sf::Vector2f Plane::GetInitialPosition() const {
+    return projection_.GeoToEnu({ global_parameters::PLANE_INITIAL_LATITUDE, global_parameters::PLANE_INITIAL_LONGITUDE });
+}
+
+sim::GeoPoint Plane::GetGeoPosition() const {
+    return geo_position_;
 }
 
 sf::Vector2f Plane::GetPlaneSize() const {
@@ -55,67 +101,17 @@ sf::Vector2f Plane::GetPlaneSize() const {
            };
 }
 
-void Plane::Control() {
-    if (to_draw_) {
-        double lng = plane_.getPosition().y / global_parameters::PLANE_ANGLE_ROTATION_Y * global_parameters::PLANE_ROTATION_COEFFICIENT_Y + global_parameters::PLANE_INITIAL_ANGLE_POS_Y;
-        double lat = plane_.getPosition().x / global_parameters::PLANE_ANGLE_ROTATION_X * global_parameters::PLANE_ROTATION_COEFFICIENT_X + global_parameters::PLANE_INITIAL_ANGLE_POS_X;
-        
-        longtitude = std::to_string(lng) + "°";
-        latitude = std::to_string(lat) + "°";
-
-        sf::Vector2f direction;
-
-        if (tracking_target_) {
-            direction = target_position_ - plane_.getPosition();
-            if (direction.x > 0) {
-                target_angle_ = asin(direction.y / sqrt(pow(direction.x, 2) + pow(direction.y, 2)));
-            }
-            else {
-                target_angle_ = M_PI - asin(direction.y / sqrt(pow(direction.x, 2) + pow(direction.y, 2)));
-            }
-        }
-
-        if (target_angle_ - angle_ > 2 * M_PI) {
-            angle_ += 2 * M_PI;
-        }
-
-        if (angle_ - target_angle_ > 2 * M_PI) {
-            angle_ -= 2 * M_PI;
-        }
-
-        if (angle_ - target_angle_ > 1.1*angle_speed_ || angle_ - target_angle_ < -1.1*angle_speed_){
-            if((sqrt(pow(direction.x,2)+pow(direction.y,2))>4*speed_/2/cos(M_PI/2-angle_speed_)) || (target_angle_ - angle_ < M_PI/2 && target_angle_ - angle_ > -M_PI/2) || target_angle_ - angle_ < -M_PI*3/4 || target_angle_ - angle_ > M_PI*3/4){
-            if ((target_angle_ - angle_ > 0 && target_angle_ - angle_ < M_PI) || (target_angle_ - angle_ < -M_PI )) {
-                angle_ += angle_speed_;
-            }
-            else {
-                angle_ -= angle_speed_;
-            }
-            }
-        }
-        if(sqrt(pow(direction.x,2)+pow(direction.y,2))<5*speed_) {
-            tracking_target_ = false;
-        }
-
-        sf::Vector2f movement = speed_ * sf::Vector2f(cos(angle_), sin(angle_));
-
-        plane_.move(movement);
-        plane_.setRotation(angle_ / M_PI * 180 + 90);
-    }
-}
-
-std::string Plane::FloatToStringWithPrecision(float number, int precision) {
-    std::string result = std::to_string(number);
-    const size_t DOT = result.find('.');
-    
-    if (DOT != std::string::npos) {
-        size_t end_position = DOT + 1 + precision;
-        if (end_position < result.length()) {
-            result.erase(result.begin() + end_position, result.end());
-        }
+// Движение самолета считает поток симуляции, а рисует его
+// FleetRenderer, здесь только обновляем координаты для меток
+void Plane::Control(const sim::FleetSnapshot& snapshot) {
+    if (to_draw_ && slot_ < snapshot.Size() && snapshot.active[slot_]) {
+        const float alpha = snapshot.GetAlpha();
+        const sf::Vector2f position = snapshot.GetInterpolatedPosition(slot_, alpha);
+        current_position_ = position;
+        geo_position_ = projection_.EnuToGeo(position);
+        altitude_ = snapshot.GetInterpolatedAltitude(slot_, alpha);
+        vertical_rate_ = snapshot.vertical_rate[slot_];
     }
-
-    return result;
 }
 
 } // namespace objects
\ No newline at end of file
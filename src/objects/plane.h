@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../global_parameters.h"
+#include "../sim/projection.h"
+#include "../sim/simulation.h"
 
 #include <cmath>
 #include <SFML/Graphics.hpp>
@@ -11,21 +13,38 @@ const sf::Vector2f PLANE_SIZE = { 50.f, 50.f };
 
 class Plane {
 public:
-    Plane() = default;
+    // Самолет - это представление (view) одного слота во Fleet:
+    // изменения уходят потоку симуляции командами, а положение
+    // читается из последнего снимка
+    explicit Plane(sim::Simulation* simulation);
 
     void SetPrimitive(const sf::Sprite& circle);
 
     void SetToDraw(bool to_draw);
 
+    // Положения задаются в метрах ENU вокруг опорной точки
+    void SetPosition(const sf::Vector2f& position);
+
     void SetTargetPosition(const sf::Vector2f& target_position);
 
+    // Добавляет точку в конец маршрута самолета
+    void AddWaypoint(const sf::Vector2f& position, sim::WaypointType type);
+
+    void ClearRoute();
+
+    // Высоты в метрах: SetAltitude переносит самолет сразу,
+    // SetTargetAltitude задает набор или снижение
+    void SetAltitude(float altitude);
+
+    void SetTargetAltitude(float target_altitude);
+
     void SetAngle(float angle);
 
     void SetLinearSpeed(float linear_speed);
 
     void SetAngleSpeed(float angle_speed);
 
-    sf::Sprite GetPrimitive() const;
+    const sf::Sprite& GetPrimitive() const;
 
     float GetSpeed() const;
 
@@ -35,25 +54,34 @@ public:
 
     sf::Vector2f GetCurrentPosition() const;
 
-    sf::Vector2f GetPlaneSize() const;
+    // Высота и вертикальная скорость по последнему снимку
+    float GetAltitude() const;
 
-    void Control();
+    float GetVerticalRate() const;
 
-    static std::string FloatToStringWithPrecision(float number, int precision = 2);
+    sf::Vector2f GetInitialPosition() const;
 
-public:
-    std::string longtitude = "0°";
-    std::string latitude = "0°";
+    // Широта и долгота по последнему снимку
+    sim::GeoPoint GetGeoPosition() const;
+
+    sf::Vector2f GetPlaneSize() const;
+
+    void Control(const sim::FleetSnapshot& snapshot);
 
 private:
-    float angle_speed_ = 0.01f;
-    float angle_ = 0.f;
-    float target_angle_ = 0.f;
-    bool tracking_target_ = false;
+    sim::Simulation* simulation_;
+    sim::Projection projection_;
+    size_t slot_;
     sf::Sprite plane_;
-    float speed_ = 0.5f;
+
+    // Последние значения, заданные интерфейсом
     bool to_draw_ = false;
+    float speed_ = global_parameters::PLANE_DEFAULT_SPEED;
     sf::Vector2f target_position_ = { 0.f, 0.f };
+    sf::Vector2f current_position_;
+    sim::GeoPoint geo_position_ = { 0.0, 0.0 };
+    float altitude_ = global_parameters::PLANE_INITIAL_ALTITUDE;
+    float vertical_rate_ = 0.f;
 };
 
 } // namespace objects
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+/*
+   Команда от интерфейса потоку симуляции. Все изменения состояния
+   самолетов и часов симуляции идут только через команды, поэтому
+   Fleet и SimClock принадлежат потоку симуляции целиком.
+*/
+
+namespace sim {
+
+enum class CommandType : uint8_t {
+    ADD_AIRCRAFT,
+    SET_ACTIVE,
+    SET_POSITION,
+    SET_TARGET,
+    SET_ALTITUDE,
+    SET_TARGET_ALTITUDE,
+    SET_ANGLE,
+    SET_SPEED,
+    SET_ANGLE_SPEED,
+    SET_RATE,
+    SET_TIME_SCALE,
+    SET_SEPARATION,
+    ADD_WAYPOINT,
+    CLEAR_ROUTE,
+    SET_WIND
+};
+
+constexpr size_t COMMAND_TYPE_COUNT = 15;
+
+// Имя команды для журналов
+inline std::string_view GetCommandName(CommandType type) {
+    static constexpr std::array<std::string_view, COMMAND_TYPE_COUNT> NAMES = {
+        "ADD_AIRCRAFT", "SET_ACTIVE", "SET_POSITION", "SET_TARGET", "SET_ALTITUDE",
+        "SET_TARGET_ALTITUDE", "SET_ANGLE", "SET_SPEED", "SET_ANGLE_SPEED", "SET_RATE",
+        "SET_TIME_SCALE", "SET_SEPARATION", "ADD_WAYPOINT", "CLEAR_ROUTE", "SET_WIND"
+    };
+    const size_t index = static_cast<size_t>(type);
+    return index < NAMES.size() ? NAMES[index] : std::string_view("UNKNOWN");
+}
+
+// Для ADD_AIRCRAFT value - начальная высота, для ADD_WAYPOINT x, y -
+// точка пути, value - WaypointType, для SET_WIND x, y - приземный
+// ветер в ENU, м/с
+struct Command {
+    CommandType type;
+    uint32_t slot;
+    float x;
+    float y;
+    float value;
+};
+
+} // namespace sim
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "conflict_alert.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sim {
+
+void ConflictAlert::SetSeparation(float separation) {
+    separation_ = separation;
+}
+
+float ConflictAlert::GetSeparation() const {
+    return separation_;
+}
+
+void ConflictAlert::SetVerticalSeparation(float separation) {
+    vertical_separation_ = separation;
+}
+
+float ConflictAlert::GetVerticalSeparation() const {
+    return vertical_separation_;
+}
+
+void ConflictAlert::SetScheduler(TaskScheduler* scheduler) {
+    scheduler_ = scheduler;
+}
+
+void ConflictAlert::Update(const float* x, const float* y, const float* altitude, const uint8_t* active, size_t count) {
+    // Ячейка и слой размером с интервалы: любая пара ближе интервалов
+    // лежит в одной или в соседних ячейках
+    grid_.Build(x, y, altitude, active, count, separation_, vertical_separation_);
+
+    const size_t grain = global_parameters::SIM_CONFLICT_GRAIN;
+    const size_t chunk_count = TaskScheduler::GetChunkCount(grid_.Size(), grain);
+    if (chunk_conflicts_.size() < chunk_count) {
+        chunk_conflicts_.resize(chunk_count);
+    }
+
+    auto search_range = [this, altitude](size_t chunk, size_t begin, size_t end) {
+        std::vector<Conflict>& found = chunk_conflicts_[chunk];
+        found.clear();
+        grid_.ForEachPairWithin(separation_, vertical_separation_, begin, end, [&found, altitude](uint32_t a, uint32_t b, float distance2) {
+            found.push_back({ std::min(a, b), std::max(a, b), std::sqrt(distance2), std::abs(altitude[a] - altitude[b]) });
+        });
+    };
+
+    if (scheduler_ != nullptr) {
+        scheduler_->ParallelFor(grid_.Size(), grain, search_range);
+    }
+    else {
+        for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+            search_range(chunk, chunk * grain, std::min((chunk + 1) * grain, grid_.Size()));
+        }
+    }
+
+    conflicts_.clear();
+    in_conflict_.assign(count, 0);
+    for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+        for (const Conflict& conflict : chunk_conflicts_[chunk]) {
+            conflicts_.push_back(conflict);
+            in_conflict_[conflict.first] = 1;
+            in_conflict_[conflict.second] = 1;
+        }
+    }
+}
+
+const std::vector<Conflict>& ConflictAlert::GetConflicts() const {
+    return conflicts_;
+}
+
+const std::vector<uint8_t>& ConflictAlert::GetInConflict() const {
+    return in_conflict_;
+}
+
+const SpatialGrid& ConflictAlert::GetGrid() const {
+    return grid_;
+}
+
+} // namespace sim
\ No newline at end of file
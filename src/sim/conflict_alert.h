@@ -0,0 +1,62 @@
+#pragma once
+
+#include "../global_parameters.h"
+#include "fleet_snapshot.h"
+#include "spatial_grid.h"
+#include "task_scheduler.h"
+
+#include <cstdint>
+#include <vector>
+
+/*
+   Краткосрочное предупреждение о конфликтах (STCA). Каждый тик
+   сетка SpatialGrid пересобирается по положениям и высотам флота, и
+   все пары самолетов ближе заданного горизонтального интервала и
+   одновременно ближе вертикального попадают в список конфликтов.
+   Слой сетки равен вертикальному интервалу, поэтому самолеты на
+   разных эшелонах даже не сравниваются. Поиск пар режется на куски по порядку сетки и
+   идет на потоках TaskScheduler, куски сливаются по номерам, поэтому
+   список не зависит от числа потоков.
+*/
+
+namespace sim {
+
+class ConflictAlert {
+public:
+    ConflictAlert() = default;
+
+    // Горизонтальный интервал, метры
+    void SetSeparation(float separation);
+
+    float GetSeparation() const;
+
+    // Вертикальный интервал, метры
+    void SetVerticalSeparation(float separation);
+
+    float GetVerticalSeparation() const;
+
+    // nullptr - поиск в текущем потоке
+    void SetScheduler(TaskScheduler* scheduler);
+
+    void Update(const float* x, const float* y, const float* altitude, const uint8_t* active, size_t count);
+
+    // Пары с first < second, упорядоченные по ячейкам сетки
+    const std::vector<Conflict>& GetConflicts() const;
+
+    // Флаг для каждого слота: участвует ли он хотя бы в одном конфликте
+    const std::vector<uint8_t>& GetInConflict() const;
+
+    const SpatialGrid& GetGrid() const;
+
+private:
+    float separation_ = global_parameters::SIM_CONFLICT_SEPARATION;
+    float vertical_separation_ = global_parameters::SIM_VERTICAL_SEPARATION;
+    TaskScheduler* scheduler_ = nullptr;
+    SpatialGrid grid_;
+
+    std::vector<std::vector<Conflict>> chunk_conflicts_;
+    std::vector<Conflict> conflicts_;
+    std::vector<uint8_t> in_conflict_;
+};
+
+} // namespace sim
\ No newline at end of file
@@ -0,0 +1,202 @@
+#include "conflict_probe.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace global_parameters;
+
+namespace sim {
+
+void ConflictProbe::SetSeparation(float separation) {
+    separation_ = separation;
+}
+
+float ConflictProbe::GetSeparation() const {
+    return separation_;
+}
+
+void ConflictProbe::SetVerticalSeparation(float separation) {
+    vertical_separation_ = separation;
+}
+
+float ConflictProbe::GetVerticalSeparation() const {
+    return vertical_separation_;
+}
+
+void ConflictProbe::SetScheduler(TaskScheduler* scheduler) {
+    scheduler_ = scheduler;
+}
+
+void ConflictProbe::Probe(const TrajectoryPredictor& predictor, const uint8_t* active, size_t count, double now) {
+    const size_t slice_count = TrajectoryPredictor::GetSampleCount() - 1;
+    const size_t chunk_count = TaskScheduler::GetChunkCount(slice_count, SIM_PROBE_SLICE_GRAIN);
+    if (workspaces_.size() < chunk_count) {
+        workspaces_.resize(chunk_count);
+    }
+
+    auto probe_range = [&](size_t chunk, size_t begin, size_t end) {
+        SliceWorkspace& workspace = workspaces_[chunk];
+        workspace.found.clear();
+        workspace.seen.clear();
+        ReadPositions(predictor, active, count, now + begin * static_cast<double>(SIM_PREDICTION_STEP), workspace.from, workspace.from_altitude, workspace.from_known);
+        for (size_t slice = begin; slice < end; ++slice) {
+            ProbeSlice(workspace, predictor, active, count, now, slice);
+        }
+    };
+
+    if (scheduler_ != nullptr) {
+        scheduler_->ParallelFor(slice_count, SIM_PROBE_SLICE_GRAIN, probe_range);
+    }
+    else {
+        for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+            probe_range(chunk, chunk * SIM_PROBE_SLICE_GRAIN, std::min((chunk + 1) * SIM_PROBE_SLICE_GRAIN, slice_count));
+        }
+    }
+
+    // Куски идут по времени, поэтому первая встреча пары - самая ранняя
+    conflicts_.clear();
+    seen_.clear();
+    in_conflict_.assign(count, 0);
+    for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+        for (const PredictedConflict& conflict : workspaces_[chunk].found) {
+            if (seen_.insert(GetPairKey(conflict.first, conflict.second)).second) {
+                conflicts_.push_back(conflict);
+                in_conflict_[conflict.first] = 1;
+                in_conflict_[conflict.second] = 1;
+            }
+        }
+    }
+}
+
+const std::vector<PredictedConflict>& ConflictProbe::GetConflicts() const {
+    return conflicts_;
+}
+
+const std::vector<uint8_t>& ConflictProbe::GetInConflict() const {
+    return in_conflict_;
+}
+
+void ConflictProbe::ReadPositions(const TrajectoryPredictor& predictor, const uint8_t* active, size_t count, double time,
+                                  std::vector<sf::Vector2f>& position, std::vector<float>& altitude, std::vector<uint8_t>& known) {
+    position.resize(count);
+    altitude.resize(count);
+    known.resize(count);
+    for (size_t slot = 0; slot < count; ++slot) {
+        known[slot] = active[slot] && predictor.GetPosition(slot, time, position[slot], altitude[slot]);
+    }
+}
+
+void ConflictProbe::ProbeSlice(SliceWorkspace& workspace, const TrajectoryPredictor& predictor,
+                               const uint8_t* active, size_t count, double now, size_t slice) const {
+    const float step = SIM_PREDICTION_STEP;
+    const double start = now + slice * static_cast<double>(step);
+    ReadPositions(predictor, active, count, start + step, workspace.to, workspace.to_altitude, workspace.to_known);
+
+    workspace.slot.clear();
+    workspace.x0.clear();
+    workspace.y0.clear();
+    workspace.x1.clear();
+    workspace.y1.clear();
+    workspace.z0.clear();
+    workspace.z1.clear();
+    workspace.middle_x.clear();
+    workspace.middle_y.clear();
+    workspace.middle_z.clear();
+
+    float max_length2 = 0.f;
+    float max_climb = 0.f;
+    for (size_t slot = 0; slot < count; ++slot) {
+        if (!workspace.from_known[slot] || !workspace.to_known[slot]) {
+            continue;
+        }
+        const sf::Vector2f from = workspace.from[slot];
+        const sf::Vector2f to = workspace.to[slot];
+        workspace.slot.push_back(static_cast<uint32_t>(slot));
+        workspace.x0.push_back(from.x);
+        workspace.y0.push_back(from.y);
+        workspace.x1.push_back(to.x);
+        workspace.y1.push_back(to.y);
+        workspace.z0.push_back(workspace.from_altitude[slot]);
+        workspace.z1.push_back(workspace.to_altitude[slot]);
+        workspace.middle_x.push_back((from.x + to.x) / 2);
+        workspace.middle_y.push_back((from.y + to.y) / 2);
+        workspace.middle_z.push_back((workspace.from_altitude[slot] + workspace.to_altitude[slot]) / 2);
+        max_length2 = std::max(max_length2, (to.x - from.x) * (to.x - from.x) + (to.y - from.y) * (to.y - from.y));
+        max_climb = std::max(max_climb, std::abs(workspace.to_altitude[slot] - workspace.from_altitude[slot]));
+    }
+
+    const size_t size = workspace.slot.size();
+    workspace.present.assign(size, 1);
+
+    // Середины отрезков сближающейся пары не дальше интервала плюс
+    // полусумма длин отрезков, по высоте - так же
+    const float reach = separation_ + std::sqrt(max_length2);
+    const float vertical_reach = vertical_separation_ + max_climb;
+    workspace.grid.Build(workspace.middle_x.data(), workspace.middle_y.data(), workspace.middle_z.data(),
+                         workspace.present.data(), size, reach, vertical_reach);
+
+    const float separation2 = separation_ * separation_;
+    workspace.grid.ForEachPairWithin(reach, vertical_reach, [&](uint32_t a, uint32_t b, float) {
+        // Относительное движение b относительно a за срез, s - доля среза
+        const float px = workspace.x0[b] - workspace.x0[a];
+        const float py = workspace.y0[b] - workspace.y0[a];
+        const float pz = workspace.z0[b] - workspace.z0[a];
+        const float vx = (workspace.x1[b] - workspace.x0[b]) - (workspace.x1[a] - workspace.x0[a]);
+        const float vy = (workspace.y1[b] - workspace.y0[b]) - (workspace.y1[a] - workspace.y0[a]);
+        const float vz = (workspace.z1[b] - workspace.z0[b]) - (workspace.z1[a] - workspace.z0[a]);
+
+        // Горизонтальный интервал нарушен между корнями |p + v * s| = separation
+        const float v2 = vx * vx + vy * vy;
+        const float half_b = px * vx + py * vy;
+        const float c = px * px + py * py - separation2;
+        float begin = 0.f;
+        float end = 1.f;
+        if (v2 > 0.f) {
+            const float discriminant = half_b * half_b - v2 * c;
+            if (discriminant <= 0.f) {
+                return;
+            }
+            begin = std::max(begin, (-half_b - std::sqrt(discriminant)) / v2);
+            end = std::min(end, (-half_b + std::sqrt(discriminant)) / v2);
+        }
+        else if (c >= 0.f) {
+            return;
+        }
+
+        // Вертикальный - между корнями |pz + vz * s| = vertical_separation
+        if (vz != 0.f) {
+            const float first = (-vertical_separation_ - pz) / vz;
+            const float second = (vertical_separation_ - pz) / vz;
+            begin = std::max(begin, std::min(first, second));
+            end = std::min(end, std::max(first, second));
+        }
+        else if (std::abs(pz) >= vertical_separation_) {
+            return;
+        }
+
+        if (begin >= end) {
+            return;
+        }
+
+        // Наибольшее сближение по горизонтали внутри общего промежутка
+        const float s = v2 > 0.f ? std::clamp(-half_b / v2, begin, end) : begin;
+        const float dx = px + vx * s;
+        const float dy = py + vy * s;
+
+        const uint32_t first = std::min(workspace.slot[a], workspace.slot[b]);
+        const uint32_t second = std::max(workspace.slot[a], workspace.slot[b]);
+        if (workspace.seen.insert(GetPairKey(first, second)).second) {
+            workspace.found.push_back({ first, second, (slice + begin) * step, std::sqrt(dx * dx + dy * dy), std::abs(pz + vz * s) });
+        }
+    });
+
+    std::swap(workspace.from, workspace.to);
+    std::swap(workspace.from_altitude, workspace.to_altitude);
+    std::swap(workspace.from_known, workspace.to_known);
+}
+
+uint64_t ConflictProbe::GetPairKey(uint32_t first, uint32_t second) {
+    return (static_cast<uint64_t>(first) << 32) | second;
+}
+
+} // namespace sim
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "../global_parameters.h"
+#include "fleet_snapshot.h"
+#include "spatial_grid.h"
+#include "task_scheduler.h"
+#include "trajectory_predictor.h"
+
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+/*
+   Среднесрочный поиск конфликтов по прогнозу траекторий. Горизонт
+   прогноза режется на срезы по SIM_PREDICTION_STEP секунд. В каждом
+   срезе самолет идет по отрезку между двумя точками прогноза, отрезки
+   раскладываются в SpatialGrid по серединам (с высотой, слоями по
+   эшелонам), а для пар-кандидатов при равномерном движении по
+   отрезкам ищется промежуток, когда нарушены оба интервала,
+   горизонтальный и вертикальный. Для каждой пары остается самый
+   ранний конфликт.
+
+   Срезы независимы и считаются кусками на потоках TaskScheduler, у
+   каждого куска своя сетка и свой список, куски сливаются по
+   порядку времени.
+*/
+
+namespace sim {
+
+class ConflictProbe {
+public:
+    ConflictProbe() = default;
+
+    // Горизонтальный интервал, метры
+    void SetSeparation(float separation);
+
+    float GetSeparation() const;
+
+    // Вертикальный интервал, метры
+    void SetVerticalSeparation(float separation);
+
+    float GetVerticalSeparation() const;
+
+    // nullptr - поиск в текущем потоке
+    void SetScheduler(TaskScheduler* scheduler);
+
+    // Ищет конфликты на горизонте прогноза, начиная с момента now
+    void Probe(const TrajectoryPredictor& predictor, const uint8_t* active, size_t count, double now);
+
+    // Самые ранние конфликты пар, упорядоченные по времени среза
+    const std::vector<PredictedConflict>& GetConflicts() const;
+
+    // Флаг для каждого слота: ожидается ли у него конфликт
+    const std::vector<uint8_t>& GetInConflict() const;
+
+private:
+    // Рабочие данные одного куска срезов
+    struct SliceWorkspace {
+        // Положения всех слотов в начале и в конце текущего среза. Конец
+        // среза - начало следующего, поэтому прогноз читается один раз
+        std::vector<sf::Vector2f> from;
+        std::vector<sf::Vector2f> to;
+        std::vector<float> from_altitude;
+        std::vector<float> to_altitude;
+        std::vector<uint8_t> from_known;
+        std::vector<uint8_t> to_known;
+
+        std::vector<uint32_t> slot;
+        std::vector<float> x0;
+        std::vector<float> y0;
+        std::vector<float> x1;
+        std::vector<float> y1;
+        std::vector<float> z0;
+        std::vector<float> z1;
+        std::vector<float> middle_x;
+        std::vector<float> middle_y;
+        std::vector<float> middle_z;
+        std::vector<uint8_t> present;
+        SpatialGrid grid;
+
+        std::vector<PredictedConflict> found;
+        std::unordered_set<uint64_t> seen;
+    };
+
+    // Читает положения и высоты слотов в момент time
+    static void ReadPositions(const TrajectoryPredictor& predictor, const uint8_t* active, size_t count, double time,
+                              std::vector<sf::Vector2f>& position, std::vector<float>& altitude, std::vector<uint8_t>& known);
+
+    // Ищет конфликты среза slice. Положения в начале среза уже в workspace.from
+    void ProbeSlice(SliceWorkspace& workspace, const TrajectoryPredictor& predictor,
+                    const uint8_t* active, size_t count, double now, size_t slice) const;
+
+    static uint64_t GetPairKey(uint32_t first, uint32_t second);
+
+private:
+    float separation_ = global_parameters::SIM_CONFLICT_SEPARATION;
+    float vertical_separation_ = global_parameters::SIM_VERTICAL_SEPARATION;
+    TaskScheduler* scheduler_ = nullptr;
+
+    std::vector<SliceWorkspace> workspaces_;
+    std::vector<PredictedConflict> conflicts_;
+    std::vector<uint8_t> in_conflict_;
+    std::unordered_set<uint64_t> seen_;
+};
+
+} // namespace sim
\ No newline at end of file
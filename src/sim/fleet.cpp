@@ -0,0 +1,469 @@
+#include "fleet.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sim {
+
+namespace {
+
+// Предел координат слота в опорном кадре. Дальше шаг float больше
+// шага самолета, так что такой кадр заведомо испорчен
+constexpr float MAX_STATE_COORDINATE = 1e9f;
+
+bool IsValidCoordinate(float value) {
+    return std::abs(value) <= MAX_STATE_COORDINATE;
+}
+
+} // namespace
+
+size_t Fleet::Add(const sf::Vector2f& position, float angle, float altitude) {
+    x_.push_back(position.x);
+    y_.push_back(position.y);
+    angle_.push_back(angle);
+    target_angle_.push_back(angle);
+    speed_.push_back(global_parameters::PLANE_DEFAULT_SPEED);
+    angle_speed_.push_back(global_parameters::PLANE_DEFAULT_ANGLE_SPEED);
+    target_x_.push_back(position.x);
+    target_y_.push_back(position.y);
+    tracking_.push_back(0);
+    active_.push_back(0);
+    altitude_.push_back(altitude);
+    vertical_rate_.push_back(0.f);
+    target_altitude_.push_back(altitude);
+    wind_x_.push_back(0.f);
+    wind_y_.push_back(0.f);
+    routes_.Add();
+    routed_.push_back(0);
+    steered_.push_back(0);
+    prev_x_.push_back(position.x);
+    prev_y_.push_back(position.y);
+    prev_angle_.push_back(angle);
+    prev_altitude_.push_back(altitude);
+
+    return x_.size() - 1;
+}
+
+void Fleet::Reserve(size_t capacity) {
+    x_.reserve(capacity);
+    y_.reserve(capacity);
+    angle_.reserve(capacity);
+    target_angle_.reserve(capacity);
+    speed_.reserve(capacity);
+    angle_speed_.reserve(capacity);
+    target_x_.reserve(capacity);
+    target_y_.reserve(capacity);
+    tracking_.reserve(capacity);
+    active_.reserve(capacity);
+    altitude_.reserve(capacity);
+    vertical_rate_.reserve(capacity);
+    target_altitude_.reserve(capacity);
+    wind_x_.reserve(capacity);
+    wind_y_.reserve(capacity);
+    routes_.Reserve(capacity);
+    routed_.reserve(capacity);
+    steered_.reserve(capacity);
+    prev_x_.reserve(capacity);
+    prev_y_.reserve(capacity);
+    prev_angle_.reserve(capacity);
+    prev_altitude_.reserve(capacity);
+}
+
+void Fleet::Clear() {
+    x_.clear();
+    y_.clear();
+    angle_.clear();
+    target_angle_.clear();
+    speed_.clear();
+    angle_speed_.clear();
+    target_x_.clear();
+    target_y_.clear();
+    tracking_.clear();
+    active_.clear();
+    altitude_.clear();
+    vertical_rate_.clear();
+    target_altitude_.clear();
+    wind_x_.clear();
+    wind_y_.clear();
+    routes_.Clear();
+    routed_.clear();
+    steered_.clear();
+    prev_x_.clear();
+    prev_y_.clear();
+    prev_angle_.clear();
+    prev_altitude_.clear();
+}
+
+size_t Fleet::Size() const {
+    return x_.size();
+}
+
+void Fleet::SetActive(size_t slot, bool active) {
+    active_[slot] = active;
+    UpdateSteered(slot);
+}
+
+void Fleet::SetPosition(size_t slot, const sf::Vector2f& position) {
+    x_[slot] = position.x;
+    y_[slot] = position.y;
+    prev_x_[slot] = position.x;
+    prev_y_[slot] = position.y;
+    RebuildRoute(slot);
+}
+
+void Fleet::SetTargetPosition(size_t slot, const sf::Vector2f& target_position) {
+    target_x_[slot] = target_position.x;
+    target_y_[slot] = target_position.y;
+    tracking_[slot] = 1;
+    ClearRoute(slot);
+}
+
+void Fleet::AddWaypoint(size_t slot, const Waypoint& waypoint) {
+    routes_.Append(slot, waypoint, { { x_[slot], y_[slot] }, angle_[slot] }, speed_[slot], angle_speed_[slot]);
+    routed_[slot] = routes_.IsActive(slot);
+    tracking_[slot] = 0;
+    UpdateSteered(slot);
+}
+
+void Fleet::ClearRoute(size_t slot) {
+    // Без цели ядро держит target_angle, поэтому сбрасываем его на текущий курс
+    if (routed_[slot]) {
+        target_angle_[slot] = angle_[slot];
+    }
+    routes_.Reset(slot);
+    routed_[slot] = 0;
+    UpdateSteered(slot);
+}
+
+void Fleet::SetAltitude(size_t slot, float altitude) {
+    altitude_[slot] = altitude;
+    prev_altitude_[slot] = altitude;
+    target_altitude_[slot] = altitude;
+    vertical_rate_[slot] = 0.f;
+}
+
+void Fleet::SetTargetAltitude(size_t slot, float target_altitude) {
+    target_altitude_[slot] = std::clamp(target_altitude, 0.f, global_parameters::SIM_SERVICE_CEILING);
+}
+
+void Fleet::SetAngle(size_t slot, float angle) {
+    angle_[slot] = angle;
+    prev_angle_[slot] = angle;
+    RebuildRoute(slot);
+}
+
+void Fleet::SetSpeed(size_t slot, float speed) {
+    speed_[slot] = speed;
+    RebuildRoute(slot);
+}
+
+void Fleet::SetAngleSpeed(size_t slot, float angle_speed) {
+    angle_speed_[slot] = angle_speed;
+    RebuildRoute(slot);
+}
+
+bool Fleet::IsActive(size_t slot) const {
+    return active_[slot];
+}
+
+bool Fleet::IsTracking(size_t slot) const {
+    return tracking_[slot];
+}
+
+bool Fleet::IsRouted(size_t slot) const {
+    return routed_[slot];
+}
+
+const RouteTable& Fleet::GetRoutes() const {
+    return routes_;
+}
+
+sf::Vector2f Fleet::GetPosition(size_t slot) const {
+    return { x_[slot], y_[slot] };
+}
+
+sf::Vector2f Fleet::GetTargetPosition(size_t slot) const {
+    return { target_x_[slot], target_y_[slot] };
+}
+
+float Fleet::GetAltitude(size_t slot) const {
+    return altitude_[slot];
+}
+
+float Fleet::GetTargetAltitude(size_t slot) const {
+    return target_altitude_[slot];
+}
+
+float Fleet::GetVerticalRate(size_t slot) const {
+    return vertical_rate_[slot];
+}
+
+float Fleet::GetAngle(size_t slot) const {
+    return angle_[slot];
+}
+
+float Fleet::GetSpeed(size_t slot) const {
+    return speed_[slot];
+}
+
+float Fleet::GetAngleSpeed(size_t slot) const {
+    return angle_speed_[slot];
+}
+
+sf::Vector2f Fleet::GetWind(size_t slot) const {
+    return { wind_x_[slot], wind_y_[slot] };
+}
+
+void Fleet::CopyTo(FleetSnapshot& snapshot) const {
+    // assign переиспользует память снимка, поэтому после первых
+    // кадров копирование обходится без выделений
+    snapshot.x.assign(x_.begin(), x_.end());
+    snapshot.y.assign(y_.begin(), y_.end());
+    snapshot.angle.assign(angle_.begin(), angle_.end());
+    snapshot.prev_x.assign(prev_x_.begin(), prev_x_.end());
+    snapshot.prev_y.assign(prev_y_.begin(), prev_y_.end());
+    snapshot.prev_angle.assign(prev_angle_.begin(), prev_angle_.end());
+    snapshot.altitude.assign(altitude_.begin(), altitude_.end());
+    snapshot.prev_altitude.assign(prev_altitude_.begin(), prev_altitude_.end());
+    snapshot.vertical_rate.assign(vertical_rate_.begin(), vertical_rate_.end());
+    snapshot.active.assign(active_.begin(), active_.end());
+}
+
+void Fleet::SetScheduler(TaskScheduler* scheduler) {
+    scheduler_ = scheduler;
+}
+
+void Fleet::SetWindField(WindField* wind_field) {
+    wind_field_ = wind_field;
+}
+
+void Fleet::Step(float dt) {
+    SampleWind();
+
+    // Ядро двигает только слоты без маршрута
+    KinematicsView view = GetKinematicsView();
+    view.active = steered_.data();
+    const VerticalView vertical = GetVerticalView();
+
+    // Слоты независимы друг от друга, поэтому куски можно считать
+    // в любом порядке и в любом числе потоков
+    auto step_range = [&](size_t, size_t begin, size_t end) {
+        SavePreviousState(begin, end);
+        kernel_.Advance(view, begin, end, dt);
+        AdvanceRoutes(begin, end, dt);
+        AdvanceVertical(vertical, begin, end, dt);
+    };
+
+    if (scheduler_ != nullptr) {
+        scheduler_->ParallelFor(Size(), global_parameters::SIM_STEP_GRAIN, step_range);
+    }
+    else {
+        step_range(0, 0, Size());
+    }
+}
+
+void Fleet::StepReference(float dt) {
+    SampleWind();
+    SavePreviousState(0, Size());
+
+    for (size_t slot = 0; slot < x_.size(); ++slot) {
+        if (steered_[slot]) {
+            StepSlot(slot, dt);
+        }
+    }
+    AdvanceRoutes(0, Size(), dt);
+    AdvanceVertical(GetVerticalView(), 0, Size(), dt);
+}
+
+SteeringKernel& Fleet::GetKernel() {
+    return kernel_;
+}
+
+const SteeringKernel& Fleet::GetKernel() const {
+    return kernel_;
+}
+
+void Fleet::SaveState(StateWriter& writer) const {
+    writer.WriteVector(x_);
+    writer.WriteVector(y_);
+    writer.WriteVector(angle_);
+    writer.WriteVector(target_angle_);
+    writer.WriteVector(speed_);
+    writer.WriteVector(angle_speed_);
+    writer.WriteVector(target_x_);
+    writer.WriteVector(target_y_);
+    writer.WriteVector(tracking_);
+    writer.WriteVector(active_);
+    writer.WriteVector(altitude_);
+    writer.WriteVector(vertical_rate_);
+    writer.WriteVector(target_altitude_);
+    writer.WriteVector(wind_x_);
+    writer.WriteVector(wind_y_);
+    routes_.SaveState(writer);
+    writer.WriteVector(routed_);
+    writer.WriteVector(steered_);
+    writer.WriteVector(prev_x_);
+    writer.WriteVector(prev_y_);
+    writer.WriteVector(prev_angle_);
+    writer.WriteVector(prev_altitude_);
+}
+
+bool Fleet::LoadState(StateReader& reader) {
+    reader.ReadVector(x_);
+    reader.ReadVector(y_);
+    reader.ReadVector(angle_);
+    reader.ReadVector(target_angle_);
+    reader.ReadVector(speed_);
+    reader.ReadVector(angle_speed_);
+    reader.ReadVector(target_x_);
+    reader.ReadVector(target_y_);
+    reader.ReadVector(tracking_);
+    reader.ReadVector(active_);
+    reader.ReadVector(altitude_);
+    reader.ReadVector(vertical_rate_);
+    reader.ReadVector(target_altitude_);
+    reader.ReadVector(wind_x_);
+    reader.ReadVector(wind_y_);
+    const bool routes_loaded = routes_.LoadState(reader);
+    reader.ReadVector(routed_);
+    reader.ReadVector(steered_);
+    reader.ReadVector(prev_x_);
+    reader.ReadVector(prev_y_);
+    reader.ReadVector(prev_angle_);
+    reader.ReadVector(prev_altitude_);
+
+    // Все столбцы одной длины, иначе кадр испорчен
+    const size_t count = x_.size();
+    const bool sizes_match = y_.size() == count && angle_.size() == count && target_angle_.size() == count
+        && speed_.size() == count && angle_speed_.size() == count && target_x_.size() == count && target_y_.size() == count
+        && tracking_.size() == count && active_.size() == count && altitude_.size() == count && vertical_rate_.size() == count
+        && target_altitude_.size() == count && wind_x_.size() == count && wind_y_.size() == count && routes_.Size() == count
+        && routed_.size() == count && steered_.size() == count && prev_x_.size() == count && prev_y_.size() == count
+        && prev_angle_.size() == count && prev_altitude_.size() == count;
+    if (!reader.IsGood() || !routes_loaded || !sizes_match) {
+        return false;
+    }
+
+    // По координатам строятся сетки поиска конфликтов и ветра: NaN и
+    // огромные значения из испорченного кадра зациклили бы их построение
+    for (size_t slot = 0; slot < count; ++slot) {
+        if (active_[slot] && (!IsValidCoordinate(x_[slot]) || !IsValidCoordinate(y_[slot]) || !IsValidCoordinate(altitude_[slot]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+KinematicsView Fleet::GetKinematicsView() {
+    return { x_.data(), y_.data(), angle_.data(), target_angle_.data(),
+             speed_.data(), angle_speed_.data(), target_x_.data(), target_y_.data(),
+             tracking_.data(), active_.data(), wind_x_.data(), wind_y_.data()
+           };
+}
+
+VerticalView Fleet::GetVerticalView() {
+    return { altitude_.data(), vertical_rate_.data(), target_altitude_.data(), active_.data() };
+}
+
+void Fleet::SavePreviousState(size_t begin, size_t end) {
+    std::copy(x_.begin() + begin, x_.begin() + end, prev_x_.begin() + begin);
+    std::copy(y_.begin() + begin, y_.begin() + end, prev_y_.begin() + begin);
+    std::copy(angle_.begin() + begin, angle_.begin() + end, prev_angle_.begin() + begin);
+    std::copy(altitude_.begin() + begin, altitude_.begin() + end, prev_altitude_.begin() + begin);
+}
+
+void Fleet::SampleWind() {
+    if (wind_field_ != nullptr) {
+        wind_field_->Sample(x_.data(), y_.data(), altitude_.data(), active_.data(), Size(), wind_x_.data(), wind_y_.data());
+    }
+}
+
+void Fleet::AdvanceRoutes(size_t begin, size_t end, float dt) {
+    for (size_t slot = begin; slot < end; ++slot) {
+        if (!routed_[slot] || !active_[slot]) {
+            continue;
+        }
+
+        // Линия пути задана маршрутом, самолет держит ее с поправкой на
+        // снос и идет вдоль нее с путевой скоростью
+        const float ground_speed = GetGroundSpeedAlongTrack(speed_[slot], angle_[slot], GetWind(slot));
+
+        RoutePose pose;
+        if (!routes_.Advance(slot, ground_speed * dt, pose)) {
+            // Маршрут пройден: дальше прямо, под управлением ядра
+            routed_[slot] = 0;
+            steered_[slot] = 1;
+            target_angle_[slot] = pose.angle;
+        }
+        x_[slot] = pose.position.x;
+        y_[slot] = pose.position.y;
+        angle_[slot] = pose.angle;
+    }
+}
+
+void Fleet::RebuildRoute(size_t slot) {
+    if (routed_[slot]) {
+        routes_.Rebuild(slot, { { x_[slot], y_[slot] }, angle_[slot] }, speed_[slot], angle_speed_[slot]);
+        routed_[slot] = routes_.IsActive(slot);
+        UpdateSteered(slot);
+    }
+}
+
+void Fleet::UpdateSteered(size_t slot) {
+    steered_[slot] = active_[slot] && !routed_[slot];
+}
+
+// Закон управления, ранее находившийся в Plane::Control()
+void Fleet::StepSlot(size_t slot, float scale) {
+    const float speed = speed_[slot] * scale;
+    const float angle_speed = angle_speed_[slot] * scale;
+    float& angle = angle_[slot];
+    float& target_angle = target_angle_[slot];
+
+    sf::Vector2f direction;
+
+    if (tracking_[slot]) {
+        direction = sf::Vector2f(target_x_[slot] - x_[slot], target_y_[slot] - y_[slot]);
+        if (direction.x > 0) {
+            target_angle = asin(direction.y / sqrt(pow(direction.x, 2) + pow(direction.y, 2)));
+        }
+        else {
+            target_angle = M_PI - asin(direction.y / sqrt(pow(direction.x, 2) + pow(direction.y, 2)));
+        }
+
+        // Поправка на угол сноса
+        const float drift_scale = sqrt(pow(direction.x, 2) + pow(direction.y, 2)) * speed_[slot];
+        if (drift_scale > 0) {
+            const float drift = (wind_y_[slot] * direction.x - wind_x_[slot] * direction.y) / drift_scale;
+            target_angle -= asin(std::min(std::max(drift, -1.f), 1.f));
+        }
+    }
+
+    if (target_angle - angle > 2 * M_PI) {
+        angle += 2 * M_PI;
+    }
+
+    if (angle - target_angle > 2 * M_PI) {
+        angle -= 2 * M_PI;
+    }
+
+    if (angle - target_angle > 1.1 * angle_speed || angle - target_angle < -1.1 * angle_speed) {
+        if ((sqrt(pow(direction.x, 2) + pow(direction.y, 2)) > 4 * speed / 2 / cos(M_PI / 2 - angle_speed)) || (target_angle - angle < M_PI / 2 && target_angle - angle > -M_PI / 2) || target_angle - angle < -M_PI * 3 / 4 || target_angle - angle > M_PI * 3 / 4) {
+            if ((target_angle - angle > 0 && target_angle - angle < M_PI) || (target_angle - angle < -M_PI)) {
+                angle += angle_speed;
+            }
+            else {
+                angle -= angle_speed;
+            }
+        }
+    }
+
+    if (sqrt(pow(direction.x, 2) + pow(direction.y, 2)) < 5 * speed) {
+        tracking_[slot] = 0;
+    }
+
+    x_[slot] += speed * cos(angle) + wind_x_[slot] * scale;
+    y_[slot] += speed * sin(angle) + wind_y_[slot] * scale;
+}
+
+} // namespace sim
\ No newline at end of file
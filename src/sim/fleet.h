@@ -0,0 +1,186 @@
+#pragma once
+
+#include "../global_parameters.h"
+#include "fleet_snapshot.h"
+#include "kinematics.h"
+#include "route_table.h"
+#include "state_io.h"
+#include "task_scheduler.h"
+#include "vertical_profile.h"
+#include "wind_field.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <SFML/System/Vector2.hpp>
+
+/*
+   Fleet хранит кинематическое состояние всех самолетов в виде
+   структуры массивов (structure-of-arrays): каждое поле лежит в
+   своем непрерывном массиве, а самолет - это просто индекс (слот).
+   За один вызов Step(dt) продвигаются все активные слоты, поэтому
+   стоимость кадра определяется пропускной способностью памяти,
+   а не копированием отдельных объектов.
+
+   Самолет с маршрутом (RouteTable) не проходит через ядро управления:
+   его геометрия посчитана заранее, и шаг только продвигает его вдоль
+   текущего участка. После последней точки маршрута самолет летит
+   прямо, снова под управлением ядра.
+
+   Высота меняется отдельно от горизонтального движения, по
+   вертикальному профилю (AdvanceVertical) для всех активных слотов.
+
+   Если задано поле ветра (SetWindField), перед шагом каждый слот
+   получает ветер своей ячейки в столбцы wind_x_, wind_y_, и ядро
+   учитывает снос.
+*/
+
+namespace sim {
+
+class Fleet {
+public:
+    Fleet() = default;
+
+    size_t Add(const sf::Vector2f& position, float angle = 0.f, float altitude = global_parameters::PLANE_INITIAL_ALTITUDE);
+
+    void Reserve(size_t capacity);
+
+    void Clear();
+
+    size_t Size() const;
+
+    void SetActive(size_t slot, bool active);
+
+    void SetPosition(size_t slot, const sf::Vector2f& position);
+
+    // Прямой полет на точку, маршрут слота при этом сбрасывается
+    void SetTargetPosition(size_t slot, const sf::Vector2f& target_position);
+
+    // Добавляет точку в конец маршрута слота
+    void AddWaypoint(size_t slot, const Waypoint& waypoint);
+
+    void ClearRoute(size_t slot);
+
+    // Переносит самолет на высоту altitude и оставляет его на ней
+    void SetAltitude(size_t slot, float altitude);
+
+    // Набор или снижение к высоте, обрезанной потолком
+    void SetTargetAltitude(size_t slot, float target_altitude);
+
+    void SetAngle(size_t slot, float angle);
+
+    void SetSpeed(size_t slot, float speed);
+
+    void SetAngleSpeed(size_t slot, float angle_speed);
+
+    bool IsActive(size_t slot) const;
+
+    bool IsTracking(size_t slot) const;
+
+    bool IsRouted(size_t slot) const;
+
+    const RouteTable& GetRoutes() const;
+
+    sf::Vector2f GetPosition(size_t slot) const;
+
+    sf::Vector2f GetTargetPosition(size_t slot) const;
+
+    float GetAltitude(size_t slot) const;
+
+    float GetTargetAltitude(size_t slot) const;
+
+    float GetVerticalRate(size_t slot) const;
+
+    float GetAngle(size_t slot) const;
+
+    float GetSpeed(size_t slot) const;
+
+    float GetAngleSpeed(size_t slot) const;
+
+    // Ветер, с которым слот сделал последний шаг
+    sf::Vector2f GetWind(size_t slot) const;
+
+    // Копирует текущее и предыдущее состояние в снимок для интерфейса
+    void CopyTo(FleetSnapshot& snapshot) const;
+
+    // Планировщик для параллельного шага, nullptr - шаг в текущем потоке
+    void SetScheduler(TaskScheduler* scheduler);
+
+    // Поле ветра, nullptr - штиль
+    void SetWindField(WindField* wind_field);
+
+    // Продвигает все активные самолеты на dt секунд пакетным ядром
+    void Step(float dt);
+
+    // То же самое исходным скалярным законом управления. Эталон,
+    // с которым сверяются пакетные ядра
+    void StepReference(float dt);
+
+    SteeringKernel& GetKernel();
+
+    const SteeringKernel& GetKernel() const;
+
+    // Все столбцы и маршруты в опорный кадр записи сеанса и обратно.
+    // Ядро, планировщик и поле ветра не меняются
+    void SaveState(StateWriter& writer) const;
+
+    bool LoadState(StateReader& reader);
+
+    KinematicsView GetKinematicsView();
+
+    VerticalView GetVerticalView();
+
+private:
+    void StepSlot(size_t slot, float scale);
+
+    void SavePreviousState(size_t begin, size_t end);
+
+    // Обновляет ветер слотов из поля ветра, если оно задано
+    void SampleWind();
+
+    // Продвигает самолеты на маршрутах из [begin, end) на dt секунд
+    void AdvanceRoutes(size_t begin, size_t end, float dt);
+
+    // Пересчитывает геометрию маршрута от текущего состояния слота
+    void RebuildRoute(size_t slot);
+
+    // Флаг для ядра: слот активен и летит не по маршруту
+    void UpdateSteered(size_t slot);
+
+private:
+    SteeringKernel kernel_;
+    TaskScheduler* scheduler_ = nullptr;
+    WindField* wind_field_ = nullptr;
+
+    std::vector<float> x_;
+    std::vector<float> y_;
+    std::vector<float> angle_;
+    std::vector<float> target_angle_;
+    std::vector<float> speed_;
+    std::vector<float> angle_speed_;
+    std::vector<float> target_x_;
+    std::vector<float> target_y_;
+    std::vector<uint8_t> tracking_;
+    std::vector<uint8_t> active_;
+
+    // Высота, метры, и вертикальная скорость, м/с
+    std::vector<float> altitude_;
+    std::vector<float> vertical_rate_;
+    std::vector<float> target_altitude_;
+
+    // Ветер в ячейке слота, м/с
+    std::vector<float> wind_x_;
+    std::vector<float> wind_y_;
+
+    RouteTable routes_;
+    std::vector<uint8_t> routed_;
+    std::vector<uint8_t> steered_;
+
+    // Состояние до последнего шага, нужно для интерполяции при отрисовке
+    std::vector<float> prev_x_;
+    std::vector<float> prev_y_;
+    std::vector<float> prev_angle_;
+    std::vector<float> prev_altitude_;
+};
+
+} // namespace sim
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include "fleet_snapshot.h"
+
+#include <cmath>
+
+namespace sim {
+
+size_t FleetSnapshot::Size() const {
+    return x.size();
+}
+
+float FleetSnapshot::GetAlpha() const {
+    if (step_real_seconds <= 0.f) {
+        return 1.f;
+    }
+
+    const std::chrono::duration<float> elapsed = std::chrono::steady_clock::now() - published_at;
+    const float current = alpha + elapsed.count() / step_real_seconds;
+    return current < 1.f ? current : 1.f;
+}
+
+sf::Vector2f FleetSnapshot::GetInterpolatedPosition(size_t slot, float alpha) const {
+    return { prev_x[slot] + (x[slot] - prev_x[slot]) * alpha,
+             prev_y[slot] + (y[slot] - prev_y[slot]) * alpha
+           };
+}
+
+float FleetSnapshot::GetInterpolatedAngle(size_t slot, float alpha) const {
+    // Угол мог перескочить на оборот, интерполируем по кратчайшей дуге
+    const float delta = std::remainder(angle[slot] - prev_angle[slot], 2 * static_cast<float>(M_PI));
+    return prev_angle[slot] + delta * alpha;
+}
+
+float FleetSnapshot::GetInterpolatedAltitude(size_t slot, float alpha) const {
+    return prev_altitude[slot] + (altitude[slot] - prev_altitude[slot]) * alpha;
+}
+
+} // namespace sim
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include <SFML/System/Vector2.hpp>
+
+/*
+   Снимок состояния Fleet, который поток симуляции публикует
+   для интерфейса. Кроме текущего и предыдущего состояния хранит
+   долю шага на момент публикации, чтобы интерфейс мог
+   интерполировать положение самолетов по реальному времени, и
+   конфликты, найденные на последнем шаге и по прогнозу.
+*/
+
+namespace sim {
+
+// Пара самолетов ближе допустимых горизонтального и вертикального
+// интервалов, first < second
+struct Conflict {
+    uint32_t first;
+    uint32_t second;
+    float distance;
+    float vertical_distance;
+};
+
+// Ожидаемый конфликт по прогнозу: через time секунд после поиска
+// интервалы будут нарушены, а самолеты сблизятся до distance по
+// горизонтали и vertical_distance по высоте
+struct PredictedConflict {
+    uint32_t first;
+    uint32_t second;
+    float time;
+    float distance;
+    float vertical_distance;
+};
+
+struct FleetSnapshot {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> angle;
+    std::vector<float> prev_x;
+    std::vector<float> prev_y;
+    std::vector<float> prev_angle;
+    std::vector<float> altitude;
+    std::vector<float> prev_altitude;
+    std::vector<float> vertical_rate;
+    std::vector<uint8_t> active;
+
+    // Результат ConflictAlert на момент публикации
+    std::vector<uint8_t> conflict;
+    std::vector<Conflict> conflicts;
+
+    // Результат ConflictProbe на момент последнего поиска по прогнозу
+    std::vector<uint8_t> predicted_conflict;
+    std::vector<PredictedConflict> predicted_conflicts;
+
+    uint64_t tick = 0;
+    double sim_time = 0.;
+
+    // Доля шага на момент публикации и длина шага в реальном времени
+    float alpha = 0.f;
+    float step_real_seconds = 0.f;
+    std::chrono::steady_clock::time_point published_at;
+
+    size_t Size() const;
+
+    // Доля шага на текущий момент, [0, 1]
+    float GetAlpha() const;
+
+    sf::Vector2f GetInterpolatedPosition(size_t slot, float alpha) const;
+
+    float GetInterpolatedAngle(size_t slot, float alpha) const;
+
+    float GetInterpolatedAltitude(size_t slot, float alpha) const;
+};
+
+} // namespace sim
\ No newline at end of file
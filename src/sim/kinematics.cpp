@@ -0,0 +1,49 @@
+#include "kinematics.h"
+#include "kinematics_impl.h"
+
+namespace sim {
+
+void AdvanceScalar(const KinematicsView& view, size_t begin, size_t end, float scale) {
+    AdvanceRange<ScalarLanes>(view, begin, end, scale);
+}
+
+SteeringKernel::SteeringKernel()
+    : instruction_set_(DetectInstructionSet()) {
+}
+
+InstructionSet SteeringKernel::GetInstructionSet() const {
+    return instruction_set_;
+}
+
+void SteeringKernel::SetInstructionSet(InstructionSet instruction_set) {
+    const InstructionSet supported = DetectInstructionSet();
+    instruction_set_ = static_cast<int>(instruction_set) > static_cast<int>(supported) ? supported : instruction_set;
+}
+
+void SteeringKernel::Advance(const KinematicsView& view, size_t begin, size_t end, float scale) const {
+    switch (instruction_set_) {
+        case InstructionSet::AVX2:
+            AdvanceAvx2(view, begin, end, scale);
+            break;
+        case InstructionSet::SSE41:
+            AdvanceSse41(view, begin, end, scale);
+            break;
+        case InstructionSet::SCALAR:
+            AdvanceScalar(view, begin, end, scale);
+            break;
+    }
+}
+
+InstructionSet SteeringKernel::DetectInstructionSet() {
+#if defined(SIM_KINEMATICS_X86) && defined(__GNUC__)
+    if (__builtin_cpu_supports("avx2")) {
+        return InstructionSet::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return InstructionSet::SSE41;
+    }
+#endif
+    return InstructionSet::SCALAR;
+}
+
+} // namespace sim
\ No newline at end of file
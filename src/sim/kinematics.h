@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+   Пакетное ядро закона управления самолетом (бывший Plane::Control()).
+   Ядро работает над массивами Fleet и обрабатывает по 8 (AVX2),
+   4 (SSE4.1) или 1 (скалярная ветка) самолету за инструкцию.
+   Набор инструкций выбирается один раз при запуске программы.
+
+   По сравнению со скалярным законом курс на цель считается через
+   atan2 вместо asin и трех sqrt(pow(...)), перенос угла на оборот
+   и выбор стороны поворота сделаны без ветвлений (через маски),
+   а проверки дистанции идут по квадрату расстояния. Все три
+   ветки используют одни и те же полиномы и одинаковый порядок
+   операций, поэтому дают побитово одинаковый результат.
+
+   Ветер (столбцы wind_x, wind_y, м/с) сносит самолет, а при полете на
+   цель ядро доворачивает курс на угол сноса, чтобы путевая линия
+   шла на цель.
+
+   Этот заголовок подключается в единицы трансляции, собранные
+   с -mavx2 / -msse4.1, поэтому здесь не должно быть ничего,
+   кроме объявлений.
+*/
+
+namespace sim {
+
+// Указатели на столбцы Fleet, которые читает и пишет ядро
+struct KinematicsView {
+    float* x;
+    float* y;
+    float* angle;
+    float* target_angle;
+    const float* speed;
+    const float* angle_speed;
+    const float* target_x;
+    const float* target_y;
+    uint8_t* tracking;
+    const uint8_t* active;
+    const float* wind_x;
+    const float* wind_y;
+};
+
+enum class InstructionSet {
+    SCALAR,
+    SSE41,
+    AVX2
+};
+
+class SteeringKernel {
+public:
+    // Выбирает лучший набор инструкций, который поддерживает процессор
+    SteeringKernel();
+
+    InstructionSet GetInstructionSet() const;
+
+    // Принудительно выбирает набор инструкций (не выше поддерживаемого)
+    void SetInstructionSet(InstructionSet instruction_set);
+
+    // Продвигает слоты [begin, end) на scale секунд
+    void Advance(const KinematicsView& view, size_t begin, size_t end, float scale) const;
+
+    static InstructionSet DetectInstructionSet();
+
+private:
+    InstructionSet instruction_set_;
+};
+
+// Реализации для конкретных наборов инструкций (kinematics_*.cpp)
+void AdvanceScalar(const KinematicsView& view, size_t begin, size_t end, float scale);
+void AdvanceSse41(const KinematicsView& view, size_t begin, size_t end, float scale);
+void AdvanceAvx2(const KinematicsView& view, size_t begin, size_t end, float scale);
+
+} // namespace sim
\ No newline at end of file
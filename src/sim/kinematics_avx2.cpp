@@ -0,0 +1,68 @@
+#include "kinematics_impl.h"
+
+// Файл собирается с -mavx2 (см. CMakeLists.txt)
+#if defined(SIM_KINEMATICS_X86)
+
+#include <immintrin.h>
+
+namespace sim {
+
+namespace {
+
+struct Avx2Lanes {
+    using V = __m256;
+    using M = __m256;
+
+    static constexpr size_t WIDTH = 8;
+
+    static V Load(const float* p) { return _mm256_loadu_ps(p); }
+    static void Store(float* p, V v) { _mm256_storeu_ps(p, v); }
+    static V Set(float v) { return _mm256_set1_ps(v); }
+
+    static M LoadMask(const uint8_t* p) {
+        const __m256i bytes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+        return _mm256_castsi256_ps(_mm256_cmpgt_epi32(bytes, _mm256_setzero_si256()));
+    }
+
+    static void StoreMask(uint8_t* p, M m) {
+        const int bits = _mm256_movemask_ps(m);
+        for (int lane = 0; lane < 8; ++lane) {
+            p[lane] = (bits >> lane) & 1;
+        }
+    }
+
+    static V Add(V a, V b) { return _mm256_add_ps(a, b); }
+    static V Sub(V a, V b) { return _mm256_sub_ps(a, b); }
+    static V Mul(V a, V b) { return _mm256_mul_ps(a, b); }
+    static V Div(V a, V b) { return _mm256_div_ps(a, b); }
+    static V Abs(V a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a); }
+    static V Sqrt(V a) { return _mm256_sqrt_ps(a); }
+
+    static M Less(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static M Greater(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static M And(M a, M b) { return _mm256_and_ps(a, b); }
+    static M AndNot(M a, M b) { return _mm256_andnot_ps(a, b); }
+    static M Or(M a, M b) { return _mm256_or_ps(a, b); }
+
+    static V Select(M m, V a, V b) { return _mm256_blendv_ps(b, a, m); }
+};
+
+} // namespace
+
+void AdvanceAvx2(const KinematicsView& view, size_t begin, size_t end, float scale) {
+    AdvanceRange<Avx2Lanes>(view, begin, end, scale);
+}
+
+} // namespace sim
+
+#else
+
+namespace sim {
+
+void AdvanceAvx2(const KinematicsView& view, size_t begin, size_t end, float scale) {
+    AdvanceScalar(view, begin, end, scale);
+}
+
+} // namespace sim
+
+#endif
\ No newline at end of file
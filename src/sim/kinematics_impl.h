@@ -0,0 +1,275 @@
+#pragma once
+
+#include "kinematics.h"
+
+/*
+   Общая реализация закона управления, параметризованная набором
+   "дорожек" (Lanes): скалярной, SSE4.1 или AVX2. Подключается только
+   в kinematics_*.cpp.
+
+   Все функции лежат в анонимном пространстве имен, а из стандартной
+   библиотеки ничего не используется: единицы трансляции собираются
+   с разными флагами (-mavx2, -msse4.1), и любая общая inline-функция
+   могла бы при линковке достаться остальной программе в AVX-варианте.
+*/
+
+namespace sim {
+
+namespace {
+
+constexpr float KINEMATICS_PI = 3.14159265358979f;
+constexpr float KINEMATICS_TWO_PI = 6.28318530717959f;
+constexpr float KINEMATICS_HALF_PI = 1.57079632679490f;
+constexpr float KINEMATICS_QUARTER_PI = 0.78539816339745f;
+constexpr float KINEMATICS_THREE_QUARTER_PI = 2.35619449019234f;
+constexpr float KINEMATICS_INV_TWO_PI = 0.15915494309190f;
+constexpr float KINEMATICS_TWO_OVER_PI = 0.63661977236758f;
+
+// 2pi и pi/2, разложенные на две части (Cody-Waite), чтобы
+// вычитание при приведении аргумента не теряло точность
+constexpr float KINEMATICS_TWO_PI_HI = 6.28125f;
+constexpr float KINEMATICS_TWO_PI_LO = 1.9353071795864769e-3f;
+constexpr float KINEMATICS_HALF_PI_HI = 1.5703125f;
+constexpr float KINEMATICS_HALF_PI_LO = 4.8382679489661923e-4f;
+
+constexpr float KINEMATICS_TAN_PI_8 = 0.41421356237310f;
+
+// Сложение и вычитание 1.5 * 2^23 округляет к ближайшему четному
+// одинаково во всех ветках, без инструкций округления
+constexpr float KINEMATICS_ROUND_MAGIC = 12582912.f;
+
+// Коэффициенты полиномов из Cephes (atanf, sinf, cosf)
+constexpr float ATAN_P0 = 8.05374449538e-2f;
+constexpr float ATAN_P1 = -1.38776856032e-1f;
+constexpr float ATAN_P2 = 1.99777106478e-1f;
+constexpr float ATAN_P3 = -3.33329491539e-1f;
+
+constexpr float SIN_P0 = -1.9515295891e-4f;
+constexpr float SIN_P1 = 8.3321608736e-3f;
+constexpr float SIN_P2 = -1.6666654611e-1f;
+
+constexpr float COS_P0 = 2.443315711809948e-5f;
+constexpr float COS_P1 = -1.388731625493765e-3f;
+constexpr float COS_P2 = 4.166664568298827e-2f;
+
+// Скалярные "дорожки": одна самолето-позиция за раз
+struct ScalarLanes {
+    using V = float;
+    using M = bool;
+
+    static constexpr size_t WIDTH = 1;
+
+    static V Load(const float* p) { return *p; }
+    static void Store(float* p, V v) { *p = v; }
+    static V Set(float v) { return v; }
+
+    static M LoadMask(const uint8_t* p) { return *p != 0; }
+    static void StoreMask(uint8_t* p, M m) { *p = m ? 1 : 0; }
+
+    static V Add(V a, V b) { return a + b; }
+    static V Sub(V a, V b) { return a - b; }
+    static V Mul(V a, V b) { return a * b; }
+    static V Div(V a, V b) { return a / b; }
+    static V Abs(V a) { return __builtin_fabsf(a); }
+    static V Sqrt(V a) { return __builtin_sqrtf(a); }
+
+    static M Less(V a, V b) { return a < b; }
+    static M Greater(V a, V b) { return a > b; }
+    static M And(M a, M b) { return a && b; }
+    static M AndNot(M a, M b) { return !a && b; }
+    static M Or(M a, M b) { return a || b; }
+
+    static V Select(M m, V a, V b) { return m ? a : b; }
+};
+
+template <class L>
+typename L::V Round(typename L::V a) {
+    const typename L::V magic = L::Set(KINEMATICS_ROUND_MAGIC);
+    return L::Sub(L::Add(a, magic), magic);
+}
+
+// Заворачивает угол в [-pi, pi]
+template <class L>
+typename L::V WrapAngle(typename L::V a) {
+    const typename L::V turns = Round<L>(L::Mul(a, L::Set(KINEMATICS_INV_TWO_PI)));
+    a = L::Sub(a, L::Mul(turns, L::Set(KINEMATICS_TWO_PI_HI)));
+    return L::Sub(a, L::Mul(turns, L::Set(KINEMATICS_TWO_PI_LO)));
+}
+
+// atan2 через atan(min/max) на [0, 1] и восстановление октанта
+template <class L>
+typename L::V Atan2(typename L::V y, typename L::V x) {
+    using V = typename L::V;
+    using M = typename L::M;
+
+    const V zero = L::Set(0.f);
+    const V one = L::Set(1.f);
+    const V ax = L::Abs(x);
+    const V ay = L::Abs(y);
+
+    const M y_dominates = L::Greater(ay, ax);
+    const V numerator = L::Select(y_dominates, ax, ay);
+    const V denominator = L::Select(y_dominates, ay, ax);
+    const M degenerate = L::Less(denominator, L::Set(1e-30f));
+    const V t = L::Select(degenerate, zero, L::Div(numerator, L::Select(degenerate, one, denominator)));
+
+    const M reduce = L::Greater(t, L::Set(KINEMATICS_TAN_PI_8));
+    const V u = L::Select(reduce, L::Div(L::Sub(t, one), L::Add(t, one)), t);
+    const V base = L::Select(reduce, L::Set(KINEMATICS_QUARTER_PI), zero);
+
+    const V z = L::Mul(u, u);
+    V poly = L::Add(L::Mul(L::Set(ATAN_P0), z), L::Set(ATAN_P1));
+    poly = L::Add(L::Mul(poly, z), L::Set(ATAN_P2));
+    poly = L::Add(L::Mul(poly, z), L::Set(ATAN_P3));
+    V result = L::Add(base, L::Add(L::Mul(L::Mul(poly, z), u), u));
+
+    result = L::Select(y_dominates, L::Sub(L::Set(KINEMATICS_HALF_PI), result), result);
+    result = L::Select(L::Less(x, zero), L::Sub(L::Set(KINEMATICS_PI), result), result);
+    return L::Select(L::Less(y, zero), L::Sub(zero, result), result);
+}
+
+// sin и cos для угла из [-pi, pi]: приведение к [-pi/4, pi/4] по квадрантам
+template <class L>
+void SinCos(typename L::V a, typename L::V& sin_out, typename L::V& cos_out) {
+    using V = typename L::V;
+    using M = typename L::M;
+
+    const V zero = L::Set(0.f);
+    const V quadrant = Round<L>(L::Mul(a, L::Set(KINEMATICS_TWO_OVER_PI)));
+    V r = L::Sub(a, L::Mul(quadrant, L::Set(KINEMATICS_HALF_PI_HI)));
+    r = L::Sub(r, L::Mul(quadrant, L::Set(KINEMATICS_HALF_PI_LO)));
+
+    const V z = L::Mul(r, r);
+
+    V sin_poly = L::Add(L::Mul(L::Set(SIN_P0), z), L::Set(SIN_P1));
+    sin_poly = L::Add(L::Mul(sin_poly, z), L::Set(SIN_P2));
+    const V sin_r = L::Add(L::Mul(L::Mul(sin_poly, z), r), r);
+
+    V cos_poly = L::Add(L::Mul(L::Set(COS_P0), z), L::Set(COS_P1));
+    cos_poly = L::Add(L::Mul(cos_poly, z), L::Set(COS_P2));
+    const V cos_r = L::Add(L::Sub(L::Set(1.f), L::Mul(z, L::Set(0.5f))), L::Mul(L::Mul(cos_poly, z), z));
+
+    // quadrant принимает значения -2..2: квадранты 1 и -1 меняют
+    // sin и cos местами, знаки зависят от конкретного квадранта
+    const V abs_quadrant = L::Abs(quadrant);
+    const M is_one = L::Less(L::Abs(L::Sub(quadrant, L::Set(1.f))), L::Set(0.5f));
+    const M is_minus_one = L::Less(L::Abs(L::Add(quadrant, L::Set(1.f))), L::Set(0.5f));
+    const M is_two = L::Greater(abs_quadrant, L::Set(1.5f));
+
+    // q = 0:  ( sin_r,  cos_r)
+    // q = 1:  ( cos_r, -sin_r)
+    // q = -1: (-cos_r,  sin_r)
+    // q = +-2: (-sin_r, -cos_r)
+    V s = L::Select(is_one, cos_r, sin_r);
+    V c = L::Select(is_one, L::Sub(zero, sin_r), cos_r);
+    s = L::Select(is_minus_one, L::Sub(zero, cos_r), s);
+    c = L::Select(is_minus_one, sin_r, c);
+    s = L::Select(is_two, L::Sub(zero, sin_r), s);
+    c = L::Select(is_two, L::Sub(zero, cos_r), c);
+
+    sin_out = s;
+    cos_out = c;
+}
+
+template <class L>
+void AdvanceLanes(const KinematicsView& view, size_t i, float scale) {
+    using V = typename L::V;
+    using M = typename L::M;
+
+    const V zero = L::Set(0.f);
+    const V step_scale = L::Set(scale);
+
+    const M active = L::LoadMask(view.active + i);
+    M tracking = L::LoadMask(view.tracking + i);
+
+    const V two_pi = L::Set(KINEMATICS_TWO_PI);
+
+    const V x = L::Load(view.x + i);
+    const V y = L::Load(view.y + i);
+    const V old_angle = L::Load(view.angle + i);
+    V angle = old_angle;
+    V target_angle = L::Load(view.target_angle + i);
+    const V speed = L::Mul(L::Load(view.speed + i), step_scale);
+    const V angle_speed = L::Mul(L::Load(view.angle_speed + i), step_scale);
+
+    const V wind_x = L::Load(view.wind_x + i);
+    const V wind_y = L::Load(view.wind_y + i);
+
+    // Без активной цели направление считается нулевым, как и раньше
+    const V dx = L::Select(tracking, L::Sub(L::Load(view.target_x + i), x), zero);
+    const V dy = L::Select(tracking, L::Sub(L::Load(view.target_y + i), y), zero);
+    const V distance2 = L::Add(L::Mul(dx, dx), L::Mul(dy, dy));
+
+    // Курс на цель в тех же границах [-pi/2, 3pi/2], что давала
+    // исходная формула через asin
+    const V heading = Atan2<L>(dy, dx);
+    const M lower_half = L::AndNot(L::Greater(dx, zero), L::Less(heading, zero));
+
+    // Поправка на ветер: боковая составляющая ветра, деленная на
+    // воздушную скорость, - синус угла сноса. Самолет держит курс
+    // heading - asin(...), чтобы путевая линия шла точно на цель.
+    // asin(r) = atan2(r, sqrt(1 - r^2)); если ветер сильнее самолета,
+    // угол упирается в pi/2
+    const V one = L::Set(1.f);
+    const V cross_wind = L::Sub(L::Mul(wind_y, dx), L::Mul(wind_x, dy));
+    const V drift_scale = L::Mul(L::Sqrt(distance2), L::Load(view.speed + i));
+    const M no_drift = L::Less(drift_scale, L::Set(1e-30f));
+    V drift = L::Select(no_drift, zero, L::Div(cross_wind, L::Select(no_drift, one, drift_scale)));
+    drift = L::Select(L::Greater(drift, one), one, drift);
+    drift = L::Select(L::Less(drift, L::Sub(zero, one)), L::Sub(zero, one), drift);
+    const V drift_angle = Atan2<L>(drift, L::Sqrt(L::Sub(one, L::Mul(drift, drift))));
+
+    const V course = L::Sub(L::Select(lower_half, L::Add(heading, two_pi), heading), drift_angle);
+    target_angle = L::Select(tracking, course, target_angle);
+
+    // Перенос угла на оборот, если он ушел от цели дальше чем на 2pi
+    angle = L::Add(angle, L::Select(L::Greater(L::Sub(target_angle, angle), two_pi), two_pi, zero));
+    angle = L::Sub(angle, L::Select(L::Greater(L::Sub(angle, target_angle), two_pi), two_pi, zero));
+
+    const V error = L::Sub(target_angle, angle);
+    const V abs_error = L::Abs(error);
+
+    // Не доворачиваем, если цель близко и лежит на траверзе:
+    // иначе самолет начнет кружить вокруг нее
+    V sin_w;
+    V cos_w;
+    SinCos<L>(angle_speed, sin_w, cos_w);
+    const V speed2 = L::Mul(speed, speed);
+    const M far = L::Greater(L::Mul(distance2, L::Mul(sin_w, sin_w)), L::Mul(L::Set(4.f), speed2));
+    const M allow = L::Or(far, L::Or(L::Less(abs_error, L::Set(KINEMATICS_HALF_PI)), L::Greater(abs_error, L::Set(KINEMATICS_THREE_QUARTER_PI))));
+    const M turn = L::And(L::Greater(abs_error, L::Mul(L::Set(1.1f), angle_speed)), allow);
+
+    // Поворот в сторону кратчайшего доворота
+    const V pi = L::Set(KINEMATICS_PI);
+    const M positive = L::Or(L::And(L::Greater(error, zero), L::Less(error, pi)), L::Less(error, L::Sub(zero, pi)));
+    const V signed_turn = L::Select(positive, angle_speed, L::Sub(zero, angle_speed));
+    const V new_angle = L::Add(angle, L::Select(turn, signed_turn, zero));
+
+    tracking = L::AndNot(L::Less(distance2, L::Mul(L::Set(25.f), speed2)), tracking);
+
+    V sin_a;
+    V cos_a;
+    SinCos<L>(WrapAngle<L>(new_angle), sin_a, cos_a);
+
+    // Путевая скорость - воздушная плюс ветер
+    L::Store(view.x + i, L::Select(active, L::Add(x, L::Add(L::Mul(speed, cos_a), L::Mul(wind_x, step_scale))), x));
+    L::Store(view.y + i, L::Select(active, L::Add(y, L::Add(L::Mul(speed, sin_a), L::Mul(wind_y, step_scale))), y));
+    L::Store(view.angle + i, L::Select(active, new_angle, old_angle));
+    L::Store(view.target_angle + i, L::Select(active, target_angle, L::Load(view.target_angle + i)));
+    L::StoreMask(view.tracking + i, L::Or(L::AndNot(active, L::LoadMask(view.tracking + i)), L::And(active, tracking)));
+}
+
+template <class L>
+void AdvanceRange(const KinematicsView& view, size_t begin, size_t end, float scale) {
+    size_t i = begin;
+    for (; i + L::WIDTH <= end; i += L::WIDTH) {
+        AdvanceLanes<L>(view, i, scale);
+    }
+    for (; i < end; ++i) {
+        AdvanceLanes<ScalarLanes>(view, i, scale);
+    }
+}
+
+} // namespace
+
+} // namespace sim
\ No newline at end of file
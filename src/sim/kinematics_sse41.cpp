@@ -0,0 +1,71 @@
+#include "kinematics_impl.h"
+
+// Файл собирается с -msse4.1 (см. CMakeLists.txt)
+#if defined(SIM_KINEMATICS_X86)
+
+#include <cstring>
+#include <smmintrin.h>
+
+namespace sim {
+
+namespace {
+
+struct Sse41Lanes {
+    using V = __m128;
+    using M = __m128;
+
+    static constexpr size_t WIDTH = 4;
+
+    static V Load(const float* p) { return _mm_loadu_ps(p); }
+    static void Store(float* p, V v) { _mm_storeu_ps(p, v); }
+    static V Set(float v) { return _mm_set1_ps(v); }
+
+    static M LoadMask(const uint8_t* p) {
+        int packed;
+        std::memcpy(&packed, p, sizeof(packed));
+        const __m128i bytes = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed));
+        return _mm_castsi128_ps(_mm_cmpgt_epi32(bytes, _mm_setzero_si128()));
+    }
+
+    static void StoreMask(uint8_t* p, M m) {
+        const int bits = _mm_movemask_ps(m);
+        for (int lane = 0; lane < 4; ++lane) {
+            p[lane] = (bits >> lane) & 1;
+        }
+    }
+
+    static V Add(V a, V b) { return _mm_add_ps(a, b); }
+    static V Sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static V Mul(V a, V b) { return _mm_mul_ps(a, b); }
+    static V Div(V a, V b) { return _mm_div_ps(a, b); }
+    static V Abs(V a) { return _mm_andnot_ps(_mm_set1_ps(-0.f), a); }
+    static V Sqrt(V a) { return _mm_sqrt_ps(a); }
+
+    static M Less(V a, V b) { return _mm_cmplt_ps(a, b); }
+    static M Greater(V a, V b) { return _mm_cmpgt_ps(a, b); }
+    static M And(M a, M b) { return _mm_and_ps(a, b); }
+    static M AndNot(M a, M b) { return _mm_andnot_ps(a, b); }
+    static M Or(M a, M b) { return _mm_or_ps(a, b); }
+
+    static V Select(M m, V a, V b) { return _mm_blendv_ps(b, a, m); }
+};
+
+} // namespace
+
+void AdvanceSse41(const KinematicsView& view, size_t begin, size_t end, float scale) {
+    AdvanceRange<Sse41Lanes>(view, begin, end, scale);
+}
+
+} // namespace sim
+
+#else
+
+namespace sim {
+
+void AdvanceSse41(const KinematicsView& view, size_t begin, size_t end, float scale) {
+    AdvanceScalar(view, begin, end, scale);
+}
+
+} // namespace sim
+
+#endif
\ No newline at end of file
@@ -0,0 +1,179 @@
+#include "projection.h"
+
+#include <cmath>
+
+namespace sim {
+
+namespace {
+
+// Эллипсоид WGS84
+constexpr double WGS84_A = 6378137.0;
+constexpr double WGS84_F = 1.0 / 298.257223563;
+constexpr double WGS84_B = WGS84_A * (1.0 - WGS84_F);
+constexpr double WGS84_E2 = WGS84_F * (2.0 - WGS84_F);
+constexpr double WGS84_EP2 = WGS84_E2 / (1.0 - WGS84_E2);
+
+constexpr double DEG_TO_RAD = M_PI / 180.0;
+constexpr double RAD_TO_DEG = 180.0 / M_PI;
+
+double MercatorX(double longitude) {
+    return WGS84_A * longitude * DEG_TO_RAD;
+}
+
+double MercatorY(double latitude) {
+    return WGS84_A * std::log(std::tan(M_PI / 4 + latitude * DEG_TO_RAD / 2));
+}
+
+} // namespace
+
+Projection::Projection()
+    : Projection({ global_parameters::REFERENCE_LATITUDE, global_parameters::REFERENCE_LONGITUDE },
+                 { global_parameters::MAP_TOP_COORDINATES, global_parameters::MAP_LEFT_COORDINATES },
+                 global_parameters::MAP_IMAGE_WIDTH / global_parameters::MAP_WIDTH) {
+}
+
+Projection::Projection(const GeoPoint& reference, const GeoPoint& map_origin, double map_units_per_degree)
+    : reference_(reference)
+    , reference_ecef_(GeoToEcef(reference.latitude, reference.longitude, 0.0))
+    , sin_lat_(std::sin(reference.latitude * DEG_TO_RAD))
+    , cos_lat_(std::cos(reference.latitude * DEG_TO_RAD))
+    , sin_lon_(std::sin(reference.longitude * DEG_TO_RAD))
+    , cos_lon_(std::cos(reference.longitude * DEG_TO_RAD))
+    , origin_x_(MercatorX(map_origin.longitude))
+    , origin_y_(MercatorY(map_origin.latitude))
+    , units_per_metre_(map_units_per_degree / (WGS84_A * DEG_TO_RAD)) {
+}
+
+GeoPoint Projection::GetReference() const {
+    return reference_;
+}
+
+sf::Vector2f Projection::GeoToEnu(const GeoPoint& point) const {
+    const Ecef ecef = GeoToEcef(point.latitude, point.longitude, 0.0);
+    const double dx = ecef.x - reference_ecef_.x;
+    const double dy = ecef.y - reference_ecef_.y;
+    const double dz = ecef.z - reference_ecef_.z;
+
+    const double east = -sin_lon_ * dx + cos_lon_ * dy;
+    const double north = -sin_lat_ * cos_lon_ * dx - sin_lat_ * sin_lon_ * dy + cos_lat_ * dz;
+    return { static_cast<float>(east), static_cast<float>(north) };
+}
+
+GeoPoint Projection::EnuToGeo(const sf::Vector2f& enu) const {
+    return EcefToGeo(EnuToSurface(enu.x, enu.y));
+}
+
+sf::Vector2f Projection::GeoToScreen(const GeoPoint& point) const {
+    return { static_cast<float>((MercatorX(point.longitude) - origin_x_) * units_per_metre_),
+             static_cast<float>((origin_y_ - MercatorY(point.latitude)) * units_per_metre_)
+           };
+}
+
+GeoPoint Projection::ScreenToGeo(const sf::Vector2f& screen) const {
+    const double x = origin_x_ + screen.x / units_per_metre_;
+    const double y = origin_y_ - screen.y / units_per_metre_;
+    return { (2 * std::atan(std::exp(y / WGS84_A)) - M_PI / 2) * RAD_TO_DEG, x / WGS84_A * RAD_TO_DEG };
+}
+
+sf::Vector2f Projection::EnuToScreen(const sf::Vector2f& enu) const {
+    return GeoToScreen(EnuToGeo(enu));
+}
+
+sf::Vector2f Projection::ScreenToEnu(const sf::Vector2f& screen) const {
+    return GeoToEnu(ScreenToGeo(screen));
+}
+
+float Projection::HeadingToScreen(const GeoPoint& point, float enu_heading) const {
+    // Ось "север" плоскости ENU совпадает с истинным севером только в
+    // опорной точке, в стороне меридианы сходятся на угол
+    // atan(tg(dlon) * sin(lat0)). Меркатор сохраняет углы, а ось y экрана
+    // направлена вниз, поэтому курс меняет знак
+    const double convergence = std::atan(std::tan((point.longitude - reference_.longitude) * DEG_TO_RAD) * sin_lat_);
+    return static_cast<float>(convergence - enu_heading);
+}
+
+void Projection::ToScreen(const float* east, const float* north, const float* heading, size_t count,
+                          float* x, float* y, float* screen_heading) const {
+    for (size_t i = 0; i < count; ++i) {
+        // Меркатору нужны только синус широты и долгота, поэтому
+        // считаем их без обратных тригонометрических функций для широты
+        const Ecef surface = EnuToSurface(east[i], north[i]);
+        double sin_lat;
+        const double lon = GetSinLatitude(surface, sin_lat);
+
+        x[i] = static_cast<float>((WGS84_A * lon - origin_x_) * units_per_metre_);
+        y[i] = static_cast<float>((origin_y_ - WGS84_A * std::atanh(sin_lat)) * units_per_metre_);
+
+        if (heading != nullptr && screen_heading != nullptr) {
+            const double convergence = std::atan(std::tan(lon - reference_.longitude * DEG_TO_RAD) * sin_lat_);
+            screen_heading[i] = static_cast<float>(convergence - heading[i]);
+        }
+    }
+}
+
+void Projection::ToGeo(const float* east, const float* north, size_t count, double* latitude, double* longitude) const {
+    for (size_t i = 0; i < count; ++i) {
+        const GeoPoint point = EnuToGeo({ east[i], north[i] });
+        latitude[i] = point.latitude;
+        longitude[i] = point.longitude;
+    }
+}
+
+Projection::Ecef Projection::GeoToEcef(double latitude, double longitude, double height) {
+    const double lat = latitude * DEG_TO_RAD;
+    const double lon = longitude * DEG_TO_RAD;
+    const double n = WGS84_A / std::sqrt(1 - WGS84_E2 * std::sin(lat) * std::sin(lat));
+    return { (n + height) * std::cos(lat) * std::cos(lon),
+             (n + height) * std::cos(lat) * std::sin(lon),
+             (n * (1 - WGS84_E2) + height) * std::sin(lat)
+           };
+}
+
+double Projection::GetSinLatitude(const Ecef& ecef, double& sin_lat) {
+    // Формула Боуринга, у поверхности точна до миллиметров без итераций.
+    // Вспомогательный угол нужен только через синус и косинус
+    const double p = std::sqrt(ecef.x * ecef.x + ecef.y * ecef.y);
+    const double theta_y = ecef.z * WGS84_A;
+    const double theta_x = p * WGS84_B;
+    const double theta_r = std::sqrt(theta_y * theta_y + theta_x * theta_x);
+    const double sin_theta = theta_y / theta_r;
+    const double cos_theta = theta_x / theta_r;
+
+    const double lat_y = ecef.z + WGS84_EP2 * WGS84_B * sin_theta * sin_theta * sin_theta;
+    const double lat_x = p - WGS84_E2 * WGS84_A * cos_theta * cos_theta * cos_theta;
+    sin_lat = lat_y / std::sqrt(lat_y * lat_y + lat_x * lat_x);
+
+    return std::atan2(ecef.y, ecef.x);
+}
+
+GeoPoint Projection::EcefToGeo(const Ecef& ecef) {
+    double sin_lat;
+    const double lon = GetSinLatitude(ecef, sin_lat);
+    return { std::asin(sin_lat) * RAD_TO_DEG, lon * RAD_TO_DEG };
+}
+
+Projection::Ecef Projection::EnuToEcef(double east, double north, double up) const {
+    return { reference_ecef_.x - sin_lon_ * east - sin_lat_ * cos_lon_ * north + cos_lat_ * cos_lon_ * up,
+             reference_ecef_.y + cos_lon_ * east - sin_lat_ * sin_lon_ * north + cos_lat_ * sin_lon_ * up,
+             reference_ecef_.z + cos_lat_ * north + sin_lat_ * up
+           };
+}
+
+Projection::Ecef Projection::EnuToSurface(double east, double north) const {
+    // Идем от точки касательной плоскости вдоль вертикали опорной точки
+    // до эллипсоида: x^2/a^2 + y^2/a^2 + z^2/b^2 = 1 дает квадратное
+    // уравнение на высоту up, берем ближайший к плоскости корень
+    const Ecef plane = EnuToEcef(east, north, 0.0);
+    const Ecef up_axis = { cos_lat_ * cos_lon_, cos_lat_ * sin_lon_, sin_lat_ };
+
+    const double a2 = WGS84_A * WGS84_A;
+    const double b2 = WGS84_B * WGS84_B;
+    const double qa = (up_axis.x * up_axis.x + up_axis.y * up_axis.y) / a2 + up_axis.z * up_axis.z / b2;
+    const double qb = 2 * ((plane.x * up_axis.x + plane.y * up_axis.y) / a2 + plane.z * up_axis.z / b2);
+    const double qc = (plane.x * plane.x + plane.y * plane.y) / a2 + plane.z * plane.z / b2 - 1;
+    const double up = -2 * qc / (qb + std::sqrt(qb * qb - 4 * qa * qc));
+
+    return { plane.x + up_axis.x * up, plane.y + up_axis.y * up, plane.z + up_axis.z * up };
+}
+
+} // namespace sim
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "../global_parameters.h"
+
+#include <cstddef>
+#include <SFML/System/Vector2.hpp>
+
+/*
+   Пересчет координат. Симуляция идет в метрах в локальной
+   касательной плоскости ENU (восток, север) вокруг опорного
+   аэропорта, а на экран попадает в проекции Web Mercator. Экранные
+   координаты мира - это метры Меркатора, сдвинутые к левому
+   верхнему углу map.png и отмасштабированные так, чтобы единица
+   мира совпадала с пикселем map.png (ось y направлена вниз).
+
+   Плоскость ENU считается лежащей на эллипсоиде WGS84: точка
+   (e, n) - это точка поверхности, чьи восточная и северная
+   составляющие относительно опорной равны e и n, поэтому перевод
+   туда и обратно точен на любых расстояниях в пределах РПИ.
+*/
+
+namespace sim {
+
+struct GeoPoint {
+    double latitude;
+    double longitude;
+};
+
+class Projection {
+public:
+    // Опорная точка и начало карты берутся из global_parameters
+    Projection();
+
+    Projection(const GeoPoint& reference, const GeoPoint& map_origin, double map_units_per_degree);
+
+    GeoPoint GetReference() const;
+
+    sf::Vector2f GeoToEnu(const GeoPoint& point) const;
+
+    GeoPoint EnuToGeo(const sf::Vector2f& enu) const;
+
+    sf::Vector2f GeoToScreen(const GeoPoint& point) const;
+
+    GeoPoint ScreenToGeo(const sf::Vector2f& screen) const;
+
+    sf::Vector2f EnuToScreen(const sf::Vector2f& enu) const;
+
+    sf::Vector2f ScreenToEnu(const sf::Vector2f& screen) const;
+
+    // Курс в ENU (от востока против часовой) в угол на экране. В точке,
+    // удаленной от опорной, учитывается схождение меридианов
+    float HeadingToScreen(const GeoPoint& point, float enu_heading) const;
+
+    // Пакетный перевод count точек ENU в экранные координаты. heading
+    // и screen_heading могут быть nullptr, если курсы не нужны
+    void ToScreen(const float* east, const float* north, const float* heading, size_t count,
+                  float* x, float* y, float* screen_heading) const;
+
+    // Пакетный перевод count точек ENU в широту и долготу
+    void ToGeo(const float* east, const float* north, size_t count, double* latitude, double* longitude) const;
+
+private:
+    struct Ecef {
+        double x;
+        double y;
+        double z;
+    };
+
+    static Ecef GeoToEcef(double latitude, double longitude, double height);
+
+    // Долгота в радианах, синус геодезической широты - в sin_lat
+    static double GetSinLatitude(const Ecef& ecef, double& sin_lat);
+
+    static GeoPoint EcefToGeo(const Ecef& ecef);
+
+    Ecef EnuToEcef(double east, double north, double up) const;
+
+    // Точка эллипсоида с заданными восточной и северной составляющими
+    Ecef EnuToSurface(double east, double north) const;
+
+private:
+    GeoPoint reference_;
+    Ecef reference_ecef_;
+    double sin_lat_;
+    double cos_lat_;
+    double sin_lon_;
+    double cos_lon_;
+
+    // Меркатор левого верхнего угла карты и масштаб метр -> единица мира
+    double origin_x_;
+    double origin_y_;
+    double units_per_metre_;
+};
+
+} // namespace sim
\ No newline at end of file
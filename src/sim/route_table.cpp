@@ -0,0 +1,311 @@
+#include "route_table.h"
+
+#include <algorithm>
+
+using namespace global_parameters;
+
+namespace sim {
+
+namespace {
+
+constexpr double TWO_PI = 2 * M_PI;
+
+// Точки ближе этого считаются совпадающими, метры
+constexpr double ROUTE_MIN_DISTANCE = 1e-3;
+
+// Поворот меньше этого считается нулевым, радианы. Без допуска
+// ошибка округления превращала бы нулевую дугу в полный круг
+constexpr double ROUTE_MIN_TURN = 1e-6;
+
+RouteLeg MakeSegment(const sf::Vector2f& from, const sf::Vector2f& to, uint32_t waypoint) {
+    const double dx = to.x - from.x;
+    const double dy = to.y - from.y;
+    const double length = std::hypot(dx, dy);
+    const double angle = std::atan2(dy, dx);
+    return { from, { static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)) },
+             static_cast<float>(angle), 0.f, 0.f, static_cast<float>(length), waypoint };
+}
+
+RouteLeg MakeArc(double center_x, double center_y, double start, double radius, double turn, double sweep, uint32_t waypoint) {
+    return { { static_cast<float>(center_x), static_cast<float>(center_y) }, { 0.f, 0.f },
+             static_cast<float>(start), static_cast<float>(radius), static_cast<float>(turn),
+             static_cast<float>(radius * sweep), waypoint };
+}
+
+} // namespace
+
+void RouteTable::Add() {
+    routes_.emplace_back();
+    current_.push_back({});
+    distance_.push_back(0.f);
+}
+
+void RouteTable::Reserve(size_t capacity) {
+    routes_.reserve(capacity);
+    current_.reserve(capacity);
+    distance_.reserve(capacity);
+}
+
+void RouteTable::Clear() {
+    routes_.clear();
+    current_.clear();
+    distance_.clear();
+}
+
+size_t RouteTable::Size() const {
+    return routes_.size();
+}
+
+bool RouteTable::IsActive(size_t slot) const {
+    return routes_[slot].leg < routes_[slot].legs.size();
+}
+
+void RouteTable::Append(size_t slot, const Waypoint& waypoint, const RoutePose& pose, float speed, float angle_speed) {
+    if (!IsActive(slot)) {
+        routes_[slot].waypoints.clear();
+    }
+    routes_[slot].waypoints.push_back(waypoint);
+    Build(slot, pose, speed, angle_speed);
+}
+
+void RouteTable::Rebuild(size_t slot, const RoutePose& pose, float speed, float angle_speed) {
+    if (IsActive(slot)) {
+        Build(slot, pose, speed, angle_speed);
+    }
+}
+
+void RouteTable::Reset(size_t slot) {
+    Route& route = routes_[slot];
+    route.waypoints.clear();
+    route.legs.clear();
+    route.leg = 0;
+    SetCurrent(slot);
+}
+
+bool RouteTable::AdvanceLeg(size_t slot, RoutePose& pose) {
+    Route& route = routes_[slot];
+    float distance = distance_[slot];
+    while (route.leg < route.legs.size() && distance >= route.legs[route.leg].length) {
+        distance -= route.legs[route.leg].length;
+        ++route.leg;
+    }
+
+    if (route.leg < route.legs.size()) {
+        SetCurrent(slot);
+        distance_[slot] = distance;
+        pose = EvaluateLeg(current_[slot], distance);
+        return true;
+    }
+
+    pose = Extrapolate(route, distance);
+    Reset(slot);
+    return false;
+}
+
+RoutePose RouteTable::Evaluate(size_t slot, float distance) const {
+    const Route& route = routes_[slot];
+    size_t leg = route.leg;
+    distance += distance_[slot];
+    while (leg < route.legs.size() && distance >= route.legs[leg].length) {
+        distance -= route.legs[leg].length;
+        ++leg;
+    }
+
+    if (leg < route.legs.size()) {
+        return EvaluateLeg(route.legs[leg], distance);
+    }
+    return Extrapolate(route, distance);
+}
+
+const std::vector<Waypoint>& RouteTable::GetWaypoints(size_t slot) const {
+    return routes_[slot].waypoints;
+}
+
+const std::vector<RouteLeg>& RouteTable::GetLegs(size_t slot) const {
+    return routes_[slot].legs;
+}
+
+void RouteTable::Build(size_t slot, const RoutePose& pose, float speed, float angle_speed) {
+    Route& route = routes_[slot];
+
+    // Пройденные точки больше не нужны
+    const size_t first = route.leg < route.legs.size() ? route.legs[route.leg].waypoint : 0;
+    route.waypoints.erase(route.waypoints.begin(), route.waypoints.begin() + first);
+
+    route.legs.clear();
+    route.leg = 0;
+
+    // Радиус разворота с постоянной угловой скоростью
+    const double radius = speed / std::max(angle_speed, SIM_ROUTE_MIN_ANGLE_SPEED);
+
+    RoutePose current = pose;
+    for (size_t i = 0; i < route.waypoints.size(); ++i) {
+        const Waypoint& waypoint = route.waypoints[i];
+        const size_t legs_before = route.legs.size();
+        Join(route, current, waypoint.position, radius, static_cast<uint32_t>(i));
+
+        if (waypoint.type != WaypointType::FLY_BY || i + 1 == route.waypoints.size() || route.legs.size() == legs_before) {
+            continue;
+        }
+
+        // Упреждение разворота: дуга касается входящего и исходящего
+        // участков на расстоянии radius * tan(поворот / 2) от точки
+        RouteLeg& inbound = route.legs.back();
+        const sf::Vector2f next = route.waypoints[i + 1].position;
+        const double out_x = next.x - waypoint.position.x;
+        const double out_y = next.y - waypoint.position.y;
+        const double out_length = std::hypot(out_x, out_y);
+        const double out_angle = std::atan2(out_y, out_x);
+        const double delta = std::remainder(out_angle - inbound.angle, TWO_PI);
+        const double anticipation = radius * std::tan(std::abs(delta) / 2);
+
+        // Разворот не помещается в участки - точка проходится как fly-over
+        if (std::abs(delta) < ROUTE_MIN_TURN || anticipation > inbound.length || anticipation > out_length) {
+            continue;
+        }
+
+        inbound.length -= static_cast<float>(anticipation);
+        const double turn = delta > 0. ? 1. : -1.;
+        const double start_x = waypoint.position.x - inbound.direction.x * anticipation;
+        const double start_y = waypoint.position.y - inbound.direction.y * anticipation;
+        const double center_x = start_x - radius * turn * inbound.direction.y;
+        const double center_y = start_y + radius * turn * inbound.direction.x;
+        route.legs.push_back(MakeArc(center_x, center_y, inbound.angle - turn * M_PI / 2, radius, turn, std::abs(delta), static_cast<uint32_t>(i)));
+
+        current.position = { static_cast<float>(waypoint.position.x + out_x / out_length * anticipation),
+                             static_cast<float>(waypoint.position.y + out_y / out_length * anticipation)
+                           };
+        current.angle = static_cast<float>(out_angle);
+    }
+
+    SetCurrent(slot);
+}
+
+void RouteTable::Join(Route& route, RoutePose& pose, const sf::Vector2f& target, double radius, uint32_t waypoint) {
+    const double dx = target.x - pose.position.x;
+    const double dy = target.y - pose.position.y;
+    if (std::hypot(dx, dy) < ROUTE_MIN_DISTANCE) {
+        return;
+    }
+
+    const double course = pose.angle;
+    const double error = std::remainder(std::atan2(dy, dx) - course, TWO_PI);
+
+    if (std::abs(error) > ROUTE_MIN_TURN && radius > 0.) {
+        // Разворот в сторону точки. Если точка внутри круга разворота,
+        // до нее не дотянуться - разворачиваемся в другую сторону
+        double turn = error > 0. ? 1. : -1.;
+        double center_x = pose.position.x - radius * turn * std::sin(course);
+        double center_y = pose.position.y + radius * turn * std::cos(course);
+        if (std::hypot(target.x - center_x, target.y - center_y) <= radius) {
+            turn = -turn;
+            center_x = pose.position.x - radius * turn * std::sin(course);
+            center_y = pose.position.y + radius * turn * std::cos(course);
+        }
+
+        const double distance = std::hypot(target.x - center_x, target.y - center_y);
+        if (distance > radius) {
+            // Точка схода с окружности - касательная к ней проходит через target
+            const double start = course - turn * M_PI / 2;
+            const double end = std::atan2(target.y - center_y, target.x - center_x) - turn * std::acos(radius / distance);
+            double sweep = std::fmod(turn * (end - start), TWO_PI);
+            if (sweep < 0.) {
+                sweep += TWO_PI;
+            }
+            if (sweep > TWO_PI - ROUTE_MIN_TURN) {
+                sweep = 0.;
+            }
+
+            if (sweep > ROUTE_MIN_TURN) {
+                route.legs.push_back(MakeArc(center_x, center_y, start, radius, turn, sweep, waypoint));
+                pose.position = { static_cast<float>(center_x + radius * std::cos(end)),
+                                  static_cast<float>(center_y + radius * std::sin(end))
+                                };
+            }
+        }
+    }
+
+    route.legs.push_back(MakeSegment(pose.position, target, waypoint));
+    pose.position = target;
+    pose.angle = route.legs.back().angle;
+}
+
+RoutePose RouteTable::Extrapolate(const Route& route, float distance) {
+    if (route.legs.empty()) {
+        return { { 0.f, 0.f }, 0.f };
+    }
+
+    const RouteLeg& last = route.legs.back();
+    RoutePose pose = EvaluateLeg(last, last.length);
+    pose.position += sf::Vector2f(std::cos(pose.angle), std::sin(pose.angle)) * distance;
+    return pose;
+}
+
+void RouteTable::SetCurrent(size_t slot) {
+    const Route& route = routes_[slot];
+    current_[slot] = route.leg < route.legs.size() ? route.legs[route.leg] : RouteLeg{};
+    distance_[slot] = 0.f;
+}
+
+void RouteTable::SaveState(StateWriter& writer) const {
+    writer.Write(static_cast<uint64_t>(routes_.size()));
+    for (const Route& route : routes_) {
+        writer.Write(static_cast<uint64_t>(route.waypoints.size()));
+        for (const Waypoint& waypoint : route.waypoints) {
+            writer.Write(waypoint.position.x);
+            writer.Write(waypoint.position.y);
+            writer.Write(waypoint.type);
+        }
+        writer.WriteVector(route.legs);
+        writer.Write(route.leg);
+    }
+    writer.WriteVector(current_);
+    writer.WriteVector(distance_);
+}
+
+bool RouteTable::LoadState(StateReader& reader) {
+    // Меньше всего места занимает маршрут без точек и участков
+    constexpr size_t MIN_ROUTE_SIZE = sizeof(uint64_t) + sizeof(uint64_t) + sizeof(Route::leg);
+    constexpr size_t WAYPOINT_SIZE = sizeof(Waypoint::position.x) + sizeof(Waypoint::position.y) + sizeof(Waypoint::type);
+
+    uint64_t count = 0;
+    if (!reader.ReadCount(count, MIN_ROUTE_SIZE)) {
+        return false;
+    }
+    std::vector<Route> routes(static_cast<size_t>(count));
+    for (Route& route : routes) {
+        uint64_t waypoints = 0;
+        if (!reader.ReadCount(waypoints, WAYPOINT_SIZE)) {
+            return false;
+        }
+        route.waypoints.resize(static_cast<size_t>(waypoints));
+        for (Waypoint& waypoint : route.waypoints) {
+            if (!reader.Read(waypoint.position.x) || !reader.Read(waypoint.position.y) || !reader.Read(waypoint.type)
+                || (waypoint.type != WaypointType::FLY_BY && waypoint.type != WaypointType::FLY_OVER)) {
+                return false;
+            }
+        }
+        if (!reader.ReadVector(route.legs) || !reader.Read(route.leg)) {
+            return false;
+        }
+        // Build стирает точки до точки текущего участка
+        for (const RouteLeg& leg : route.legs) {
+            if (leg.waypoint >= route.waypoints.size()) {
+                return false;
+            }
+        }
+    }
+
+    std::vector<RouteLeg> current;
+    std::vector<float> distance;
+    if (!reader.ReadVector(current) || !reader.ReadVector(distance) || current.size() != routes.size()
+        || distance.size() != routes.size()) {
+        return false;
+    }
+    routes_ = std::move(routes);
+    current_ = std::move(current);
+    distance_ = std::move(distance);
+    return true;
+}
+
+} // namespace sim
\ No newline at end of file
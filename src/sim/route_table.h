@@ -0,0 +1,149 @@
+#pragma once
+
+#include "../global_parameters.h"
+#include "state_io.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <SFML/System/Vector2.hpp>
+
+/*
+   Маршруты самолетов: упорядоченные списки точек пути. Точка
+   fly-by проходится с упреждением разворота (самолет срезает угол
+   по дуге, вписанной между участками), точка fly-over - точно над
+   ней, с разворотом уже после пролета.
+
+   При каждом изменении маршрута, скорости или угловой скорости
+   маршрут один раз переводится в геометрию: цепочку прямых участков
+   и дуг радиуса speed / angle_speed с заранее вычисленными точками
+   начала разворотов. Каждый тик самолету на маршруте остается только
+   продвинуться на speed * dt вдоль текущего участка, без решения
+   закона управления. Текущий участок каждого слота скопирован в
+   плоский массив, поэтому шаг читает память подряд, а к списку
+   участков обращается только при переходе на следующий.
+*/
+
+namespace sim {
+
+enum class WaypointType : uint8_t {
+    FLY_BY,
+    FLY_OVER
+};
+
+struct Waypoint {
+    sf::Vector2f position;
+    WaypointType type;
+};
+
+// Положение и курс на маршруте
+struct RoutePose {
+    sf::Vector2f position;
+    float angle;
+};
+
+// Участок маршрута. Прямой (turn = 0): положение origin + direction * s,
+// курс angle. Дуга (turn = +-1, + против часовой стрелки): центр origin,
+// угол на окружности angle + turn * s / radius
+struct RouteLeg {
+    sf::Vector2f origin;
+    sf::Vector2f direction;
+    float angle;
+    float radius;
+    float turn;
+    float length;
+    // Номер точки пути, к которой ведет участок
+    uint32_t waypoint;
+};
+
+class RouteTable {
+public:
+    RouteTable() = default;
+
+    void Add();
+
+    void Reserve(size_t capacity);
+
+    void Clear();
+
+    size_t Size() const;
+
+    // true, пока маршрут слота не пройден
+    bool IsActive(size_t slot) const;
+
+    // Добавляет точку в конец маршрута и пересчитывает его геометрию от pose
+    void Append(size_t slot, const Waypoint& waypoint, const RoutePose& pose, float speed, float angle_speed);
+
+    // Пересчитывает оставшуюся часть маршрута от pose, например после смены скорости
+    void Rebuild(size_t slot, const RoutePose& pose, float speed, float angle_speed);
+
+    void Reset(size_t slot);
+
+    // Продвигает слот на distance метров вдоль маршрута. false, если
+    // маршрут пройден: тогда pose - продолжение последнего участка по прямой
+    bool Advance(size_t slot, float distance, RoutePose& pose) {
+        distance_[slot] += distance;
+        if (distance_[slot] < current_[slot].length) {
+            pose = EvaluateLeg(current_[slot], distance_[slot]);
+            return true;
+        }
+        return AdvanceLeg(slot, pose);
+    }
+
+    // Положение через distance метров от текущего, без продвижения.
+    // За концом маршрута - продолжение по прямой
+    RoutePose Evaluate(size_t slot, float distance) const;
+
+    // Еще не пройденные точки маршрута
+    const std::vector<Waypoint>& GetWaypoints(size_t slot) const;
+
+    const std::vector<RouteLeg>& GetLegs(size_t slot) const;
+
+    // Все маршруты в опорный кадр записи сеанса и обратно
+    void SaveState(StateWriter& writer) const;
+
+    bool LoadState(StateReader& reader);
+
+private:
+    struct Route {
+        std::vector<Waypoint> waypoints;
+        std::vector<RouteLeg> legs;
+        uint32_t leg = 0;
+    };
+
+    void Build(size_t slot, const RoutePose& pose, float speed, float angle_speed);
+
+    // Переход на следующие участки, когда текущий пройден
+    bool AdvanceLeg(size_t slot, RoutePose& pose);
+
+    // Разворот от pose в сторону точки target (если нужен) и прямой участок до нее
+    static void Join(Route& route, RoutePose& pose, const sf::Vector2f& target, double radius, uint32_t waypoint);
+
+    static RoutePose EvaluateLeg(const RouteLeg& leg, float distance) {
+        if (leg.turn == 0.f) {
+            return { leg.origin + leg.direction * distance, leg.angle };
+        }
+
+        const float angle = leg.angle + leg.turn * distance / leg.radius;
+        return { { leg.origin.x + leg.radius * std::cos(angle), leg.origin.y + leg.radius * std::sin(angle) },
+                 angle + leg.turn * static_cast<float>(M_PI / 2)
+               };
+    }
+
+    // Конец маршрута и продолжение по прямой на distance метров
+    static RoutePose Extrapolate(const Route& route, float distance);
+
+    // Делает участок leg слота текущим
+    void SetCurrent(size_t slot);
+
+private:
+    std::vector<Route> routes_;
+
+    // Текущий участок и пройденная по нему дистанция. У слота без
+    // маршрута длина участка нулевая
+    std::vector<RouteLeg> current_;
+    std::vector<float> distance_;
+};
+
+} // namespace sim
\ No newline at end of file
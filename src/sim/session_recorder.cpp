@@ -0,0 +1,175 @@
+#include "session_recorder.h"
+
+#include "../../utils/log_rotation.h"
+
+#include <ctime>
+#include <filesystem>
+#include <system_error>
+#include <vector>
+
+namespace sim {
+
+SessionRecorder::SessionRecorder(const std::string& path, uint32_t seed, size_t keep)
+    : seed_(seed)
+    , records_(global_parameters::SESSION_RECORD_CAPACITY)
+    , free_states_(global_parameters::SESSION_KEYFRAME_BUFFERS)
+    , flush_interval_(std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::duration<double>(global_parameters::SESSION_RECORD_FLUSH_INTERVAL))) {
+    // Имена записей те же, что у частей журнала: время в имени, номер
+    // внутри секунды, порядок имен - порядок сеансов
+    utils::log_rotation::SegmentNames names(path);
+    path_ = names.Make(std::time(nullptr)).string();
+
+    if (keep > 0) {
+        const std::vector<std::filesystem::path> records = names.List();
+        std::error_code error;
+        for (size_t i = 0; i + keep <= records.size(); ++i) {
+            std::filesystem::remove(records[i], error);
+        }
+    }
+    file_ = std::fopen(path_.c_str(), "wb");
+
+    for (size_t i = 0; i < global_parameters::SESSION_KEYFRAME_BUFFERS; ++i) {
+        states_.push_back(std::make_unique<std::string>());
+        std::string* state = states_.back().get();
+        free_states_.TryPush([state](std::string*& slot) {
+            slot = state;
+        });
+    }
+    writer_ = std::thread(&SessionRecorder::Run, this);
+}
+
+SessionRecorder::~SessionRecorder() {
+    running_.store(false, std::memory_order_release);
+    writer_.join();
+    if (file_ != nullptr) {
+        std::fclose(file_);
+    }
+}
+
+void SessionRecorder::Begin(InstructionSet instruction_set) {
+    if (begun_ || file_ == nullptr) {
+        return;
+    }
+    begun_ = true;
+
+    std::string header;
+    StateWriter writer(header);
+    for (char symbol : SESSION_MAGIC) {
+        writer.Write(symbol);
+    }
+    writer.Write(SESSION_VERSION);
+    writer.Write(seed_);
+    writer.Write(instruction_set);
+    writer.Write(static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count()));
+    // Записей в буфере еще нет, фоновый поток файл пока не трогает
+    std::fwrite(header.data(), 1, header.size(), file_);
+}
+
+void SessionRecorder::RecordCommand(uint64_t tick, const Command& command) {
+    if (!begun_) {
+        return;
+    }
+    while (!records_.TryPush([&](PendingRecord& record) {
+        record.type = SessionRecordType::COMMAND;
+        record.tick = tick;
+        record.command = command;
+        record.state = nullptr;
+    })) {
+        std::this_thread::yield();
+    }
+}
+
+void SessionRecorder::RecordKeyframe(uint64_t tick, double sim_time, const std::string& state) {
+    if (!begun_) {
+        return;
+    }
+    std::string* buffer = nullptr;
+    free_states_.Drain([&buffer](std::string* free_state) {
+        buffer = free_state;
+    }, 1);
+    if (buffer == nullptr) {
+        dropped_keyframes_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Емкость буфера остается от прошлых кадров, новой памяти не нужно
+    buffer->assign(state);
+    const bool pushed = records_.TryPush([&](PendingRecord& record) {
+        record.type = SessionRecordType::KEYFRAME;
+        record.tick = tick;
+        record.sim_time = sim_time;
+        record.state = buffer;
+    });
+    if (!pushed) {
+        free_states_.TryPush([buffer](std::string*& slot) {
+            slot = buffer;
+        });
+        dropped_keyframes_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool SessionRecorder::IsOpen() const {
+    return file_ != nullptr;
+}
+
+const std::string& SessionRecorder::GetPath() const {
+    return path_;
+}
+
+uint64_t SessionRecorder::GetDroppedKeyframeCount() const {
+    return dropped_keyframes_.load(std::memory_order_relaxed);
+}
+
+void SessionRecorder::Run() {
+    while (true) {
+        // Флаг читается до опустошения буфера: записи, сделанные до
+        // остановки, попадут в файл на последнем проходе
+        const bool running = running_.load(std::memory_order_acquire);
+
+        const size_t count = records_.Drain([this](const PendingRecord& record) {
+            Append(record);
+        }, records_.GetCapacity());
+        WriteBatch();
+
+        if (!running) {
+            return;
+        }
+        if (count == 0) {
+            std::this_thread::sleep_for(flush_interval_);
+        }
+    }
+}
+
+void SessionRecorder::Append(const PendingRecord& record) {
+    StateWriter writer(batch_);
+    writer.Write(record.type);
+    writer.Write(record.tick);
+    if (record.type == SessionRecordType::COMMAND) {
+        writer.Write(COMMAND_RECORD_SIZE);
+        WriteCommand(writer, record.command);
+        return;
+    }
+
+    writer.Write(static_cast<uint32_t>(sizeof(record.sim_time) + record.state->size()));
+    writer.Write(record.sim_time);
+    batch_ += *record.state;
+    std::string* state = record.state;
+    free_states_.TryPush([state](std::string*& slot) {
+        slot = state;
+    });
+}
+
+void SessionRecorder::WriteBatch() {
+    if (batch_.empty()) {
+        return;
+    }
+    if (file_ != nullptr) {
+        std::fwrite(batch_.data(), 1, batch_.size(), file_);
+        std::fflush(file_);
+    }
+    batch_.clear();
+}
+
+} // namespace sim
\ No newline at end of file
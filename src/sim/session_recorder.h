@@ -0,0 +1,150 @@
+#pragma once
+
+#include "../global_parameters.h"
+#include "../../utils/log_ring.h"
+#include "command.h"
+#include "kinematics.h"
+#include "state_io.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+   Запись сеанса для воспроизведения (SessionReplayer). Каждый сеанс
+   пишется в свой файл: к имени path добавляется время начала, как у
+   частей журнала ("session.20240529-162640.rec"), и запись прошлого
+   запуска не затирается. Хранятся последние keep записей, более
+   старые удаляются при открытии новой. Файл только дописывается:
+     заголовок: "ASESSN1\0", версия, зерно генератора рейсов, набор
+                инструкций ядра кинематики, время начала (нс от эпохи)
+     записи:    тип, номер шага, длина данных, данные
+
+   COMMAND - команда, примененная потоком симуляции после tick шагов.
+   Все действия пользователя (цель, точки маршрута, ползунки, эшелон,
+   запуск и завершение) доходят до модели только командами, поэтому
+   их достаточно, чтобы повторить сеанс.
+   KEYFRAME - опорный кадр: модельное время и полное состояние
+   симуляции (Simulation::SaveState) после tick шагов, до команд
+   этого шага. С него воспроизведение начинается при перемотке.
+
+   Поток симуляции только кладет записи в LogRing, как EventLog;
+   в файл их пачками пишет фоновый поток, сбрасывая файл на диск
+   после каждой пачки. Команда занимает слот буфера целиком. Кадр
+   копируется в один из заранее выделенных буферов пула, и фоновый
+   поток возвращает буфер после записи. Порядок записей в файле -
+   порядок вызовов.
+
+   Команды нужны для воспроизведения все: если буфер записей
+   заполнен, поток симуляции ждет слот (буфер опустошается каждые
+   SESSION_RECORD_FLUSH_INTERVAL секунд, так что это возможно, только
+   если диск надолго встал). Опорный кадр без свободного буфера
+   пропускается: воспроизведение начнется с более раннего кадра.
+*/
+
+namespace sim {
+
+constexpr char SESSION_MAGIC[8] = { 'A', 'S', 'E', 'S', 'S', 'N', '1', '\0' };
+constexpr uint32_t SESSION_VERSION = 1;
+
+enum class SessionRecordType : uint8_t {
+    COMMAND,
+    KEYFRAME
+};
+
+// Команда по полям, без байтов выравнивания
+constexpr uint32_t COMMAND_RECORD_SIZE = sizeof(Command::type) + sizeof(Command::slot) + sizeof(Command::x) + sizeof(Command::y)
+                                         + sizeof(Command::value);
+
+inline void WriteCommand(StateWriter& writer, const Command& command) {
+    writer.Write(command.type);
+    writer.Write(command.slot);
+    writer.Write(command.x);
+    writer.Write(command.y);
+    writer.Write(command.value);
+}
+
+inline bool ReadCommand(StateReader& reader, Command& command) {
+    reader.Read(command.type);
+    reader.Read(command.slot);
+    reader.Read(command.x);
+    reader.Read(command.y);
+    reader.Read(command.value);
+    // Слот и значение проверяет Simulation при применении: размер флота
+    // известен только там
+    return reader.IsGood() && static_cast<size_t>(command.type) < COMMAND_TYPE_COUNT;
+}
+
+class SessionRecorder {
+public:
+    // seed - зерно генератора рейсов AviationHandler; keep - сколько
+    // последних записей хранить вместе с новой, 0 - все
+    SessionRecorder(const std::string& path, uint32_t seed, size_t keep);
+
+    SessionRecorder(const SessionRecorder&) = delete;
+    SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+    // Дописывает все оставшиеся записи и закрывает файл
+    ~SessionRecorder();
+
+    // Пишет заголовок при первом запуске потока симуляции
+    void Begin(InstructionSet instruction_set);
+
+    void RecordCommand(uint64_t tick, const Command& command);
+
+    // state - результат Simulation::SaveState
+    void RecordKeyframe(uint64_t tick, double sim_time, const std::string& state);
+
+    bool IsOpen() const;
+
+    // Файл записи этого сеанса
+    const std::string& GetPath() const;
+
+    // Опорные кадры, пропущенные из-за занятых буферов
+    uint64_t GetDroppedKeyframeCount() const;
+
+private:
+    // Запись в буфере до фонового потока
+    struct PendingRecord {
+        SessionRecordType type;
+        uint64_t tick;
+        // COMMAND
+        Command command;
+        // KEYFRAME: модельное время и буфер пула с состоянием
+        double sim_time;
+        std::string* state;
+    };
+
+    void Run();
+
+    // Переводит запись в байты файла и возвращает буфер кадра в пул
+    void Append(const PendingRecord& record);
+
+    void WriteBatch();
+
+private:
+    std::string path_;
+    uint32_t seed_;
+    bool begun_ = false;
+
+    utils::log_ring::LogRing<PendingRecord> records_;
+    // Свободные буферы кадров: берет поток симуляции, возвращает фоновый
+    utils::log_ring::LogRing<std::string*> free_states_;
+    std::vector<std::unique_ptr<std::string>> states_;
+    std::chrono::microseconds flush_interval_;
+    std::atomic<uint64_t> dropped_keyframes_{ 0 };
+    std::atomic<bool> running_{ true };
+
+    // Дальше - только фоновый поток (file_ еще и Begin до первой записи)
+    std::FILE* file_ = nullptr;
+    std::string batch_;
+
+    std::thread writer_;
+};
+
+} // namespace sim
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include "session_replayer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace sim {
+
+bool SessionReplayer::Open(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    data_.clear();
+    char chunk[1 << 16];
+    size_t read;
+    while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        data_.append(chunk, read);
+    }
+    std::fclose(file);
+
+    StateReader reader(data_.data(), data_.size());
+    char magic[sizeof(SESSION_MAGIC)];
+    for (char& symbol : magic) {
+        reader.Read(symbol);
+    }
+    uint32_t version = 0;
+    int64_t start_time = 0;
+    reader.Read(version);
+    reader.Read(seed_);
+    reader.Read(instruction_set_);
+    reader.Read(start_time);
+    if (!reader.IsGood() || std::memcmp(magic, SESSION_MAGIC, sizeof(magic)) != 0 || version != SESSION_VERSION) {
+        return false;
+    }
+
+    keyframes_.clear();
+    commands_.clear();
+    end_tick_ = 0;
+    size_t offset = sizeof(SESSION_MAGIC) + sizeof(version) + sizeof(seed_) + sizeof(instruction_set_) + sizeof(start_time);
+    while (true) {
+        StateReader record(data_.data() + offset, data_.size() - offset);
+        SessionRecordType type;
+        uint64_t tick = 0;
+        uint32_t size = 0;
+        record.Read(type);
+        record.Read(tick);
+        record.Read(size);
+        const size_t header_size = sizeof(type) + sizeof(tick) + sizeof(size);
+        // Конец файла или оборванная запись прерванного сеанса
+        if (!record.IsGood() || data_.size() - offset - header_size < size) {
+            break;
+        }
+        offset += header_size;
+
+        StateReader payload(data_.data() + offset, size);
+        if (type == SessionRecordType::COMMAND) {
+            RecordedCommand recorded{ tick, {} };
+            if (!ReadCommand(payload, recorded.command)) {
+                return false;
+            }
+            commands_.push_back(recorded);
+        }
+        else if (type == SessionRecordType::KEYFRAME) {
+            double sim_time = 0.;
+            if (!payload.Read(sim_time)) {
+                return false;
+            }
+            keyframes_.push_back({ tick, sim_time, offset + sizeof(sim_time), size - sizeof(sim_time), commands_.size() });
+        }
+        else {
+            return false;
+        }
+        end_tick_ = std::max(end_tick_, tick);
+        offset += size;
+    }
+
+    simulation_.SetInstructionSet(instruction_set_);
+    return true;
+}
+
+bool SessionReplayer::Seek(double sim_time) {
+    if (keyframes_.empty()) {
+        return false;
+    }
+    size_t index = 0;
+    for (size_t i = 1; i < keyframes_.size() && keyframes_[i].sim_time <= sim_time; ++i) {
+        index = i;
+    }
+
+    const Keyframe& keyframe = keyframes_[index];
+    if (!simulation_.LoadState(data_.data() + keyframe.offset, keyframe.size)) {
+        return false;
+    }
+    next_command_ = keyframe.next_command;
+    next_keyframe_ = index + 1;
+    verified_ = 0;
+    mismatches_ = 0;
+
+    while (simulation_.GetSimTime() < sim_time && Step()) {
+    }
+    return true;
+}
+
+bool SessionReplayer::Step() {
+    const uint64_t tick = simulation_.GetTick();
+    while (next_command_ < commands_.size() && commands_[next_command_].tick <= tick) {
+        simulation_.Execute(commands_[next_command_].command);
+        ++next_command_;
+    }
+    if (tick >= end_tick_) {
+        return false;
+    }
+
+    simulation_.Step();
+    CheckKeyframe();
+    return true;
+}
+
+uint32_t SessionReplayer::GetSeed() const {
+    return seed_;
+}
+
+InstructionSet SessionReplayer::GetRecordedInstructionSet() const {
+    return instruction_set_;
+}
+
+size_t SessionReplayer::GetKeyframeCount() const {
+    return keyframes_.size();
+}
+
+size_t SessionReplayer::GetCommandCount() const {
+    return commands_.size();
+}
+
+uint64_t SessionReplayer::GetEndTick() const {
+    return end_tick_;
+}
+
+size_t SessionReplayer::GetVerifiedCount() const {
+    return verified_;
+}
+
+size_t SessionReplayer::GetMismatchCount() const {
+    return mismatches_;
+}
+
+uint64_t SessionReplayer::GetFirstMismatchTick() const {
+    return first_mismatch_tick_;
+}
+
+const Simulation& SessionReplayer::GetSimulation() const {
+    return simulation_;
+}
+
+void SessionReplayer::CheckKeyframe() {
+    const uint64_t tick = simulation_.GetTick();
+    while (next_keyframe_ < keyframes_.size() && keyframes_[next_keyframe_].tick < tick) {
+        ++next_keyframe_;
+    }
+    if (next_keyframe_ == keyframes_.size() || keyframes_[next_keyframe_].tick != tick) {
+        return;
+    }
+
+    // Кадры того же шага после перезапуска потока записаны уже после
+    // команд шага, сверяется только первый
+    const Keyframe& keyframe = keyframes_[next_keyframe_];
+    simulation_.SaveState(state_);
+    if (state_.size() == keyframe.size && std::memcmp(state_.data(), data_.data() + keyframe.offset, keyframe.size) == 0) {
+        ++verified_;
+    }
+    else {
+        if (mismatches_ == 0) {
+            first_mismatch_tick_ = tick;
+        }
+        ++mismatches_;
+    }
+    ++next_keyframe_;
+}
+
+} // namespace sim
\ No newline at end of file
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "session_recorder.h"
+#include "simulation.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+   Воспроизведение записи сеанса (SessionRecorder) без потока
+   симуляции и без реального времени: шаги идут подряд, так быстро,
+   как позволяет процессор. Команды применяются на тех же шагах,
+   что и при записи, поэтому модель проходит те же состояния.
+
+   Seek восстанавливает последний опорный кадр не позже нужного
+   момента и досчитывает от него. Каждый следующий опорный кадр
+   записи, до которого доходит воспроизведение, сравнивается с
+   пересчитанным состоянием побайтно - так проверяется, что
+   воспроизведение детерминировано.
+*/
+
+namespace sim {
+
+class SessionReplayer {
+public:
+    SessionReplayer() = default;
+
+    // Читает файл записи целиком. false, если это не запись сеанса
+    // или она испорчена; оборванная последняя запись отбрасывается
+    bool Open(const std::string& path);
+
+    // Восстанавливает последний кадр с модельным временем не позже
+    // sim_time и досчитывает до sim_time. false, если кадров нет
+    // или кадр не читается
+    bool Seek(double sim_time);
+
+    // Применяет команды текущего шага и делает шаг. false, если
+    // записанный сеанс кончился
+    bool Step();
+
+    uint32_t GetSeed() const;
+
+    InstructionSet GetRecordedInstructionSet() const;
+
+    size_t GetKeyframeCount() const;
+
+    size_t GetCommandCount() const;
+
+    // Номер шага последней записи
+    uint64_t GetEndTick() const;
+
+    // Опорные кадры, совпавшие и не совпавшие с пересчетом после Seek
+    size_t GetVerifiedCount() const;
+
+    size_t GetMismatchCount() const;
+
+    // Шаг первого несовпадения
+    uint64_t GetFirstMismatchTick() const;
+
+    const Simulation& GetSimulation() const;
+
+private:
+    struct Keyframe {
+        uint64_t tick;
+        double sim_time;
+        size_t offset;
+        size_t size;
+        // Первая команда, записанная после кадра
+        size_t next_command;
+    };
+
+    struct RecordedCommand {
+        uint64_t tick;
+        Command command;
+    };
+
+    // Сравнивает состояние с кадром записи на этом шаге, если он есть
+    void CheckKeyframe();
+
+private:
+    // Объявлена первой: кадры в keyframes_ ссылаются на ее байты
+    std::string data_;
+    uint32_t seed_ = 0;
+    InstructionSet instruction_set_ = InstructionSet::SCALAR;
+    std::vector<Keyframe> keyframes_;
+    std::vector<RecordedCommand> commands_;
+    uint64_t end_tick_ = 0;
+
+    Simulation simulation_;
+    size_t next_command_ = 0;
+    size_t next_keyframe_ = 0;
+
+    std::string state_;
+    size_t verified_ = 0;
+    size_t mismatches_ = 0;
+    uint64_t first_mismatch_tick_ = 0;
+};
+
+} // namespace sim
\ No newline at end of file
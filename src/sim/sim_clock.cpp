@@ -0,0 +1,75 @@
+#include "sim_clock.h"
+
+namespace sim {
+
+void SimClock::SetRate(float rate) {
+    // Сохраняем долю текущего шага, чтобы интерполяция не дергалась
+    const float alpha = GetAlpha();
+    rate_ = rate;
+    accumulator_ = alpha * GetStep();
+}
+
+float SimClock::GetRate() const {
+    return rate_;
+}
+
+void SimClock::SetTimeScale(float time_scale) {
+    time_scale_ = time_scale;
+}
+
+float SimClock::GetTimeScale() const {
+    return time_scale_;
+}
+
+float SimClock::GetStep() const {
+    return 1.f / rate_;
+}
+
+size_t SimClock::Advance(float real_seconds) {
+    accumulator_ += real_seconds * time_scale_;
+
+    const float step = GetStep();
+    size_t steps = static_cast<size_t>(accumulator_ / step);
+
+    // Если симуляция не успевает (долгая пауза окна, слишком большое
+    // ускорение), отбрасываем лишнее время, а не копим его бесконечно
+    if (steps > global_parameters::SIM_MAX_STEPS_PER_FRAME) {
+        steps = global_parameters::SIM_MAX_STEPS_PER_FRAME;
+        accumulator_ = steps * step;
+    }
+
+    accumulator_ -= steps * step;
+    if (accumulator_ < 0.f) {
+        accumulator_ = 0.f;
+    }
+    return steps;
+}
+
+void SimClock::CompleteStep() {
+    sim_time_ += GetStep();
+}
+
+float SimClock::GetAlpha() const {
+    const float alpha = accumulator_ * rate_;
+    return alpha < 1.f ? alpha : 1.f;
+}
+
+double SimClock::GetSimTime() const {
+    return sim_time_;
+}
+
+void SimClock::SaveState(StateWriter& writer) const {
+    writer.Write(rate_);
+    writer.Write(time_scale_);
+    writer.Write(sim_time_);
+}
+
+bool SimClock::LoadState(StateReader& reader) {
+    reader.Read(rate_);
+    reader.Read(time_scale_);
+    reader.Read(sim_time_);
+    accumulator_ = 0.f;
+    return reader.IsGood();
+}
+
+} // namespace sim
\ No newline at end of file
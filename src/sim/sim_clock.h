@@ -0,0 +1,63 @@
+#pragma once
+
+#include "../global_parameters.h"
+#include "state_io.h"
+
+#include <cstddef>
+
+/*
+   Часы симуляции с фиксированным шагом. Реальное время кадра
+   (умноженное на коэффициент ускорения) копится в аккумуляторе,
+   из которого симуляция забирает целые шаги длиной 1 / rate.
+   Остаток аккумулятора дает коэффициент интерполяции между двумя
+   последними состояниями, поэтому отрисовка не зависит от частоты
+   симуляции, а скорость самолетов - от частоты кадров.
+*/
+
+namespace sim {
+
+class SimClock {
+public:
+    SimClock() = default;
+
+    void SetRate(float rate);
+
+    float GetRate() const;
+
+    void SetTimeScale(float time_scale);
+
+    float GetTimeScale() const;
+
+    // Длина одного шага симуляции в секундах
+    float GetStep() const;
+
+    // Добавляет прошедшее реальное время и возвращает число шагов,
+    // которые нужно выполнить
+    size_t Advance(float real_seconds);
+
+    // Засчитывает один выполненный шаг в модельное время. Время растет
+    // по шагу, а не пачкой, поэтому не зависит от того, сколько шагов
+    // пришлось на один Advance, и воспроизведение дает то же время
+    void CompleteStep();
+
+    // Доля шага, прошедшая после последнего выполненного шага, [0, 1)
+    float GetAlpha() const;
+
+    // Модельное время в секундах
+    double GetSimTime() const;
+
+    // Частота, ускорение и время для опорного кадра записи сеанса.
+    // Аккумулятор - остаток реального времени, в состояние модели не
+    // входит и при загрузке обнуляется
+    void SaveState(StateWriter& writer) const;
+
+    bool LoadState(StateReader& reader);
+
+private:
+    float rate_ = global_parameters::SIM_DEFAULT_RATE;
+    float time_scale_ = 1.f;
+    float accumulator_ = 0.f;
+    double sim_time_ = 0.;
+};
+
+} // namespace sim
\ No newline at end of file
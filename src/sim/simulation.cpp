@@ -0,0 +1,384 @@
+#include "simulation.h"
+
+#include <cmath>
+
+namespace sim {
+
+namespace {
+
+// Слишком малый, отрицательный или нечисловой интервал сделал бы
+// ячейки SpatialGrid бесконечно мелкими
+bool IsValidSeparation(float separation) {
+    return std::isfinite(separation) && separation >= global_parameters::SIM_MIN_CONFLICT_SEPARATION;
+}
+
+// Частота и ускорение делят шаг времени, поэтому только конечные и положительные
+bool IsValidRate(float rate) {
+    return std::isfinite(rate) && rate > 0.f;
+}
+
+// Команды, адресованные самолету по слоту
+bool IsSlotCommand(CommandType type) {
+    return type != CommandType::ADD_AIRCRAFT && type != CommandType::SET_RATE
+        && type != CommandType::SET_TIME_SCALE && type != CommandType::SET_SEPARATION
+        && type != CommandType::SET_WIND;
+}
+
+} // namespace
+
+Simulation::Simulation()
+    : scheduler_(global_parameters::SIM_WORKER_THREADS)
+    , thread_(&Simulation::Run, this) {
+    fleet_.SetScheduler(&scheduler_);
+    fleet_.SetWindField(&wind_field_);
+
+    // Сетка читается один раз, до запуска потока симуляции
+    if (weather_grid_.Load(global_parameters::WEATHER_GRID_PATH)) {
+        wind_field_.SetGrid(&weather_grid_, &projection_);
+    }
+    conflict_alert_.SetScheduler(&scheduler_);
+    predictor_.SetScheduler(&scheduler_);
+    conflict_probe_.SetScheduler(&scheduler_);
+}
+
+Simulation::~Simulation() {
+    Stop();
+}
+
+void Simulation::Start() {
+    if (!running_.exchange(true)) {
+        thread_.launch();
+    }
+}
+
+void Simulation::Stop() {
+    if (running_.exchange(false)) {
+        thread_.wait();
+    }
+}
+
+void Simulation::SetEventLog(utils::event_log::EventLog* event_log) {
+    event_log_ = event_log;
+}
+
+void Simulation::SetRecorder(SessionRecorder* recorder) {
+    recorder_ = recorder;
+}
+
+size_t Simulation::AddAircraft(const sf::Vector2f& position, float altitude) {
+    Post({ CommandType::ADD_AIRCRAFT, static_cast<uint32_t>(aircraft_count_), position.x, position.y, altitude });
+    return aircraft_count_++;
+}
+
+bool Simulation::Post(const Command& command) {
+    // Пока есть отложенные, новые встают за ними
+    if (deferred_.empty() && commands_.Push(command)) {
+        return true;
+    }
+    if (deferred_.empty() && event_log_ != nullptr) {
+        event_log_->Message("Command queue is full, commands are deferred");
+    }
+    deferred_.push_back(command);
+    return false;
+}
+
+void Simulation::FlushCommands() {
+    while (!deferred_.empty() && commands_.Push(deferred_.front())) {
+        deferred_.pop_front();
+    }
+}
+
+size_t Simulation::GetDeferredCount() const {
+    return deferred_.size();
+}
+
+const FleetSnapshot& Simulation::AcquireSnapshot() {
+    return snapshots_.Acquire();
+}
+
+void Simulation::Execute(const Command& command) {
+    ApplyCommand(command);
+}
+
+void Simulation::Step() {
+    fleet_.Step(clock_.GetStep());
+    clock_.CompleteStep();
+    DetectConflicts();
+    ++tick_;
+    LogStep();
+
+    if (recorder_ != nullptr && clock_.GetSimTime() >= next_keyframe_time_) {
+        RecordKeyframe();
+    }
+}
+
+void Simulation::SaveState(std::string& state) const {
+    state.clear();
+    StateWriter writer(state);
+    writer.Write(tick_);
+    clock_.SaveState(writer);
+    writer.Write(conflict_alert_.GetSeparation());
+    const sf::Vector2f wind = wind_field_.GetSurfaceWind();
+    writer.Write(wind.x);
+    writer.Write(wind.y);
+    fleet_.SaveState(writer);
+}
+
+bool Simulation::LoadState(const char* data, size_t size) {
+    StateReader reader(data, size);
+    float separation = 0.f;
+    sf::Vector2f wind;
+    reader.Read(tick_);
+    clock_.LoadState(reader);
+    reader.Read(separation);
+    reader.Read(wind.x);
+    reader.Read(wind.y);
+    if (!fleet_.LoadState(reader) || !reader.IsEnd() || !IsValidSeparation(separation)) {
+        return false;
+    }
+
+    conflict_alert_.SetSeparation(separation);
+    conflict_probe_.SetSeparation(separation);
+    // Сбрасывает кеш ветра: слоты перечитают ветер своих ячеек
+    wind_field_.SetSurfaceWind(wind);
+    for (size_t slot = 0; slot < fleet_.Size(); ++slot) {
+        predictor_.Invalidate(slot);
+    }
+    next_probe_time_ = clock_.GetSimTime();
+    DetectConflicts();
+    return true;
+}
+
+uint64_t Simulation::GetTick() const {
+    return tick_;
+}
+
+double Simulation::GetSimTime() const {
+    return clock_.GetSimTime();
+}
+
+InstructionSet Simulation::GetInstructionSet() const {
+    return fleet_.GetKernel().GetInstructionSet();
+}
+
+void Simulation::SetInstructionSet(InstructionSet instruction_set) {
+    fleet_.GetKernel().SetInstructionSet(instruction_set);
+}
+
+const Fleet& Simulation::GetFleet() const {
+    return fleet_;
+}
+
+const std::vector<Conflict>& Simulation::GetConflicts() const {
+    return conflict_alert_.GetConflicts();
+}
+
+void Simulation::Run() {
+    sf::Clock real_clock;
+
+    // Кадр в начале каждого запуска: с него можно воспроизводить,
+    // даже если запись начата не с нуля
+    if (recorder_ != nullptr) {
+        recorder_->Begin(GetInstructionSet());
+        RecordKeyframe();
+    }
+
+    while (running_.load(std::memory_order_relaxed)) {
+        const bool changed = ApplyCommands();
+
+        const size_t steps = clock_.Advance(real_clock.restart().asSeconds());
+        for (size_t i = 0; i < steps; ++i) {
+            Step();
+        }
+
+        if (clock_.GetSimTime() >= next_probe_time_) {
+            ProbeConflicts();
+        }
+
+        if (steps > 0 || changed) {
+            Publish();
+        }
+
+        // Спим до следующего шага. При большом ускорении шаг короче
+        // точности сна, тогда следующая итерация просто сделает
+        // несколько шагов сразу
+        const float until_next_step = (1.f - clock_.GetAlpha()) * clock_.GetStep() / clock_.GetTimeScale();
+        sf::sleep(sf::seconds(until_next_step));
+    }
+
+    // Конечный кадр: запись воспроизводится до последнего шага
+    if (recorder_ != nullptr) {
+        RecordKeyframe();
+    }
+}
+
+bool Simulation::ApplyCommands() {
+    bool applied = false;
+    Command command;
+    while (commands_.Pop(command)) {
+        ApplyCommand(command);
+        applied = true;
+    }
+    return applied;
+}
+
+bool Simulation::IsValidCommand(const Command& command) const {
+    if (static_cast<size_t>(command.type) >= COMMAND_TYPE_COUNT) {
+        return false;
+    }
+    // Setter'ы Fleet не проверяют слот, а запись сеанса может быть испорчена
+    if (IsSlotCommand(command.type) && command.slot >= fleet_.Size()) {
+        return false;
+    }
+    switch (command.type) {
+        case CommandType::SET_RATE:
+        case CommandType::SET_TIME_SCALE:
+            return IsValidRate(command.value);
+        case CommandType::SET_SEPARATION:
+            return IsValidSeparation(command.value);
+        case CommandType::ADD_WAYPOINT:
+            return command.value == static_cast<float>(WaypointType::FLY_BY)
+                || command.value == static_cast<float>(WaypointType::FLY_OVER);
+        default:
+            return true;
+    }
+}
+
+void Simulation::ApplyCommand(const Command& command) {
+    if (event_log_ != nullptr) {
+        event_log_->Write(utils::event_log::EventId::COMMAND, command.slot,
+                          utils::event_log::PayloadBuilder::Make(command.type, command.x, command.y, command.value));
+    }
+    // Негодная команда не применяется и не пишется в запись сеанса
+    if (!IsValidCommand(command)) {
+        if (event_log_ != nullptr) {
+            event_log_->Message("Invalid command is skipped");
+        }
+        return;
+    }
+    if (recorder_ != nullptr) {
+        recorder_->RecordCommand(tick_, command);
+    }
+
+    // Все команды самолету, кроме добавления, меняют его будущий путь
+    if (IsSlotCommand(command.type)) {
+        predictor_.Invalidate(command.slot);
+    }
+
+    switch (command.type) {
+        case CommandType::ADD_AIRCRAFT:
+            fleet_.Add({ command.x, command.y }, 0.f, command.value);
+            break;
+        case CommandType::SET_ACTIVE:
+            fleet_.SetActive(command.slot, command.value != 0.f);
+            break;
+        case CommandType::SET_POSITION:
+            fleet_.SetPosition(command.slot, { command.x, command.y });
+            break;
+        case CommandType::SET_TARGET:
+            fleet_.SetTargetPosition(command.slot, { command.x, command.y });
+            break;
+        case CommandType::SET_ALTITUDE:
+            fleet_.SetAltitude(command.slot, command.value);
+            break;
+        case CommandType::SET_TARGET_ALTITUDE:
+            fleet_.SetTargetAltitude(command.slot, command.value);
+            break;
+        case CommandType::SET_ANGLE:
+            fleet_.SetAngle(command.slot, command.value);
+            break;
+        case CommandType::SET_SPEED:
+            fleet_.SetSpeed(command.slot, command.value);
+            break;
+        case CommandType::SET_ANGLE_SPEED:
+            fleet_.SetAngleSpeed(command.slot, command.value);
+            break;
+        case CommandType::SET_RATE:
+            clock_.SetRate(command.value);
+            break;
+        case CommandType::SET_TIME_SCALE:
+            clock_.SetTimeScale(command.value);
+            break;
+        case CommandType::SET_SEPARATION:
+            conflict_alert_.SetSeparation(command.value);
+            conflict_probe_.SetSeparation(command.value);
+            DetectConflicts();
+            next_probe_time_ = clock_.GetSimTime();
+            break;
+        case CommandType::ADD_WAYPOINT:
+            fleet_.AddWaypoint(command.slot, { { command.x, command.y }, static_cast<WaypointType>(command.value) });
+            break;
+        case CommandType::CLEAR_ROUTE:
+            fleet_.ClearRoute(command.slot);
+            break;
+        case CommandType::SET_WIND:
+            // Новый ветер меняет пути всех самолетов
+            wind_field_.SetSurfaceWind({ command.x, command.y });
+            for (size_t slot = 0; slot < fleet_.Size(); ++slot) {
+                predictor_.Invalidate(slot);
+            }
+            next_probe_time_ = clock_.GetSimTime();
+            break;
+    }
+}
+
+void Simulation::DetectConflicts() {
+    const KinematicsView view = fleet_.GetKinematicsView();
+    conflict_alert_.Update(view.x, view.y, fleet_.GetVerticalView().altitude, view.active, fleet_.Size());
+}
+
+void Simulation::ProbeConflicts() {
+    const KinematicsView view = fleet_.GetKinematicsView();
+    predictor_.Update(view, fleet_.GetVerticalView(), fleet_.GetRoutes(), fleet_.Size(), clock_.GetSimTime());
+    conflict_probe_.Probe(predictor_, view.active, fleet_.Size(), clock_.GetSimTime());
+    next_probe_time_ = clock_.GetSimTime() + global_parameters::SIM_PROBE_INTERVAL;
+}
+
+void Simulation::LogStep() {
+    using utils::event_log::EventId;
+    using utils::event_log::PayloadBuilder;
+
+    if (event_log_ == nullptr) {
+        return;
+    }
+
+    // Все записи шага - с одним временем
+    const int64_t timestamp = event_log_->Now();
+    event_log_->Write(EventId::SIM_STEP, 0,
+                      PayloadBuilder::Make(static_cast<uint32_t>(tick_), clock_.GetSimTime(), clock_.GetStep()), timestamp);
+    if (!global_parameters::EVENT_LOG_AIRCRAFT_STATE) {
+        return;
+    }
+
+    const KinematicsView view = fleet_.GetKinematicsView();
+    const float* altitude = fleet_.GetVerticalView().altitude;
+    for (size_t slot = 0; slot < fleet_.Size(); ++slot) {
+        if (view.active[slot]) {
+            event_log_->Write(EventId::AIRCRAFT_STATE, static_cast<uint32_t>(slot),
+                              PayloadBuilder::Make(view.x[slot], view.y[slot], altitude[slot], view.angle[slot]), timestamp);
+        }
+    }
+}
+
+void Simulation::RecordKeyframe() {
+    SaveState(keyframe_);
+    recorder_->RecordKeyframe(tick_, clock_.GetSimTime(), keyframe_);
+    next_keyframe_time_ = clock_.GetSimTime() + global_parameters::SIM_KEYFRAME_INTERVAL;
+}
+
+void Simulation::Publish() {
+    FleetSnapshot& snapshot = snapshots_.GetWriteBuffer();
+    fleet_.CopyTo(snapshot);
+    snapshot.conflict.assign(conflict_alert_.GetInConflict().begin(), conflict_alert_.GetInConflict().end());
+    snapshot.conflicts.assign(conflict_alert_.GetConflicts().begin(), conflict_alert_.GetConflicts().end());
+    snapshot.predicted_conflict.assign(conflict_probe_.GetInConflict().begin(), conflict_probe_.GetInConflict().end());
+    snapshot.predicted_conflicts.assign(conflict_probe_.GetConflicts().begin(), conflict_probe_.GetConflicts().end());
+    snapshot.tick = tick_;
+    snapshot.sim_time = clock_.GetSimTime();
+    snapshot.alpha = clock_.GetAlpha();
+    snapshot.step_real_seconds = clock_.GetStep() / clock_.GetTimeScale();
+    snapshot.published_at = std::chrono::steady_clock::now();
+    snapshots_.Publish();
+}
+
+} // namespace sim
\ No newline at end of file
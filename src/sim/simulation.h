@@ -0,0 +1,159 @@
+#pragma once
+
+#include "../global_parameters.h"
+#include "command.h"
+#include "conflict_alert.h"
+#include "conflict_probe.h"
+#include "fleet.h"
+#include "fleet_snapshot.h"
+#include "projection.h"
+#include "session_recorder.h"
+#include "sim_clock.h"
+#include "spsc_queue.h"
+#include "state_io.h"
+#include "task_scheduler.h"
+#include "trajectory_predictor.h"
+#include "triple_buffer.h"
+#include "weather_grid.h"
+#include "../../utils/event_log.h"
+
+#include <atomic>
+#include <deque>
+#include <string>
+#include <vector>
+#include <SFML/System.hpp>
+
+/*
+   Модель полета в отдельном потоке. Поток симуляции владеет Fleet
+   и SimClock, получает изменения от интерфейса через очередь команд
+   и после каждой пачки шагов публикует снимок состояния через
+   тройной буфер. Интерфейс забирает последний готовый снимок без
+   мьютекса, поэтому тяжелый шаг симуляции не роняет кадры, а
+   задержка отрисовки не замедляет симуляцию.
+*/
+
+namespace sim {
+
+class Simulation {
+public:
+    Simulation();
+
+    ~Simulation();
+
+    void Start();
+
+    void Stop();
+
+    // Журнал команд и шагов симуляции, nullptr - не писать. Задается
+    // до Start, журнал должен пережить поток симуляции
+    void SetEventLog(utils::event_log::EventLog* event_log);
+
+    // Запись сеанса: команды и опорные кадры раз в SIM_KEYFRAME_INTERVAL
+    // модельных секунд. nullptr - не писать. Задается до Start
+    void SetRecorder(SessionRecorder* recorder);
+
+    // Добавляет самолет и возвращает его слот. Вызывается из потока интерфейса
+    size_t AddAircraft(const sf::Vector2f& position, float altitude = global_parameters::PLANE_INITIAL_ALTITUDE);
+
+    // Передает команду потоку симуляции. Вызывается из потока интерфейса.
+    // Если очередь полна, команда не теряется, а откладывается и уходит
+    // в следующем FlushCommands; порядок команд сохраняется, поэтому
+    // слоты AddAircraft остаются верными. false - команда отложена
+    bool Post(const Command& command);
+
+    // Передает отложенные команды, сколько поместится в очередь.
+    // Вызывается из потока интерфейса раз в кадр
+    void FlushCommands();
+
+    // Число отложенных команд
+    size_t GetDeferredCount() const;
+
+    // Последний опубликованный снимок. Вызывается из потока интерфейса
+    const FleetSnapshot& AcquireSnapshot();
+
+    // Дальше - для воспроизведения сеанса без потока симуляции
+    // (SessionReplayer). Вызывать, только пока поток не запущен
+
+    // Применяет команду сразу, как поток симуляции
+    void Execute(const Command& command);
+
+    // Один шаг симуляции, тот же, что делает поток
+    void Step();
+
+    // Полное состояние, от которого зависят следующие шаги: номер
+    // шага, часы, интервал, ветер и Fleet
+    void SaveState(std::string& state) const;
+
+    // false, если кадр испорчен; тогда состояние не определено
+    bool LoadState(const char* data, size_t size);
+
+    uint64_t GetTick() const;
+
+    double GetSimTime() const;
+
+    InstructionSet GetInstructionSet() const;
+
+    void SetInstructionSet(InstructionSet instruction_set);
+
+    const Fleet& GetFleet() const;
+
+    // Конфликты после последнего шага
+    const std::vector<Conflict>& GetConflicts() const;
+
+private:
+    void Run();
+
+    bool ApplyCommands();
+
+    // Проверяет тип, слот и значение команды до применения
+    bool IsValidCommand(const Command& command) const;
+
+    void ApplyCommand(const Command& command);
+
+    // Ищет пары самолетов ближе допустимого интервала, каждый тик
+    void DetectConflicts();
+
+    // Досчитывает прогноз траекторий и ищет по нему конфликты, раз в SIM_PROBE_INTERVAL
+    void ProbeConflicts();
+
+    // Пишет шаг и состояние самолетов в журнал событий
+    void LogStep();
+
+    void RecordKeyframe();
+
+    void Publish();
+
+private:
+    // Объявлен раньше fleet_, чтобы пережить его
+    TaskScheduler scheduler_;
+
+    Fleet fleet_;
+    Projection projection_;
+    WeatherGrid weather_grid_;
+    WindField wind_field_;
+    ConflictAlert conflict_alert_;
+    TrajectoryPredictor predictor_;
+    ConflictProbe conflict_probe_;
+    double next_probe_time_ = 0.;
+    SimClock clock_;
+    uint64_t tick_ = 0;
+
+    utils::event_log::EventLog* event_log_ = nullptr;
+
+    SessionRecorder* recorder_ = nullptr;
+    double next_keyframe_time_ = 0.;
+    std::string keyframe_;
+
+    TripleBuffer<FleetSnapshot> snapshots_;
+    SpscQueue<Command, global_parameters::SIM_COMMAND_QUEUE_CAPACITY> commands_;
+    // Команды, не поместившиеся в очередь, на стороне интерфейса
+    std::deque<Command> deferred_;
+
+    sf::Thread thread_;
+    std::atomic<bool> running_{ false };
+
+    // Число выданных слотов, ведется на стороне интерфейса
+    size_t aircraft_count_ = 0;
+};
+
+} // namespace sim
\ No newline at end of file
@@ -0,0 +1,186 @@
+#include "spatial_grid.h"
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace sim {
+
+namespace {
+
+constexpr uint32_t INACTIVE_CELL = std::numeric_limits<uint32_t>::max();
+
+} // namespace
+
+void SpatialGrid::Build(const float* x, const float* y, const float* z, const uint8_t* active, size_t count,
+                        float min_cell_size, float min_band_height) {
+    // Иначе удвоение ячейки ниже никогда не уложится в cell_limit
+    assert(min_cell_size > 0.f && min_band_height > 0.f);
+
+    float min_x = std::numeric_limits<float>::max();
+    float min_y = std::numeric_limits<float>::max();
+    float min_z = std::numeric_limits<float>::max();
+    float max_x = std::numeric_limits<float>::lowest();
+    float max_y = std::numeric_limits<float>::lowest();
+    float max_z = std::numeric_limits<float>::lowest();
+    size_t active_count = 0;
+    for (size_t slot = 0; slot < count; ++slot) {
+        if (active[slot]) {
+            min_x = std::min(min_x, x[slot]);
+            min_y = std::min(min_y, y[slot]);
+            min_z = std::min(min_z, z[slot]);
+            max_x = std::max(max_x, x[slot]);
+            max_y = std::max(max_y, y[slot]);
+            max_z = std::max(max_z, z[slot]);
+            ++active_count;
+        }
+    }
+
+    // Границы сетки кратны ячейке и слою, поэтому при медленном
+    // движении флота сетка от тика к тику не меняется
+    float cell_size = min_cell_size;
+    float band_height = min_band_height;
+    float origin_x = 0.f;
+    float origin_y = 0.f;
+    float origin_z = 0.f;
+    uint32_t width = 1;
+    uint32_t height = 1;
+    uint32_t bands = 1;
+    if (active_count > 0) {
+        const double cell_limit = 4. * active_count + 64.;
+        while (true) {
+            origin_x = std::floor(min_x / cell_size) * cell_size;
+            origin_y = std::floor(min_y / cell_size) * cell_size;
+            origin_z = std::floor(min_z / band_height) * band_height;
+            const double cells_x = std::floor((max_x - origin_x) / cell_size) + 1.;
+            const double cells_y = std::floor((max_y - origin_y) / cell_size) + 1.;
+            const double cells_z = std::floor((max_z - origin_z) / band_height) + 1.;
+            if (cells_x * cells_y * cells_z <= cell_limit) {
+                width = static_cast<uint32_t>(cells_x);
+                height = static_cast<uint32_t>(cells_y);
+                bands = static_cast<uint32_t>(cells_z);
+                break;
+            }
+
+            // Укрупняем то измерение, по которому ячеек больше
+            if (cells_x * cells_y >= cells_z) {
+                cell_size *= 2.f;
+            }
+            else {
+                band_height *= 2.f;
+            }
+        }
+    }
+
+    bool changed = cell_size != cell_size_ || origin_x != origin_x_ || origin_y != origin_y_
+                   || width != width_ || height != height_ || count != slot_cell_.size()
+                   || band_height != band_height_ || origin_z != origin_z_ || bands != bands_;
+    cell_size_ = cell_size;
+    inverse_cell_size_ = 1.f / cell_size;
+    origin_x_ = origin_x;
+    origin_y_ = origin_y;
+    width_ = width;
+    height_ = height;
+    band_height_ = band_height;
+    inverse_band_height_ = 1.f / band_height;
+    origin_z_ = origin_z;
+    bands_ = bands;
+    slot_cell_.resize(count);
+    slot_cell_x_.resize(count);
+    slot_cell_y_.resize(count);
+    slot_band_.resize(count);
+
+    for (size_t slot = 0; slot < count; ++slot) {
+        uint32_t cell = INACTIVE_CELL;
+        if (active[slot]) {
+            // Координаты относительно начала сетки неотрицательны,
+            // поэтому отбрасывание дробной части равно floor
+            const uint32_t cell_x = std::min(static_cast<uint32_t>((x[slot] - origin_x_) * inverse_cell_size_), width_ - 1);
+            const uint32_t cell_y = std::min(static_cast<uint32_t>((y[slot] - origin_y_) * inverse_cell_size_), height_ - 1);
+            const uint32_t band = std::min(static_cast<uint32_t>((z[slot] - origin_z_) * inverse_band_height_), bands_ - 1);
+            cell = (band * height_ + cell_y) * width_ + cell_x;
+            slot_cell_x_[slot] = cell_x;
+            slot_cell_y_[slot] = cell_y;
+            slot_band_[slot] = band;
+        }
+        changed |= cell != slot_cell_[slot];
+        slot_cell_[slot] = cell;
+    }
+
+    if (changed) {
+        Rebuild(x, y, z, count);
+        return;
+    }
+
+    // Самолеты остались в своих ячейках, порядок записей прежний
+    for (size_t entry = 0; entry < entry_slot_.size(); ++entry) {
+        entry_x_[entry] = x[entry_slot_[entry]];
+        entry_y_[entry] = y[entry_slot_[entry]];
+        entry_z_[entry] = z[entry_slot_[entry]];
+    }
+}
+
+float SpatialGrid::GetCellSize() const {
+    return cell_size_;
+}
+
+float SpatialGrid::GetBandHeight() const {
+    return band_height_;
+}
+
+size_t SpatialGrid::Size() const {
+    return entry_slot_.size();
+}
+
+void SpatialGrid::QueryRadius(const sf::Vector2f& center, float radius, std::vector<uint32_t>& result) const {
+    result.clear();
+    QueryRadius(center, radius, [&result](uint32_t slot) {
+        result.push_back(slot);
+    });
+}
+
+void SpatialGrid::Rebuild(const float* x, const float* y, const float* z, size_t count) {
+    const size_t cell_count = static_cast<size_t>(width_) * height_ * bands_;
+    cell_start_.assign(cell_count + 1, 0);
+
+    size_t active_count = 0;
+    for (size_t slot = 0; slot < count; ++slot) {
+        if (slot_cell_[slot] != INACTIVE_CELL) {
+            ++cell_start_[slot_cell_[slot] + 1];
+            ++active_count;
+        }
+    }
+    for (size_t cell = 0; cell < cell_count; ++cell) {
+        cell_start_[cell + 1] += cell_start_[cell];
+    }
+
+    entry_x_.resize(active_count);
+    entry_y_.resize(active_count);
+    entry_z_.resize(active_count);
+    entry_slot_.resize(active_count);
+    entry_cell_x_.resize(active_count);
+    entry_cell_y_.resize(active_count);
+    entry_band_.resize(active_count);
+
+    // Раскладываем по ячейкам, используя начала ячеек как курсоры, а
+    // потом сдвигаем их обратно. Внутри ячейки слоты идут по возрастанию
+    for (size_t slot = 0; slot < count; ++slot) {
+        const uint32_t cell = slot_cell_[slot];
+        if (cell != INACTIVE_CELL) {
+            const uint32_t entry = cell_start_[cell]++;
+            entry_x_[entry] = x[slot];
+            entry_y_[entry] = y[slot];
+            entry_z_[entry] = z[slot];
+            entry_slot_[entry] = static_cast<uint32_t>(slot);
+            entry_cell_x_[entry] = slot_cell_x_[slot];
+            entry_cell_y_[entry] = slot_cell_y_[slot];
+            entry_band_[entry] = slot_band_[slot];
+        }
+    }
+    for (size_t cell = cell_count; cell > 0; --cell) {
+        cell_start_[cell] = cell_start_[cell - 1];
+    }
+    cell_start_[0] = 0;
+}
+
+} // namespace sim
\ No newline at end of file
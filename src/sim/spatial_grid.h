@@ -0,0 +1,202 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <SFML/System/Vector2.hpp>
+
+/*
+   Равномерная сетка над положениями самолетов для поиска соседей.
+   Сетка покрывает прямоугольник, описанный вокруг активных самолетов,
+   ячейки нумеруются по строкам, а самолеты лежат в плоских массивах,
+   отсортированных по ячейкам (сортировка подсчетом). Поэтому сборка
+   линейна, после первых тиков обходится без выделений памяти, а
+   соседние ячейки одной строки - это один непрерывный диапазон записей.
+
+   По высоте сетка режется на слои (эшелонные полосы) заданной
+   толщины. Слой - это отдельная плоская сетка той же ширины, слои
+   лежат подряд, поэтому самолеты на разных эшелонах попадают в разные
+   ячейки и при поиске пар сравниваются только с соседним слоем, а не
+   со всеми, кто пролетает над той же точкой.
+
+   Чтобы одиночный самолет далеко от остальных не раздувал сетку,
+   ячейка (или слой) укрупняется вдвое, пока ячеек больше чем вчетверо
+   больше самолетов. Крупная ячейка не ломает поиск, только замедляет его.
+*/
+
+namespace sim {
+
+class SpatialGrid {
+public:
+    SpatialGrid() = default;
+
+    // Раскладывает активные слоты [0, count) по ячейкам не меньше
+    // min_cell_size и по слоям высоты z толщиной не меньше min_band_height
+    // (оба больше нуля). Если ни один самолет не сменил ячейку,
+    // обновляются только координаты записей
+    void Build(const float* x, const float* y, const float* z, const uint8_t* active, size_t count,
+               float min_cell_size, float min_band_height);
+
+    float GetCellSize() const;
+
+    float GetBandHeight() const;
+
+    // Число записей, то есть активных слотов на момент сборки
+    size_t Size() const;
+
+    // Вызывает visit(slot) для всех самолетов не дальше radius от center
+    // по горизонтали, на любой высоте
+    template <typename Visitor>
+    void QueryRadius(const sf::Vector2f& center, float radius, Visitor&& visit) const;
+
+    void QueryRadius(const sf::Vector2f& center, float radius, std::vector<uint32_t>& result) const;
+
+    // Вызывает visit(first, second, distance2) ровно один раз для каждой
+    // пары ближе distance по горизонтали и ближе vertical_distance по
+    // высоте. distance не должна превышать размер ячейки, а
+    // vertical_distance - толщину слоя
+    template <typename Visitor>
+    void ForEachPairWithin(float distance, float vertical_distance, Visitor&& visit) const;
+
+    // То же для пар, первая запись которых лежит в [begin, end) в порядке
+    // сетки. Непересекающиеся диапазоны можно обходить параллельно
+    template <typename Visitor>
+    void ForEachPairWithin(float distance, float vertical_distance, size_t begin, size_t end, Visitor&& visit) const;
+
+private:
+    void Rebuild(const float* x, const float* y, const float* z, size_t count);
+
+private:
+    float cell_size_ = 0.f;
+    float inverse_cell_size_ = 0.f;
+    float origin_x_ = 0.f;
+    float origin_y_ = 0.f;
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+
+    float band_height_ = 0.f;
+    float inverse_band_height_ = 0.f;
+    float origin_z_ = 0.f;
+    uint32_t bands_ = 0;
+
+    // Начало записей каждой ячейки, последний элемент - общее число записей
+    std::vector<uint32_t> cell_start_;
+
+    // Записи, отсортированные по ячейкам
+    std::vector<float> entry_x_;
+    std::vector<float> entry_y_;
+    std::vector<float> entry_z_;
+    std::vector<uint32_t> entry_slot_;
+    std::vector<uint32_t> entry_cell_x_;
+    std::vector<uint32_t> entry_cell_y_;
+    std::vector<uint32_t> entry_band_;
+
+    // Ячейка каждого слота при прошлой сборке, для неактивных - INACTIVE_CELL
+    std::vector<uint32_t> slot_cell_;
+    std::vector<uint32_t> slot_cell_x_;
+    std::vector<uint32_t> slot_cell_y_;
+    std::vector<uint32_t> slot_band_;
+};
+
+template <typename Visitor>
+void SpatialGrid::QueryRadius(const sf::Vector2f& center, float radius, Visitor&& visit) const {
+    if (entry_slot_.empty()) {
+        return;
+    }
+
+    // Прямоугольник запроса в ячейках, обрезанный по сетке
+    const float left = (center.x - radius - origin_x_) * inverse_cell_size_;
+    const float top = (center.y - radius - origin_y_) * inverse_cell_size_;
+    const float right = (center.x + radius - origin_x_) * inverse_cell_size_;
+    const float bottom = (center.y + radius - origin_y_) * inverse_cell_size_;
+    if (right < 0.f || bottom < 0.f || left >= width_ || top >= height_) {
+        return;
+    }
+
+    const uint32_t first_x = left > 0.f ? static_cast<uint32_t>(left) : 0;
+    const uint32_t first_y = top > 0.f ? static_cast<uint32_t>(top) : 0;
+    const uint32_t last_x = std::min(static_cast<uint32_t>(right), width_ - 1);
+    const uint32_t last_y = std::min(static_cast<uint32_t>(bottom), height_ - 1);
+    const float radius2 = radius * radius;
+
+    for (uint32_t band = 0; band < bands_; ++band) {
+        for (uint32_t cell_y = first_y; cell_y <= last_y; ++cell_y) {
+            const uint32_t row = (band * height_ + cell_y) * width_;
+            for (uint32_t entry = cell_start_[row + first_x]; entry < cell_start_[row + last_x + 1]; ++entry) {
+                const float dx = entry_x_[entry] - center.x;
+                const float dy = entry_y_[entry] - center.y;
+                if (dx * dx + dy * dy <= radius2) {
+                    visit(entry_slot_[entry]);
+                }
+            }
+        }
+    }
+}
+
+template <typename Visitor>
+void SpatialGrid::ForEachPairWithin(float distance, float vertical_distance, Visitor&& visit) const {
+    ForEachPairWithin(distance, vertical_distance, 0, entry_slot_.size(), visit);
+}
+
+template <typename Visitor>
+void SpatialGrid::ForEachPairWithin(float distance, float vertical_distance, size_t begin, size_t end, Visitor&& visit) const {
+    const float distance2 = distance * distance;
+    const uint32_t layer = width_ * height_;
+
+    // Чтобы каждая пара нашлась один раз, из своей ячейки берем только
+    // записи дальше по порядку, из соседних в своем слое - только правую
+    // и три в следующей строке, а из слоя выше - все девять соседних.
+    // Своя и правая ячейки идут подряд, три ячейки одной строки - тоже,
+    // так что все это непрерывные диапазоны записей
+    for (size_t entry = begin; entry < end; ++entry) {
+        const float x = entry_x_[entry];
+        const float y = entry_y_[entry];
+        const float z = entry_z_[entry];
+        const uint32_t slot = entry_slot_[entry];
+        const uint32_t cell_x = entry_cell_x_[entry];
+        const uint32_t cell_y = entry_cell_y_[entry];
+        const uint32_t band = entry_band_[entry];
+        const uint32_t cell = (band * height_ + cell_y) * width_ + cell_x;
+
+        auto check_range = [&](uint32_t first, uint32_t last) {
+            for (uint32_t other = first; other < last; ++other) {
+                const float dx = entry_x_[other] - x;
+                const float dy = entry_y_[other] - y;
+                const float d2 = dx * dx + dy * dy;
+                if (d2 < distance2 && std::abs(entry_z_[other] - z) < vertical_distance) {
+                    visit(slot, entry_slot_[other], d2);
+                }
+            }
+        };
+
+        // Три ячейки строки row вокруг cell_x
+        auto check_row = [&](uint32_t row) {
+            const uint32_t center = row + cell_x;
+            const uint32_t first = cell_x > 0 ? center - 1 : center;
+            const uint32_t last = cell_x + 1 < width_ ? center + 2 : center + 1;
+            check_range(cell_start_[first], cell_start_[last]);
+        };
+
+        const uint32_t row_end = cell_x + 1 < width_ ? cell + 2 : cell + 1;
+        check_range(static_cast<uint32_t>(entry) + 1, cell_start_[row_end]);
+
+        if (cell_y + 1 < height_) {
+            check_row(cell - cell_x + width_);
+        }
+
+        if (band + 1 < bands_) {
+            const uint32_t above = cell - cell_x + layer;
+            if (cell_y > 0) {
+                check_row(above - width_);
+            }
+            check_row(above);
+            if (cell_y + 1 < height_) {
+                check_row(above + width_);
+            }
+        }
+    }
+}
+
+} // namespace sim
\ No newline at end of file
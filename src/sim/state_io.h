@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/*
+   Запись состояния симуляции в байтовый буфер и чтение обратно - для
+   опорных кадров записи сеанса. Числа пишутся как в памяти, вектор -
+   длиной и элементами подряд. Структуры с выравниванием (Waypoint,
+   Command) пишутся по полям, чтобы одинаковое состояние всегда
+   давало одинаковые байты.
+*/
+
+namespace sim {
+
+class StateWriter {
+public:
+    explicit StateWriter(std::string& buffer)
+        : buffer_(buffer) {
+    }
+
+    template <class T>
+    void Write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "only plain values are written as bytes");
+        buffer_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <class T>
+    void WriteVector(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>, "only plain values are written as bytes");
+        Write(static_cast<uint64_t>(values.size()));
+        buffer_.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+
+private:
+    std::string& buffer_;
+};
+
+// После первой ошибки (данные кончились) все чтения возвращают false
+class StateReader {
+public:
+    StateReader(const char* data, size_t size)
+        : data_(data)
+        , size_(size) {
+    }
+
+    template <class T>
+    bool Read(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "only plain values are read as bytes");
+        if (!good_ || size_ - offset_ < sizeof(T)) {
+            good_ = false;
+            return false;
+        }
+        std::memcpy(&value, data_ + offset_, sizeof(T));
+        offset_ += sizeof(T);
+        return true;
+    }
+
+    // Длина последовательности, каждый элемент которой занимает не
+    // меньше min_element_size байт. Длина, которой не хватит
+    // оставшихся байтов, - ошибка: из испорченного файла не выделится
+    // огромный буфер
+    bool ReadCount(uint64_t& count, size_t min_element_size) {
+        if (!Read(count) || count > (size_ - offset_) / min_element_size) {
+            good_ = false;
+            return false;
+        }
+        return true;
+    }
+
+    template <class T>
+    bool ReadVector(std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>, "only plain values are read as bytes");
+        uint64_t count = 0;
+        if (!ReadCount(count, sizeof(T))) {
+            return false;
+        }
+        values.resize(static_cast<size_t>(count));
+        if (!values.empty()) {
+            std::memcpy(values.data(), data_ + offset_, values.size() * sizeof(T));
+        }
+        offset_ += values.size() * sizeof(T);
+        return true;
+    }
+
+    bool IsGood() const {
+        return good_;
+    }
+
+    // Все ли байты прочитаны
+    bool IsEnd() const {
+        return offset_ == size_;
+    }
+
+private:
+    const char* data_;
+    size_t size_;
+    size_t offset_ = 0;
+    bool good_ = true;
+};
+
+} // namespace sim
\ No newline at end of file
@@ -0,0 +1,163 @@
+#include "task_scheduler.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace sim {
+
+namespace {
+
+// Поток сейчас выполняет кусок ParallelFor: вложенный вызов идет
+// по порядку, а не повторно захватывает submit_mutex_ в том же потоке
+thread_local bool inside_parallel_for = false;
+
+} // namespace
+
+TaskScheduler::Job::Job(size_t queue_count)
+    : queues(queue_count) {
+}
+
+TaskScheduler::TaskScheduler(size_t thread_count) {
+    if (thread_count == 0) {
+        thread_count = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    queue_count_ = thread_count;
+
+    for (size_t i = 1; i < thread_count; ++i) {
+        threads_.push_back(std::make_unique<sf::Thread>([this, i] { WorkerLoop(i); }));
+        threads_.back()->launch();
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+
+    for (auto& thread : threads_) {
+        thread->wait();
+    }
+}
+
+size_t TaskScheduler::GetThreadCount() const {
+    return queue_count_;
+}
+
+size_t TaskScheduler::GetChunkCount(size_t count, size_t grain) {
+    return (count + grain - 1) / grain;
+}
+
+void TaskScheduler::ParallelFor(size_t count, size_t grain, const RangeTask& task) {
+    grain = std::max<size_t>(grain, 1);
+    const size_t chunks = GetChunkCount(count, grain);
+
+    std::unique_lock<std::mutex> submit;
+    if (!inside_parallel_for) {
+        submit = std::unique_lock<std::mutex>(submit_mutex_, std::try_to_lock);
+    }
+    if (chunks <= 1 || threads_.empty() || !submit.owns_lock()) {
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            task(chunk, chunk * grain, std::min(count, (chunk + 1) * grain));
+        }
+        return;
+    }
+
+    std::shared_ptr<Job> job;
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        // Рабочие берут задание только под wake_mutex_, поэтому
+        // use_count здесь точен
+        if (job_ == nullptr || job_.use_count() != 1) {
+            job_ = std::make_shared<Job>(queue_count_);
+        }
+        job = job_;
+        job->task = &task;
+        job->count = count;
+        job->grain = grain;
+
+        // Раздаем куски непрерывными блоками, чтобы каждый поток
+        // шел по памяти подряд, пока ему не придется воровать
+        for (size_t i = 0; i < queue_count_; ++i) {
+            std::lock_guard<std::mutex> queue_lock(job->queues[i].mutex);
+            job->queues[i].front = chunks * i / queue_count_;
+            job->queues[i].back = chunks * (i + 1) / queue_count_;
+        }
+
+        job->pending_chunks.store(chunks);
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    inside_parallel_for = true;
+    RunChunks(*job, 0);
+    inside_parallel_for = false;
+
+    // Ждем только куски, взятые другими потоками. Рабочие, которые
+    // еще не проснулись, найдут очереди задания пустыми
+    while (job->pending_chunks.load(std::memory_order_acquire) != 0) {
+        std::this_thread::yield();
+    }
+}
+
+void TaskScheduler::WorkerLoop(size_t index) {
+    uint64_t seen_generation = 0;
+    std::shared_ptr<Job> job;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_.wait(lock, [&] { return stopping_ || generation_ != seen_generation; });
+            if (stopping_) {
+                return;
+            }
+            seen_generation = generation_;
+            job = job_;
+        }
+
+        inside_parallel_for = true;
+        RunChunks(*job, index);
+        inside_parallel_for = false;
+        job.reset();
+    }
+}
+
+void TaskScheduler::RunChunks(Job& job, size_t index) {
+    size_t chunk;
+    while (PopOwn(job, index, chunk) || Steal(job, index, chunk)) {
+        RunChunk(job, chunk);
+    }
+}
+
+bool TaskScheduler::PopOwn(Job& job, size_t index, size_t& chunk) {
+    WorkerQueue& queue = job.queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.front == queue.back) {
+        return false;
+    }
+    chunk = queue.front++;
+    return true;
+}
+
+bool TaskScheduler::Steal(Job& job, size_t thief, size_t& chunk) {
+    const size_t queue_count = job.queues.size();
+    for (size_t offset = 1; offset < queue_count; ++offset) {
+        WorkerQueue& queue = job.queues[(thief + offset) % queue_count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.front != queue.back) {
+            chunk = --queue.back;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::RunChunk(Job& job, size_t chunk) {
+    const size_t begin = chunk * job.grain;
+    const size_t end = std::min(job.count, begin + job.grain);
+    (*job.task)(chunk, begin, end);
+    job.pending_chunks.fetch_sub(1, std::memory_order_release);
+}
+
+} // namespace sim
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <SFML/System/Thread.hpp>
+
+/*
+   Планировщик задач с перехватом работы (work stealing). Диапазон
+   [0, count) режется на куски по grain элементов, куски раздаются
+   очередям потоков непрерывными блоками. Поток берет куски из
+   начала своей очереди, а опустев, забирает их с конца чужих.
+
+   Границы кусков зависят только от count и grain, но не от числа
+   потоков, а каждый кусок получает свой номер. Если задача пишет
+   результат куска только в свою часть данных (или в буфер с номером
+   куска, который потом сливается по порядку), результат не зависит
+   от числа потоков и от того, кто какой кусок выполнил.
+
+   Каждый вызов ParallelFor получает свое задание (Job) со своими
+   очередями и счетчиком кусков. Вызывающий ждет только этот счетчик,
+   а не пробуждения всех рабочих: поток, проснувшийся поздно, найдет
+   очереди своего задания пустыми и не тронет следующее.
+*/
+
+namespace sim {
+
+class TaskScheduler {
+public:
+    using RangeTask = std::function<void(size_t chunk, size_t begin, size_t end)>;
+
+    // thread_count - число потоков вместе с вызывающим, 0 - по числу ядер
+    explicit TaskScheduler(size_t thread_count = 0);
+
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    size_t GetThreadCount() const;
+
+    static size_t GetChunkCount(size_t count, size_t grain);
+
+    // Выполняет task для всех кусков и возвращается, когда все они
+    // готовы. Вызывающий поток работает наравне с остальными. Если
+    // планировщик уже занят задачей из другого потока или вызов
+    // вложен (ParallelFor из задачи ParallelFor), куски выполняются
+    // по порядку в вызывающем потоке
+    void ParallelFor(size_t count, size_t grain, const RangeTask& task);
+
+private:
+    // Очередь кусков одного потока. Куски лежат подряд, поэтому
+    // очередь хранится как диапазон номеров [front, back)
+    struct WorkerQueue {
+        std::mutex mutex;
+        size_t front = 0;
+        size_t back = 0;
+    };
+
+    // Один вызов ParallelFor. Очередь 0 принадлежит вызывающему
+    // потоку, остальные - рабочим
+    struct Job {
+        explicit Job(size_t queue_count);
+
+        std::vector<WorkerQueue> queues;
+        const RangeTask* task = nullptr;
+        size_t count = 0;
+        size_t grain = 1;
+        std::atomic<size_t> pending_chunks{ 0 };
+    };
+
+    void WorkerLoop(size_t index);
+
+    static void RunChunks(Job& job, size_t index);
+
+    static bool PopOwn(Job& job, size_t index, size_t& chunk);
+
+    static bool Steal(Job& job, size_t thief, size_t& chunk);
+
+    static void RunChunk(Job& job, size_t chunk);
+
+private:
+    size_t queue_count_;
+    std::vector<std::unique_ptr<sf::Thread>> threads_;
+
+    std::mutex submit_mutex_;
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    uint64_t generation_ = 0;
+    bool stopping_ = false;
+
+    // Текущее задание. Рабочие берут копию указателя под wake_mutex_;
+    // если, кроме планировщика, задание никто не держит, следующий
+    // вызов использует его снова, без выделения памяти
+    std::shared_ptr<Job> job_;
+};
+
+} // namespace sim
\ No newline at end of file
@@ -0,0 +1,333 @@
+#include "trajectory_predictor.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace global_parameters;
+
+namespace sim {
+
+void TrajectoryPredictor::Batch::Resize(size_t size) {
+    slot.resize(size);
+    samples.resize(size);
+    x.resize(size);
+    y.resize(size);
+    angle.resize(size);
+    target_angle.resize(size);
+    speed.resize(size);
+    angle_speed.resize(size);
+    target_x.resize(size);
+    target_y.resize(size);
+    tracking.resize(size);
+    active.assign(size, 1);
+    wind_x.resize(size);
+    wind_y.resize(size);
+    altitude.resize(size);
+    vertical_rate.resize(size);
+    target_altitude.resize(size);
+}
+
+TrajectoryPredictor::TrajectoryPredictor()
+    : sample_count_(GetSampleCount()) {
+}
+
+void TrajectoryPredictor::SetScheduler(TaskScheduler* scheduler) {
+    scheduler_ = scheduler;
+}
+
+void TrajectoryPredictor::Invalidate(size_t slot) {
+    if (slot < valid_.size()) {
+        valid_[slot] = 0;
+    }
+}
+
+void TrajectoryPredictor::Update(const KinematicsView& view, const VerticalView& vertical, const RouteTable& routes, size_t count, double now) {
+    sample_x_.resize(count * sample_count_);
+    sample_y_.resize(count * sample_count_);
+    sample_altitude_.resize(count * sample_count_);
+    start_time_.resize(count);
+    head_.resize(count);
+    valid_.resize(count, 0);
+    end_x_.resize(count);
+    end_y_.resize(count);
+    end_angle_.resize(count);
+    end_target_angle_.resize(count);
+    end_tracking_.resize(count);
+    end_altitude_.resize(count);
+    end_vertical_rate_.resize(count);
+    speed_.resize(count);
+    angle_speed_.resize(count);
+    target_x_.resize(count);
+    target_y_.resize(count);
+    target_altitude_.resize(count);
+    wind_x_.resize(count);
+    wind_y_.resize(count);
+
+    // Сколько отсчетов досчитать каждому слоту: прошедшие отсчеты
+    // уходят из начала кольца, столько же новых нужно в конце
+    needed_.assign(count, 0);
+    std::vector<size_t> needed_count(sample_count_, 0);
+    size_t batch_size = 0;
+
+    for (size_t slot = 0; slot < count; ++slot) {
+        if (!view.active[slot]) {
+            valid_[slot] = 0;
+            continue;
+        }
+
+        if (valid_[slot]) {
+            const double elapsed = std::floor((now - start_time_[slot]) / SIM_PREDICTION_STEP);
+            if (elapsed >= sample_count_) {
+                valid_[slot] = 0;
+            }
+            else if (elapsed > 0.) {
+                const uint32_t passed = static_cast<uint32_t>(elapsed);
+                head_[slot] = (head_[slot] + passed) % sample_count_;
+                start_time_[slot] += passed * static_cast<double>(SIM_PREDICTION_STEP);
+                needed_[slot] = passed;
+            }
+        }
+
+        if (!valid_[slot]) {
+            Reset(view, vertical, slot, now);
+            needed_[slot] = static_cast<uint32_t>(sample_count_ - 1);
+        }
+
+        if (needed_[slot] > 0 && routes.IsActive(slot)) {
+            ExtendRoute(routes, slot, needed_[slot], now);
+            needed_[slot] = 0;
+        }
+
+        if (needed_[slot] > 0) {
+            ++needed_count[needed_[slot]];
+            ++batch_size;
+        }
+    }
+
+    if (batch_size == 0) {
+        return;
+    }
+
+    // Раскладываем слоты по убыванию числа отсчетов (сортировка
+    // подсчетом), тогда на каждом отсчете работают первые записи куска
+    std::vector<size_t> position(sample_count_, 0);
+    for (size_t samples = sample_count_ - 1; samples > 1; --samples) {
+        position[samples - 1] = position[samples] + needed_count[samples];
+    }
+
+    batch_.Resize(batch_size);
+    for (size_t slot = 0; slot < count; ++slot) {
+        if (needed_[slot] == 0) {
+            continue;
+        }
+        const size_t i = position[needed_[slot]]++;
+        batch_.slot[i] = static_cast<uint32_t>(slot);
+        batch_.samples[i] = needed_[slot];
+        batch_.x[i] = end_x_[slot];
+        batch_.y[i] = end_y_[slot];
+        batch_.angle[i] = end_angle_[slot];
+        batch_.target_angle[i] = end_target_angle_[slot];
+        batch_.tracking[i] = end_tracking_[slot];
+        batch_.speed[i] = speed_[slot];
+        batch_.angle_speed[i] = angle_speed_[slot];
+        batch_.target_x[i] = target_x_[slot];
+        batch_.target_y[i] = target_y_[slot];
+        batch_.wind_x[i] = wind_x_[slot];
+        batch_.wind_y[i] = wind_y_[slot];
+        batch_.altitude[i] = end_altitude_[slot];
+        batch_.vertical_rate[i] = end_vertical_rate_[slot];
+        batch_.target_altitude[i] = target_altitude_[slot];
+    }
+
+    auto extend_range = [this](size_t, size_t begin, size_t end) {
+        Extend(begin, end);
+    };
+
+    if (scheduler_ != nullptr) {
+        scheduler_->ParallelFor(batch_size, SIM_PREDICTION_GRAIN, extend_range);
+    }
+    else {
+        Extend(0, batch_size);
+    }
+
+    for (size_t i = 0; i < batch_size; ++i) {
+        const size_t slot = batch_.slot[i];
+        end_x_[slot] = batch_.x[i];
+        end_y_[slot] = batch_.y[i];
+        end_angle_[slot] = batch_.angle[i];
+        end_target_angle_[slot] = batch_.target_angle[i];
+        end_tracking_[slot] = batch_.tracking[i];
+        end_altitude_[slot] = batch_.altitude[i];
+        end_vertical_rate_[slot] = batch_.vertical_rate[i];
+    }
+}
+
+size_t TrajectoryPredictor::Size() const {
+    return valid_.size();
+}
+
+size_t TrajectoryPredictor::GetSampleCount() {
+    return static_cast<size_t>(std::lround(SIM_PREDICTION_HORIZON / SIM_PREDICTION_STEP)) + 1;
+}
+
+bool TrajectoryPredictor::GetPosition(size_t slot, double time, sf::Vector2f& position) const {
+    size_t first;
+    size_t second;
+    float fraction;
+    if (!Locate(slot, time, first, second, fraction)) {
+        return false;
+    }
+
+    position = { sample_x_[first] + (sample_x_[second] - sample_x_[first]) * fraction,
+                 sample_y_[first] + (sample_y_[second] - sample_y_[first]) * fraction
+               };
+    return true;
+}
+
+bool TrajectoryPredictor::GetPosition(size_t slot, double time, sf::Vector2f& position, float& altitude) const {
+    size_t first;
+    size_t second;
+    float fraction;
+    if (!Locate(slot, time, first, second, fraction)) {
+        return false;
+    }
+
+    position = { sample_x_[first] + (sample_x_[second] - sample_x_[first]) * fraction,
+                 sample_y_[first] + (sample_y_[second] - sample_y_[first]) * fraction
+               };
+    altitude = sample_altitude_[first] + (sample_altitude_[second] - sample_altitude_[first]) * fraction;
+    return true;
+}
+
+bool TrajectoryPredictor::Locate(size_t slot, double time, size_t& first, size_t& second, float& fraction) const {
+    if (slot >= valid_.size() || !valid_[slot]) {
+        return false;
+    }
+
+    const double offset = (time - start_time_[slot]) / SIM_PREDICTION_STEP;
+    if (offset < 0. || offset > sample_count_ - 1) {
+        return false;
+    }
+
+    const size_t index = std::min(static_cast<size_t>(offset), sample_count_ - 2);
+    fraction = static_cast<float>(offset - index);
+
+    // Вызывается на каждый срез каждого самолета, поэтому кольцо
+    // обходим без деления
+    first = head_[slot] + index;
+    if (first >= sample_count_) {
+        first -= sample_count_;
+    }
+    second = first + 1;
+    if (second == sample_count_) {
+        second = 0;
+    }
+    first += slot * sample_count_;
+    second += slot * sample_count_;
+    return true;
+}
+
+void TrajectoryPredictor::Reset(const KinematicsView& view, const VerticalView& vertical, size_t slot, double now) {
+    start_time_[slot] = now;
+    head_[slot] = 0;
+    valid_[slot] = 1;
+
+    sample_x_[slot * sample_count_] = view.x[slot];
+    sample_y_[slot * sample_count_] = view.y[slot];
+    sample_altitude_[slot * sample_count_] = vertical.altitude[slot];
+
+    end_x_[slot] = view.x[slot];
+    end_y_[slot] = view.y[slot];
+    end_angle_[slot] = view.angle[slot];
+    end_target_angle_[slot] = view.target_angle[slot];
+    end_tracking_[slot] = view.tracking[slot];
+    speed_[slot] = view.speed[slot];
+    angle_speed_[slot] = view.angle_speed[slot];
+    target_x_[slot] = view.target_x[slot];
+    target_y_[slot] = view.target_y[slot];
+    wind_x_[slot] = view.wind_x[slot];
+    wind_y_[slot] = view.wind_y[slot];
+    end_altitude_[slot] = vertical.altitude[slot];
+    end_vertical_rate_[slot] = vertical.vertical_rate[slot];
+    target_altitude_[slot] = vertical.target_altitude[slot];
+}
+
+void TrajectoryPredictor::ExtendRoute(const RouteTable& routes, size_t slot, uint32_t samples, double now) {
+    // Вертикальный профиль слота - вид из одной записи
+    const uint8_t active = 1;
+    const VerticalView vertical = { &end_altitude_[slot], &end_vertical_rate_[slot], &target_altitude_[slot], &active };
+    const size_t substeps = std::max<long>(std::lround(SIM_PREDICTION_STEP / SIM_PREDICTION_SUBSTEP), 1);
+    const float substep = SIM_PREDICTION_STEP / substeps;
+
+    // Путевая скорость зависит от направления участка, поэтому
+    // пройденный путь набирается шагами от текущего положения
+    const sf::Vector2f wind(wind_x_[slot], wind_y_[slot]);
+    double time = now;
+    float distance = 0.f;
+    RoutePose pose = routes.Evaluate(slot, distance);
+    for (size_t sample = sample_count_ - samples; sample < sample_count_; ++sample) {
+        const double sample_time = start_time_[slot] + sample * static_cast<double>(SIM_PREDICTION_STEP);
+        while (time < sample_time) {
+            const double step = std::min<double>(SIM_PREDICTION_STEP, sample_time - time);
+            distance += GetGroundSpeedAlongTrack(speed_[slot], pose.angle, wind) * static_cast<float>(step);
+            time += step;
+            pose = routes.Evaluate(slot, distance);
+        }
+        for (size_t i = 0; i < substeps; ++i) {
+            AdvanceVertical(vertical, 0, 1, substep);
+        }
+        const size_t index = slot * sample_count_ + (head_[slot] + sample) % sample_count_;
+        sample_x_[index] = pose.position.x;
+        sample_y_[index] = pose.position.y;
+        sample_altitude_[index] = end_altitude_[slot];
+    }
+
+    // За концом маршрута самолет летит прямо, так и продолжится путь,
+    // когда слот вернется под управление ядра
+    end_x_[slot] = pose.position.x;
+    end_y_[slot] = pose.position.y;
+    end_angle_[slot] = pose.angle;
+    end_target_angle_[slot] = pose.angle;
+    end_tracking_[slot] = 0;
+}
+
+void TrajectoryPredictor::Extend(size_t begin, size_t end) {
+    const KinematicsView view = {
+        batch_.x.data(), batch_.y.data(), batch_.angle.data(), batch_.target_angle.data(),
+        batch_.speed.data(), batch_.angle_speed.data(), batch_.target_x.data(), batch_.target_y.data(),
+        batch_.tracking.data(), batch_.active.data(), batch_.wind_x.data(), batch_.wind_y.data()
+    };
+    const VerticalView vertical = {
+        batch_.altitude.data(), batch_.vertical_rate.data(), batch_.target_altitude.data(), batch_.active.data()
+    };
+    const size_t substeps = std::max<long>(std::lround(SIM_PREDICTION_STEP / SIM_PREDICTION_SUBSTEP), 1);
+    const float substep = SIM_PREDICTION_STEP / substeps;
+
+    // Записи отсортированы по убыванию числа отсчетов, поэтому
+    // на отсчете sample работает префикс [begin, last)
+    size_t last = end;
+    for (uint32_t sample = 0; ; ++sample) {
+        while (last > begin && batch_.samples[last - 1] <= sample) {
+            --last;
+        }
+        if (last == begin) {
+            break;
+        }
+
+        for (size_t i = 0; i < substeps; ++i) {
+            kernel_.Advance(view, begin, last, substep);
+            AdvanceVertical(vertical, begin, last, substep);
+        }
+
+        // Новые отсчеты ложатся в конец кольца
+        for (size_t i = begin; i < last; ++i) {
+            const size_t slot = batch_.slot[i];
+            const size_t index = slot * sample_count_ + (head_[slot] + sample_count_ - batch_.samples[i] + sample) % sample_count_;
+            sample_x_[index] = batch_.x[i];
+            sample_y_[index] = batch_.y[i];
+            sample_altitude_[index] = batch_.altitude[i];
+        }
+    }
+}
+
+} // namespace sim
\ No newline at end of file
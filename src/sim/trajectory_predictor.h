@@ -0,0 +1,130 @@
+#pragma once
+
+#include "../global_parameters.h"
+#include "kinematics.h"
+#include "route_table.h"
+#include "task_scheduler.h"
+#include "vertical_profile.h"
+#include "wind_field.h"
+
+#include <cstdint>
+#include <vector>
+#include <SFML/System/Vector2.hpp>
+
+/*
+   Прогноз траекторий на SIM_PREDICTION_HORIZON секунд вперед. Путь
+   каждого самолета считается тем же законом управления, что и шаг
+   Fleet (SteeringKernel, подшагами по SIM_PREDICTION_SUBSTEP), и
+   хранится кольцом из отсчетов через SIM_PREDICTION_STEP секунд.
+
+   Пока самолету не меняли цель, скорость, курс или положение, его
+   путь остается верным, поэтому не пересчитывается: по мере хода
+   времени из кольца уходят прошедшие отсчеты, а в конец
+   досчитываются новые от сохраненного конечного состояния.
+   Заново путь строится только после Invalidate. Все досчеты одного
+   Update собираются в плотные массивы и считаются пакетно на
+   потоках TaskScheduler. Отсчеты самолетов на маршруте берутся
+   прямо из геометрии маршрута (RouteTable::Evaluate). Высота
+   прогнозируется тем же вертикальным профилем (AdvanceVertical),
+   что и в Fleet, и хранится в кольце рядом с положением. Ветер
+   берется тот, что был у самолета при построении пути, и до
+   следующего Invalidate считается постоянным.
+*/
+
+namespace sim {
+
+class TrajectoryPredictor {
+public:
+    TrajectoryPredictor();
+
+    // nullptr - прогноз в текущем потоке
+    void SetScheduler(TaskScheduler* scheduler);
+
+    // Путь слота будет построен заново при следующем Update
+    void Invalidate(size_t slot);
+
+    // Доводит пути всех активных слотов до горизонта от момента now
+    void Update(const KinematicsView& view, const VerticalView& vertical, const RouteTable& routes, size_t count, double now);
+
+    size_t Size() const;
+
+    static size_t GetSampleCount();
+
+    // Положение слота в момент time. false, если пути нет или момент
+    // вне прогноза
+    bool GetPosition(size_t slot, double time, sf::Vector2f& position) const;
+
+    // То же вместе с высотой
+    bool GetPosition(size_t slot, double time, sf::Vector2f& position, float& altitude) const;
+
+private:
+    // Плотные массивы путей, которые досчитываются в этом Update
+    struct Batch {
+        std::vector<uint32_t> slot;
+        std::vector<uint32_t> samples;
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> angle;
+        std::vector<float> target_angle;
+        std::vector<float> speed;
+        std::vector<float> angle_speed;
+        std::vector<float> target_x;
+        std::vector<float> target_y;
+        std::vector<uint8_t> tracking;
+        std::vector<uint8_t> active;
+        std::vector<float> wind_x;
+        std::vector<float> wind_y;
+        std::vector<float> altitude;
+        std::vector<float> vertical_rate;
+        std::vector<float> target_altitude;
+
+        void Resize(size_t size);
+    };
+
+    void Reset(const KinematicsView& view, const VerticalView& vertical, size_t slot, double now);
+
+    // Индексы отсчетов слота вокруг момента time и доля между ними
+    bool Locate(size_t slot, double time, size_t& first, size_t& second, float& fraction) const;
+
+    void Extend(size_t begin, size_t end);
+
+    // Досчитывает samples отсчетов слота на маршруте по его геометрии
+    void ExtendRoute(const RouteTable& routes, size_t slot, uint32_t samples, double now);
+
+private:
+    size_t sample_count_;
+    TaskScheduler* scheduler_ = nullptr;
+    SteeringKernel kernel_;
+
+    // Кольца отсчетов, sample_count_ на слот
+    std::vector<float> sample_x_;
+    std::vector<float> sample_y_;
+    std::vector<float> sample_altitude_;
+
+    // Момент отсчета, лежащего в кольце под индексом head_
+    std::vector<double> start_time_;
+    std::vector<uint32_t> head_;
+    std::vector<uint8_t> valid_;
+
+    // Состояние в момент последнего отсчета и параметры, с которыми
+    // строился путь
+    std::vector<float> end_x_;
+    std::vector<float> end_y_;
+    std::vector<float> end_angle_;
+    std::vector<float> end_target_angle_;
+    std::vector<uint8_t> end_tracking_;
+    std::vector<float> end_altitude_;
+    std::vector<float> end_vertical_rate_;
+    std::vector<float> speed_;
+    std::vector<float> angle_speed_;
+    std::vector<float> target_x_;
+    std::vector<float> target_y_;
+    std::vector<float> target_altitude_;
+    std::vector<float> wind_x_;
+    std::vector<float> wind_y_;
+
+    std::vector<uint32_t> needed_;
+    Batch batch_;
+};
+
+} // namespace sim
\ No newline at end of file
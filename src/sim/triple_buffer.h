@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/*
+   Тройной буфер без блокировок для передачи состояния от одного
+   писателя одному читателю. Писатель всегда пишет в свой задний
+   буфер и публикует его обменом со средним; читатель забирает
+   средний буфер, только если там появилось что-то новое. Ни одна
+   из сторон никогда не ждет другую: читатель получает последний
+   полностью записанный кадр, промежуточные кадры просто теряются.
+*/
+
+namespace sim {
+
+template <class T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+
+    // Буфер, в который пишет писатель. Содержимое - один из старых кадров
+    T& GetWriteBuffer() {
+        return buffers_[back_];
+    }
+
+    // Публикует записанный буфер
+    void Publish() {
+        const uint8_t previous = middle_.exchange(back_ | FRESH_BIT, std::memory_order_acq_rel);
+        back_ = previous & INDEX_MASK;
+    }
+
+    // Возвращает последний опубликованный буфер. Ссылка действительна
+    // до следующего вызова Acquire()
+    const T& Acquire() {
+        if (middle_.load(std::memory_order_relaxed) & FRESH_BIT) {
+            const uint8_t previous = middle_.exchange(front_, std::memory_order_acq_rel);
+            front_ = previous & INDEX_MASK;
+        }
+        return buffers_[front_];
+    }
+
+private:
+    static constexpr uint8_t FRESH_BIT = 0x4;
+    static constexpr uint8_t INDEX_MASK = 0x3;
+
+    std::array<T, 3> buffers_;
+
+    // Индексы заднего и переднего буферов принадлежат каждый своей
+    // стороне, общий только средний
+    uint8_t back_ = 0;
+    alignas(64) std::atomic<uint8_t> middle_{ 1 };
+    alignas(64) uint8_t front_ = 2;
+};
+
+} // namespace sim
\ No newline at end of file
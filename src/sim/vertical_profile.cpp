@@ -0,0 +1,41 @@
+#include "vertical_profile.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace global_parameters;
+
+namespace sim {
+
+float GetClimbRateLimit(float altitude) {
+    return SIM_CLIMB_RATE * std::max(1.f - altitude / SIM_SERVICE_CEILING, 0.f);
+}
+
+void AdvanceVertical(const VerticalView& view, size_t begin, size_t end, float dt) {
+    const float acceleration = SIM_VERTICAL_ACCELERATION;
+    const float max_change = acceleration * dt;
+
+    for (size_t slot = begin; slot < end; ++slot) {
+        const float altitude = view.altitude[slot];
+        const float rate = view.vertical_rate[slot];
+        const float error = view.target_altitude[slot] - altitude;
+
+        // Скорость, с которой еще можно остановиться точно на заданной
+        // высоте, обрезанная характеристиками самолета
+        const float braking = std::sqrt(2.f * acceleration * std::abs(error));
+        const float desired = std::clamp(std::copysign(braking, error), -SIM_DESCENT_RATE, GetClimbRateLimit(altitude));
+        float new_rate = std::clamp(desired, rate - max_change, rate + max_change);
+        float new_altitude = altitude + new_rate * dt;
+
+        // Проскочили заданную высоту за шаг - выравниваемся на ней
+        const bool passed = (view.target_altitude[slot] - new_altitude) * error <= 0.f;
+        new_altitude = passed ? view.target_altitude[slot] : new_altitude;
+        new_rate = passed ? 0.f : new_rate;
+
+        const bool active = view.active[slot] != 0;
+        view.altitude[slot] = active ? new_altitude : altitude;
+        view.vertical_rate[slot] = active ? new_rate : rate;
+    }
+}
+
+} // namespace sim
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "../global_parameters.h"
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+   Вертикальный профиль полета: набор и снижение к заданной высоте
+   с ограничениями по характеристикам самолета. Вертикальная скорость
+   не больше SIM_CLIMB_RATE в наборе (доступная скороподъемность
+   линейно падает до нуля к SIM_SERVICE_CEILING) и не больше
+   SIM_DESCENT_RATE в снижении, а меняется с ускорением не больше
+   SIM_VERTICAL_ACCELERATION. К заданной высоте самолет подходит по
+   кривой торможения sqrt(2 * a * остаток), поэтому выравнивается
+   без перелета.
+
+   Закон записан прямолинейным циклом без ветвлений над столбцами
+   Fleet, его векторизует компилятор. Курс и горизонтальное движение
+   считает SteeringKernel или RouteTable, высота от них не зависит.
+*/
+
+namespace sim {
+
+// Указатели на вертикальные столбцы Fleet
+struct VerticalView {
+    float* altitude;
+    float* vertical_rate;
+    const float* target_altitude;
+    const uint8_t* active;
+};
+
+// Продвигает вертикальное движение слотов [begin, end) на dt секунд
+void AdvanceVertical(const VerticalView& view, size_t begin, size_t end, float dt);
+
+// Наибольшая скороподъемность на высоте altitude, м/с
+float GetClimbRateLimit(float altitude);
+
+} // namespace sim
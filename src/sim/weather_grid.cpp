@@ -0,0 +1,175 @@
+#include "weather_grid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace sim {
+
+namespace {
+
+constexpr char WEATHER_GRID_MAGIC[8] = { 'A', 'W', 'G', 'R', 'I', 'D', '1', '\0' };
+
+// Разумный предел размера сетки, чтобы поврежденный заголовок не
+// заставил выделить гигабайты
+constexpr uint64_t WEATHER_GRID_MAX_NODES = 1ull << 26;
+
+template <typename T>
+bool ReadValue(std::ifstream& file, T& value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+bool ReadFloats(std::ifstream& file, std::vector<float>& values, size_t count) {
+    values.resize(count);
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(values.data()), count * sizeof(float)));
+}
+
+// Начало оси должно быть числом, шаг - еще и положительным: NaN не
+// проходит ни одно сравнение и иначе попал бы в индексы Locate
+bool IsValidAxis(float first, float step) {
+    return std::isfinite(first) && std::isfinite(step) && step > 0.f;
+}
+
+} // namespace
+
+bool WeatherGrid::Load(const std::string& path) {
+    std::ifstream file{ path, std::ios::binary };
+    if (!file.is_open()) {
+        return false;
+    }
+
+    char magic[sizeof(WEATHER_GRID_MAGIC)];
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, WEATHER_GRID_MAGIC, sizeof(magic)) != 0) {
+        return false;
+    }
+
+    WeatherGrid grid;
+    if (!ReadValue(file, grid.longitude_count_) || !ReadValue(file, grid.latitude_count_) || !ReadValue(file, grid.level_count_)
+        || !ReadValue(file, grid.first_longitude_) || !ReadValue(file, grid.first_latitude_)
+        || !ReadValue(file, grid.longitude_step_) || !ReadValue(file, grid.latitude_step_)) {
+        return false;
+    }
+
+    const uint64_t nodes = static_cast<uint64_t>(grid.longitude_count_) * grid.latitude_count_ * grid.level_count_;
+    if (nodes == 0 || nodes > WEATHER_GRID_MAX_NODES || !IsValidAxis(grid.first_longitude_, grid.longitude_step_)
+        || !IsValidAxis(grid.first_latitude_, grid.latitude_step_)) {
+        return false;
+    }
+
+    if (!ReadFloats(file, grid.levels_, grid.level_count_) || !std::is_sorted(grid.levels_.begin(), grid.levels_.end())) {
+        return false;
+    }
+
+    if (!ReadFloats(file, grid.wind_east_, nodes) || !ReadFloats(file, grid.wind_north_, nodes)
+        || !ReadFloats(file, grid.temperature_, nodes) || !ReadFloats(file, grid.pressure_, nodes)) {
+        return false;
+    }
+
+    *this = std::move(grid);
+    return true;
+}
+
+bool WeatherGrid::IsLoaded() const {
+    return level_count_ > 0;
+}
+
+void WeatherGrid::Sample(const double* latitude, const double* longitude, const float* altitude, size_t count,
+                         const WeatherSamples& samples) const {
+    if (!IsLoaded()) {
+        return;
+    }
+
+    const size_t row = longitude_count_;
+    const size_t layer = static_cast<size_t>(longitude_count_) * latitude_count_;
+    const float inverse_longitude_step = 1.f / longitude_step_;
+    const float inverse_latitude_step = 1.f / latitude_step_;
+
+    for (size_t i = 0; i < count; ++i) {
+        size_t lon_index;
+        size_t lat_index;
+        size_t level_index;
+        float lon_fraction;
+        float lat_fraction;
+        float level_fraction;
+        Locate((static_cast<float>(longitude[i]) - first_longitude_) * inverse_longitude_step, longitude_count_, lon_index, lon_fraction);
+        Locate((static_cast<float>(latitude[i]) - first_latitude_) * inverse_latitude_step, latitude_count_, lat_index, lat_fraction);
+        LocateLevel(altitude[i], level_index, level_fraction);
+
+        // Шаг к соседнему узлу по каждой оси, на краю сетки - ноль
+        const size_t lon_next = lon_index + 1 < longitude_count_ ? 1 : 0;
+        const size_t lat_next = lat_index + 1 < latitude_count_ ? row : 0;
+        const size_t level_next = level_index + 1 < level_count_ ? layer : 0;
+
+        // Веса восьми узлов вокруг точки
+        const float w00 = (1.f - lon_fraction) * (1.f - lat_fraction);
+        const float w10 = lon_fraction * (1.f - lat_fraction);
+        const float w01 = (1.f - lon_fraction) * lat_fraction;
+        const float w11 = lon_fraction * lat_fraction;
+        const float lower = 1.f - level_fraction;
+        const float upper = level_fraction;
+
+        const size_t base = level_index * layer + lat_index * row + lon_index;
+
+        auto interpolate = [&](const std::vector<float>& field) {
+            const float* node = field.data() + base;
+            const float bottom = w00 * node[0] + w10 * node[lon_next] + w01 * node[lat_next] + w11 * node[lat_next + lon_next];
+            node += level_next;
+            const float top = w00 * node[0] + w10 * node[lon_next] + w01 * node[lat_next] + w11 * node[lat_next + lon_next];
+            return lower * bottom + upper * top;
+        };
+
+        if (samples.wind_east != nullptr) {
+            samples.wind_east[i] = interpolate(wind_east_);
+        }
+        if (samples.wind_north != nullptr) {
+            samples.wind_north[i] = interpolate(wind_north_);
+        }
+        if (samples.temperature != nullptr) {
+            samples.temperature[i] = interpolate(temperature_);
+        }
+        if (samples.pressure != nullptr) {
+            samples.pressure[i] = interpolate(pressure_);
+        }
+    }
+}
+
+size_t WeatherGrid::GetLongitudeCount() const {
+    return longitude_count_;
+}
+
+size_t WeatherGrid::GetLatitudeCount() const {
+    return latitude_count_;
+}
+
+size_t WeatherGrid::GetLevelCount() const {
+    return level_count_;
+}
+
+void WeatherGrid::Locate(float offset, size_t count, size_t& index, float& fraction) {
+    const float last = static_cast<float>(count - 1);
+    offset = std::min(std::max(offset, 0.f), last);
+    index = std::min(static_cast<size_t>(offset), count > 1 ? count - 2 : 0);
+    fraction = offset - static_cast<float>(index);
+}
+
+void WeatherGrid::LocateLevel(float altitude, size_t& index, float& fraction) const {
+    // Уровней немного, поэтому хватает двоичного поиска по их высотам
+    const auto upper = std::upper_bound(levels_.begin(), levels_.end(), altitude);
+    if (upper == levels_.begin()) {
+        index = 0;
+        fraction = 0.f;
+        return;
+    }
+    if (upper == levels_.end()) {
+        index = level_count_ - 1;
+        fraction = 0.f;
+        return;
+    }
+
+    index = static_cast<size_t>(upper - levels_.begin()) - 1;
+    const float thickness = levels_[index + 1] - levels_[index];
+    fraction = thickness > 0.f ? (altitude - levels_[index]) / thickness : 0.f;
+}
+
+} // namespace sim
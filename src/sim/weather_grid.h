@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+   Сеточная погода: ветер, температура и давление в узлах сетки
+   широта x долгота x высота, загруженные из локального файла. Все
+   поля хранятся в float32 отдельными плотными массивами с порядком
+   [уровень][широта][долгота], так что соседние по долготе узлы
+   лежат рядом в памяти.
+
+   Sample отвечает на пакет точек сразу: по горизонтали значения
+   интерполируются билинейно, между уровнями - линейно (трилинейная
+   интерполяция). Точки за краем сетки получают значения края.
+   Сеть в горячем пути не нужна - файл читается один раз.
+
+   Формат файла (little-endian):
+     char[8]  "AWGRID1\0"
+     uint32   число узлов по долготе, по широте и число уровней
+     float32  долгота и широта первого узла, шаг по долготе и по
+              широте, градусы
+     float32  высоты уровней, метры, по возрастанию
+     float32  поля u (на восток, м/с), v (на север, м/с),
+              температура (°C), давление (гПа) - каждое целиком,
+              в порядке [уровень][широта][долгота]
+*/
+
+namespace sim {
+
+// Выходные столбцы Sample, ненужные могут быть nullptr
+struct WeatherSamples {
+    float* wind_east;
+    float* wind_north;
+    float* temperature;
+    float* pressure;
+};
+
+class WeatherGrid {
+public:
+    WeatherGrid() = default;
+
+    // false, если файла нет или он поврежден; прежняя сетка при этом
+    // не меняется
+    bool Load(const std::string& path);
+
+    bool IsLoaded() const;
+
+    // Интерполирует поля в count точках
+    void Sample(const double* latitude, const double* longitude, const float* altitude, size_t count,
+                const WeatherSamples& samples) const;
+
+    size_t GetLongitudeCount() const;
+
+    size_t GetLatitudeCount() const;
+
+    size_t GetLevelCount() const;
+
+private:
+    // Ячейка сетки вокруг точки: индекс первого узла по оси и доля до
+    // следующего
+    static void Locate(float offset, size_t count, size_t& index, float& fraction);
+
+    void LocateLevel(float altitude, size_t& index, float& fraction) const;
+
+private:
+    uint32_t longitude_count_ = 0;
+    uint32_t latitude_count_ = 0;
+    uint32_t level_count_ = 0;
+
+    float first_longitude_ = 0.f;
+    float first_latitude_ = 0.f;
+    float longitude_step_ = 1.f;
+    float latitude_step_ = 1.f;
+
+    std::vector<float> levels_;
+
+    std::vector<float> wind_east_;
+    std::vector<float> wind_north_;
+    std::vector<float> temperature_;
+    std::vector<float> pressure_;
+};
+
+} // namespace sim
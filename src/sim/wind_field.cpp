@@ -0,0 +1,256 @@
+#include "wind_field.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace global_parameters;
+
+namespace sim {
+
+namespace {
+
+constexpr uint64_t INACTIVE_CELL = std::numeric_limits<uint64_t>::max();
+
+// Слой не бывает отрицательным, поэтому ключ ячейки не совпадает с пустым
+constexpr uint64_t EMPTY_CELL = INACTIVE_CELL;
+
+constexpr size_t MIN_CELL_TABLE_SIZE = 64;
+
+// Высота флюгера, к которой относится приземный ветер, метры
+constexpr float WIND_REFERENCE_HEIGHT = 10.f;
+
+constexpr float WIND_PROFILE_EXPONENT = 1.f / 7.f;
+
+} // namespace
+
+float GetGroundSpeedAlongTrack(float airspeed, float track_angle, const sf::Vector2f& wind) {
+    const float track_cos = std::cos(track_angle);
+    const float track_sin = std::sin(track_angle);
+    const float along_wind = wind.x * track_cos + wind.y * track_sin;
+    const float cross_wind = wind.y * track_cos - wind.x * track_sin;
+    const float air_along = std::sqrt(std::max(airspeed * airspeed - cross_wind * cross_wind, 0.f));
+    return std::max(along_wind + air_along, 0.f);
+}
+
+void WindField::SetSurfaceWind(const sf::Vector2f& wind) {
+    surface_wind_ = wind;
+    ClearCells();
+}
+
+sf::Vector2f WindField::GetSurfaceWind() const {
+    return surface_wind_;
+}
+
+void WindField::SetGrid(const WeatherGrid* grid, const Projection* projection) {
+    grid_ = grid;
+    projection_ = projection;
+    ClearCells();
+}
+
+sf::Vector2f WindField::SampleAt(float east, float north, float altitude) const {
+    if (HasGrid()) {
+        const GeoPoint point = projection_->EnuToGeo({ east, north });
+        sf::Vector2f wind;
+        grid_->Sample(&point.latitude, &point.longitude, &altitude, 1, { &wind.x, &wind.y, nullptr, nullptr });
+        return wind;
+    }
+
+    const float height = std::max(altitude, WIND_REFERENCE_HEIGHT);
+    return surface_wind_ * std::pow(height / WIND_REFERENCE_HEIGHT, WIND_PROFILE_EXPONENT);
+}
+
+void WindField::Sample(const float* x, const float* y, const float* altitude, const uint8_t* active, size_t count,
+                       float* wind_x, float* wind_y) {
+    // Новые слоты пока ни в какой ячейке. Если флот очищали, слоты
+    // могли смениться, и прошлым ячейкам верить нельзя
+    if (count < slot_cell_.size()) {
+        slot_cell_.resize(count);
+        ClearCells();
+    }
+    slot_cell_.resize(count, INACTIVE_CELL);
+
+    const float inverse_cell_size = 1.f / SIM_WIND_CELL_SIZE;
+    const float inverse_band_height = 1.f / SIM_WIND_BAND_HEIGHT;
+
+    pending_.clear();
+    changed_.clear();
+
+    for (size_t slot = 0; slot < count; ++slot) {
+        if (!active[slot]) {
+            if (slot_cell_[slot] != INACTIVE_CELL) {
+                LeaveCell(slot_cell_[slot]);
+            }
+            slot_cell_[slot] = INACTIVE_CELL;
+            wind_x[slot] = 0.f;
+            wind_y[slot] = 0.f;
+            continue;
+        }
+
+        const int32_t cell_x = static_cast<int32_t>(std::floor(x[slot] * inverse_cell_size));
+        const int32_t cell_y = static_cast<int32_t>(std::floor(y[slot] * inverse_cell_size));
+        const int32_t band = std::max(static_cast<int32_t>(std::floor(altitude[slot] * inverse_band_height)), 0);
+        const uint64_t key = GetCellKey(cell_x, cell_y, band);
+        if (key == slot_cell_[slot]) {
+            continue;
+        }
+        if (slot_cell_[slot] != INACTIVE_CELL) {
+            LeaveCell(slot_cell_[slot]);
+        }
+        slot_cell_[slot] = key;
+        changed_.push_back(static_cast<uint32_t>(slot));
+
+        // Новые ячейки копятся и считаются одним пакетом ниже
+        if (EnterCell(key)) {
+            pending_.push_back({ cell_x, cell_y, band, key });
+        }
+    }
+
+    if (!pending_.empty()) {
+        SampleCells();
+    }
+
+    for (uint32_t slot : changed_) {
+        const sf::Vector2f& wind = cells_[FindCell(slot_cell_[slot])].wind;
+        wind_x[slot] = wind.x;
+        wind_y[slot] = wind.y;
+    }
+}
+
+size_t WindField::GetCachedCellCount() const {
+    return cell_count_;
+}
+
+bool WindField::HasGrid() const {
+    return grid_ != nullptr && projection_ != nullptr && grid_->IsLoaded();
+}
+
+void WindField::SampleCells() {
+    const size_t count = pending_.size();
+    east_.resize(count);
+    north_.resize(count);
+    altitude_.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        east_[i] = (pending_[i].cell_x + 0.5f) * SIM_WIND_CELL_SIZE;
+        north_[i] = (pending_[i].cell_y + 0.5f) * SIM_WIND_CELL_SIZE;
+        altitude_[i] = (pending_[i].band + 0.5f) * SIM_WIND_BAND_HEIGHT;
+    }
+
+    if (HasGrid()) {
+        latitude_.resize(count);
+        longitude_.resize(count);
+        wind_east_.resize(count);
+        wind_north_.resize(count);
+        projection_->ToGeo(east_.data(), north_.data(), count, latitude_.data(), longitude_.data());
+        grid_->Sample(latitude_.data(), longitude_.data(), altitude_.data(), count,
+                      { wind_east_.data(), wind_north_.data(), nullptr, nullptr });
+        for (size_t i = 0; i < count; ++i) {
+            cells_[FindCell(pending_[i].key)].wind = { wind_east_[i], wind_north_[i] };
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        cells_[FindCell(pending_[i].key)].wind = SampleAt(east_[i], north_[i], altitude_[i]);
+    }
+}
+
+bool WindField::EnterCell(uint64_t key) {
+    const size_t found = FindCell(key);
+    if (found != cells_.size()) {
+        ++cells_[found].occupants;
+        return false;
+    }
+
+    // Таблица растет вдвое, когда заполнена наполовину
+    if (2 * (cell_count_ + 1) > cells_.size()) {
+        std::vector<CachedCell> old_cells(std::max(2 * cells_.size(), MIN_CELL_TABLE_SIZE), { EMPTY_CELL, {}, 0 });
+        old_cells.swap(cells_);
+        const size_t mask = cells_.size() - 1;
+        for (const CachedCell& cell : old_cells) {
+            if (cell.key != EMPTY_CELL) {
+                size_t index = GetCellHash(cell.key) & mask;
+                while (cells_[index].key != EMPTY_CELL) {
+                    index = (index + 1) & mask;
+                }
+                cells_[index] = cell;
+            }
+        }
+    }
+
+    const size_t mask = cells_.size() - 1;
+    size_t index = GetCellHash(key) & mask;
+    while (cells_[index].key != EMPTY_CELL) {
+        index = (index + 1) & mask;
+    }
+    cells_[index] = { key, {}, 1 };
+    ++cell_count_;
+    return true;
+}
+
+void WindField::LeaveCell(uint64_t key) {
+    size_t hole = FindCell(key);
+    if (hole == cells_.size() || --cells_[hole].occupants != 0) {
+        return;
+    }
+    --cell_count_;
+
+    // Удаление со сдвигом назад: записи за дыркой, которые могли бы
+    // стоять на ее месте, переносятся в нее, чтобы поиск не обрывался
+    const size_t mask = cells_.size() - 1;
+    size_t index = hole;
+    while (true) {
+        index = (index + 1) & mask;
+        if (cells_[index].key == EMPTY_CELL) {
+            break;
+        }
+        const size_t home = GetCellHash(cells_[index].key) & mask;
+        if (((index - home) & mask) >= ((index - hole) & mask)) {
+            cells_[hole] = cells_[index];
+            hole = index;
+        }
+    }
+    cells_[hole].key = EMPTY_CELL;
+}
+
+size_t WindField::FindCell(uint64_t key) const {
+    if (cells_.empty()) {
+        return 0;
+    }
+    const size_t mask = cells_.size() - 1;
+    size_t index = GetCellHash(key) & mask;
+    while (cells_[index].key != EMPTY_CELL) {
+        if (cells_[index].key == key) {
+            return index;
+        }
+        index = (index + 1) & mask;
+    }
+    return cells_.size();
+}
+
+void WindField::ClearCells() {
+    for (CachedCell& cell : cells_) {
+        cell.key = EMPTY_CELL;
+    }
+    cell_count_ = 0;
+    slot_cell_.assign(slot_cell_.size(), INACTIVE_CELL);
+}
+
+uint64_t WindField::GetCellKey(int32_t cell_x, int32_t cell_y, int32_t band) {
+    // 24 бита на каждую координату ячейки по горизонтали и 16 на слой
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cell_x) & 0xFFFFFF) << 40)
+           | (static_cast<uint64_t>(static_cast<uint32_t>(cell_y) & 0xFFFFFF) << 16)
+           | (static_cast<uint32_t>(band) & 0xFFFF);
+}
+
+size_t WindField::GetCellHash(uint64_t key) {
+    // Перемешивание из splitmix64: соседние ячейки не идут подряд
+    key ^= key >> 30;
+    key *= 0xBF58476D1CE4E5B9ull;
+    key ^= key >> 27;
+    key *= 0x94D049BB133111EBull;
+    key ^= key >> 31;
+    return static_cast<size_t>(key);
+}
+
+} // namespace sim
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "../global_parameters.h"
+#include "projection.h"
+#include "weather_grid.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <SFML/System/Vector2.hpp>
+
+/*
+   Поле ветра для модели полета. Пространство режется на ячейки
+   SIM_WIND_CELL_SIZE по горизонтали и SIM_WIND_BAND_HEIGHT по высоте,
+   ветер считается один раз на ячейку (в ее центре) и кешируется.
+   Самолеты одной ячейки получают одно и то же значение, поэтому
+   цена выборки определяется числом занятых ячеек, а не числом
+   самолетов. Пока самолет не сменил ячейку, его ветер не
+   перечитывается даже из кеша.
+
+   В кеше лежат только ячейки, в которых сейчас есть самолеты: у
+   ячейки есть счетчик самолетов, и когда последний уходит, ячейка
+   удаляется. Поэтому кеш не растет за долгий сеанс, а таблица с
+   открытой адресацией выделяет память только при росте флота.
+
+   Источник - сеточная погода (WeatherGrid), если она загружена:
+   центры новых ячеек одного вызова Sample переводятся в широту и
+   долготу и интерполируются по сетке одним пакетом. Без сетки -
+   приземный ветер из WeatherHandler, поднятый на высоту по
+   степенному закону профиля ветра v(h) = v0 * (h / h0)^(1/7).
+   Смена источника сбрасывает кеш.
+*/
+
+namespace sim {
+
+// Путевая скорость самолета, который держит линию пути track_angle
+// при ветре wind: попутная составляющая ветра плюс часть воздушной
+// скорости, оставшаяся после компенсации боковой
+float GetGroundSpeedAlongTrack(float airspeed, float track_angle, const sf::Vector2f& wind);
+
+class WindField {
+public:
+    WindField() = default;
+
+    // Приземный ветер в ENU, м/с (куда дует, а не откуда)
+    void SetSurfaceWind(const sf::Vector2f& wind);
+
+    sf::Vector2f GetSurfaceWind() const;
+
+    // Сетка погоды и проекция для перевода ENU в широту и долготу.
+    // Пока сетка загружена, она заменяет приземный ветер. nullptr -
+    // без сетки
+    void SetGrid(const WeatherGrid* grid, const Projection* projection);
+
+    // Ветер в точке без кеша
+    sf::Vector2f SampleAt(float east, float north, float altitude) const;
+
+    // Заполняет wind_x, wind_y для активных слотов [0, count) по
+    // ячейкам, неактивным ставит штиль
+    void Sample(const float* x, const float* y, const float* altitude, const uint8_t* active, size_t count,
+                float* wind_x, float* wind_y);
+
+    // Число ячеек в кеше
+    size_t GetCachedCellCount() const;
+
+private:
+    // Запись таблицы кеша, key == EMPTY_CELL - свободна
+    struct CachedCell {
+        uint64_t key;
+        sf::Vector2f wind;
+        uint32_t occupants;
+    };
+
+    // Ячейка, которой еще нет в кеше
+    struct PendingCell {
+        int32_t cell_x;
+        int32_t cell_y;
+        int32_t band;
+        uint64_t key;
+    };
+
+    bool HasGrid() const;
+
+    // Считает ветер в центрах pending_ и кладет его в кеш
+    void SampleCells();
+
+    // Самолет вошел в ячейку: true, если ее еще не было в кеше
+    bool EnterCell(uint64_t key);
+
+    // Самолет покинул ячейку; ячейка без самолетов удаляется
+    void LeaveCell(uint64_t key);
+
+    // Номер записи ячейки или cells_.size(), если ее нет
+    size_t FindCell(uint64_t key) const;
+
+    void ClearCells();
+
+    static uint64_t GetCellKey(int32_t cell_x, int32_t cell_y, int32_t band);
+
+    static size_t GetCellHash(uint64_t key);
+
+private:
+    sf::Vector2f surface_wind_ = { 0.f, 0.f };
+    const WeatherGrid* grid_ = nullptr;
+    const Projection* projection_ = nullptr;
+
+    // Кеш занятых ячеек: линейное пробирование, размер - степень
+    // двойки, заполнен не больше чем наполовину
+    std::vector<CachedCell> cells_;
+    size_t cell_count_ = 0;
+
+    // Ячейка каждого слота при прошлой выборке, для неактивных - INACTIVE_CELL
+    std::vector<uint64_t> slot_cell_;
+
+    // Рабочие массивы Sample: новые ячейки, слоты со сменившейся
+    // ячейкой и координаты центров для пакетной выборки из сетки
+    std::vector<PendingCell> pending_;
+    std::vector<uint32_t> changed_;
+    std::vector<float> east_;
+    std::vector<float> north_;
+    std::vector<float> altitude_;
+    std::vector<double> latitude_;
+    std::vector<double> longitude_;
+    std::vector<float> wind_east_;
+    std::vector<float> wind_north_;
+};
+
+} // namespace sim
@@ -0,0 +1,232 @@
+#include "../sim/fleet.h"
+#include "../sim/wind_field.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+/*
+   Сверка пакетного ядра кинематики (SteeringKernel) с исходным
+   скалярным законом управления (Fleet::StepReference):
+     kinematics_test
+
+   Случайные флоты (1003 самолета - не кратно ширине AVX2, часть
+   слотов неактивна) шагают через ветки SCALAR, SSE4.1 и AVX2 и через
+   StepReference. Ветки ядра должны совпадать между собой побитово,
+   с эталоном - в пределах допусков ниже. Проверяются случаи:
+     far       - цель далеко и позади, разворот на большой угол
+     near      - цель в нескольких шагах, проверка доворота у цели
+     stop      - цель ближе 5 шагов, слежение должно сняться
+     wind      - далекая цель при сильном боковом ветре
+     long      - 600 шагов подряд к далеким целям
+
+   Ветки, которые процессор не поддерживает, пропускаются. Код
+   возврата 1, если хоть одна проверка не прошла.
+*/
+
+using namespace sim;
+
+namespace {
+
+// Допуски относительно эталона: за один шаг из одинакового состояния
+// и за 600 шагов (расхождение копится из-за разных atan2/sin/cos)
+constexpr float STEP_POSITION_TOLERANCE = 1e-3f;
+constexpr float STEP_ANGLE_TOLERANCE = 1e-4f;
+constexpr float LONG_POSITION_TOLERANCE = 0.1f;
+constexpr float LONG_ANGLE_TOLERANCE = 1e-3f;
+
+constexpr size_t FLEET_SIZE = 1003;
+constexpr float DT = 1.f / 60.f;
+
+enum class Case {
+    FAR,
+    NEAR,
+    STOP,
+    WIND
+};
+
+const char* GetCaseName(Case test_case) {
+    switch (test_case) {
+        case Case::FAR:
+            return "far";
+        case Case::NEAR:
+            return "near";
+        case Case::STOP:
+            return "stop";
+        case Case::WIND:
+            return "wind";
+    }
+    return "";
+}
+
+const char* GetInstructionSetName(InstructionSet instruction_set) {
+    switch (instruction_set) {
+        case InstructionSet::SSE41:
+            return "sse4.1";
+        case InstructionSet::AVX2:
+            return "avx2";
+        default:
+            return "scalar";
+    }
+}
+
+// Флот со случайными самолетами; цель задается по случаю относительно
+// длины одного шага самолета
+Fleet MakeFleet(Case test_case, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> coordinate(-20000.f, 20000.f);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    std::uniform_real_distribution<float> angle(-3.14159265f, 3.14159265f);
+
+    Fleet fleet;
+    fleet.Reserve(FLEET_SIZE);
+    for (size_t i = 0; i < FLEET_SIZE; ++i) {
+        const float heading = angle(gen);
+        const size_t slot = fleet.Add({ coordinate(gen), coordinate(gen) }, heading);
+        const float speed = 100.f + 300.f * unit(gen);
+        fleet.SetSpeed(slot, speed);
+        fleet.SetAngleSpeed(slot, 0.01f + 0.09f * unit(gen));
+
+        const float step_length = speed * DT;
+        float distance = 0.f;
+        float bearing = angle(gen);
+        switch (test_case) {
+            case Case::FAR:
+            case Case::WIND:
+                // Цель позади: разворот больше чем на pi/2
+                distance = 5000.f + 5000.f * unit(gen);
+                bearing = heading + 3.14159265f * (0.5f + unit(gen));
+                break;
+            case Case::NEAR:
+                distance = step_length * (5.5f + 10.f * unit(gen));
+                break;
+            case Case::STOP:
+                distance = step_length * 4.5f * unit(gen);
+                break;
+        }
+        const sf::Vector2f position = fleet.GetPosition(slot);
+        fleet.SetTargetPosition(slot, { position.x + distance * std::cos(bearing), position.y + distance * std::sin(bearing) });
+        fleet.SetActive(slot, unit(gen) > 0.1f);
+    }
+    return fleet;
+}
+
+struct Deviation {
+    float position = 0.f;
+    float angle = 0.f;
+    size_t tracking = 0;
+};
+
+Deviation Compare(const Fleet& fleet, const Fleet& reference) {
+    Deviation deviation;
+    for (size_t slot = 0; slot < fleet.Size(); ++slot) {
+        const sf::Vector2f a = fleet.GetPosition(slot);
+        const sf::Vector2f b = reference.GetPosition(slot);
+        deviation.position = std::max(deviation.position, std::max(std::abs(a.x - b.x), std::abs(a.y - b.y)));
+        deviation.angle = std::max(deviation.angle, std::abs(fleet.GetAngle(slot) - reference.GetAngle(slot)));
+        deviation.tracking += fleet.IsTracking(slot) != reference.IsTracking(slot);
+    }
+    return deviation;
+}
+
+bool IsBitIdentical(const Fleet& a, const Fleet& b) {
+    for (size_t slot = 0; slot < a.Size(); ++slot) {
+        const sf::Vector2f pa = a.GetPosition(slot);
+        const sf::Vector2f pb = b.GetPosition(slot);
+        const float va[] = { pa.x, pa.y, a.GetAngle(slot) };
+        const float vb[] = { pb.x, pb.y, b.GetAngle(slot) };
+        if (std::memcmp(va, vb, sizeof(va)) != 0 || a.IsTracking(slot) != b.IsTracking(slot)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t failures = 0;
+
+void Check(bool condition, const char* name, const char* what) {
+    std::printf("  %-6s %-40s %s\n", name, what, condition ? "ok" : "FAILED");
+    failures += !condition;
+}
+
+// Шагает копии одного флота через все поддерживаемые ветки и эталон
+void RunCase(const char* name, const Fleet& initial, const sf::Vector2f& wind, size_t steps, float position_tolerance,
+             float angle_tolerance) {
+    const InstructionSet supported = SteeringKernel::DetectInstructionSet();
+    const InstructionSet instruction_sets[] = { InstructionSet::SCALAR, InstructionSet::SSE41, InstructionSet::AVX2 };
+
+    WindField reference_wind;
+    reference_wind.SetSurfaceWind(wind);
+    Fleet reference = initial;
+    reference.SetWindField(&reference_wind);
+    for (size_t i = 0; i < steps; ++i) {
+        reference.StepReference(DT);
+    }
+
+    std::vector<Fleet> results;
+    char what[96];
+    for (InstructionSet instruction_set : instruction_sets) {
+        if (static_cast<int>(instruction_set) > static_cast<int>(supported)) {
+            std::printf("  %-6s %-40s skipped\n", name, GetInstructionSetName(instruction_set));
+            continue;
+        }
+        WindField fleet_wind;
+        fleet_wind.SetSurfaceWind(wind);
+        Fleet fleet = initial;
+        fleet.SetWindField(&fleet_wind);
+        fleet.GetKernel().SetInstructionSet(instruction_set);
+        for (size_t i = 0; i < steps; ++i) {
+            fleet.Step(DT);
+        }
+        fleet.SetWindField(nullptr);
+
+        const Deviation deviation = Compare(fleet, reference);
+        std::snprintf(what, sizeof(what), "%s vs reference: %.2e px, %.2e rad", GetInstructionSetName(instruction_set),
+                      deviation.position, deviation.angle);
+        Check(deviation.position <= position_tolerance && deviation.angle <= angle_tolerance && deviation.tracking == 0,
+              name, what);
+
+        if (!results.empty()) {
+            std::snprintf(what, sizeof(what), "%s vs scalar: bit-identical", GetInstructionSetName(instruction_set));
+            Check(IsBitIdentical(fleet, results.front()), name, what);
+        }
+        results.push_back(std::move(fleet));
+    }
+}
+
+} // namespace
+
+int main() {
+    std::printf("kinematics_test: %zu aircraft, dt %.4f s, best kernel %s\n", FLEET_SIZE, DT,
+                GetInstructionSetName(SteeringKernel::DetectInstructionSet()));
+
+    const Case cases[] = { Case::FAR, Case::NEAR, Case::STOP, Case::WIND };
+    for (Case test_case : cases) {
+        const Fleet fleet = MakeFleet(test_case, 1000 + static_cast<uint32_t>(test_case));
+        const sf::Vector2f wind = test_case == Case::WIND ? sf::Vector2f(40.f, -25.f) : sf::Vector2f();
+        RunCase(GetCaseName(test_case), fleet, wind, 1, STEP_POSITION_TOLERANCE, STEP_ANGLE_TOLERANCE);
+    }
+
+    // У близкой цели слежение снимается за один шаг во всех ветках
+    {
+        Fleet fleet = MakeFleet(Case::STOP, 1000 + static_cast<uint32_t>(Case::STOP));
+        fleet.Step(DT);
+        size_t still_tracking = 0;
+        for (size_t slot = 0; slot < fleet.Size(); ++slot) {
+            still_tracking += fleet.IsActive(slot) && fleet.IsTracking(slot);
+        }
+        Check(still_tracking == 0, "stop", "tracking released near target");
+    }
+
+    RunCase("long", MakeFleet(Case::FAR, 2000), {}, 600, LONG_POSITION_TOLERANCE, LONG_ANGLE_TOLERANCE);
+
+    if (failures != 0) {
+        std::printf("kinematics_test: %zu checks failed\n", failures);
+        return 1;
+    }
+    std::printf("kinematics_test: all checks passed\n");
+    return 0;
+}
\ No newline at end of file
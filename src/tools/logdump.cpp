@@ -0,0 +1,250 @@
+#include "../sim/command.h"
+#include "../../utils/event_log.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+   Утилита logdump - разбор двоичного журнала событий (EventLog) в
+   текст или CSV:
+     logdump <файл> [--csv]
+
+   Текст: время в секундах от начала журнала, имя события, номер
+   самолета и поля события по EVENT_SCHEMAS в виде имя=значение.
+   CSV: time,event,aircraft и четыре значения полей по порядку.
+   Таблица строк восстанавливается по записям STRING, поэтому
+   события MESSAGE выводятся сразу с текстом.
+*/
+
+using namespace utils::event_log;
+
+namespace {
+
+struct DumpState {
+    bool csv = false;
+    std::vector<std::string> strings;
+    std::string line;
+};
+
+void AppendFormat(std::string& line, const char* format, ...) {
+    char buffer[64];
+    va_list args;
+    va_start(args, format);
+    const int length = std::vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length > 0) {
+        line.append(buffer, std::min(static_cast<size_t>(length), sizeof(buffer) - 1));
+    }
+}
+
+// Текст в кавычках; в CSV кавычка удваивается, в тексте - экранируется
+void AppendQuoted(std::string& line, std::string_view text, bool csv) {
+    line += '"';
+    for (char symbol : text) {
+        if (symbol == '"') {
+            line += csv ? "\"\"" : "\\\"";
+        } else if (symbol == '\n' && !csv) {
+            line += "\\n";
+        } else {
+            line += symbol;
+        }
+    }
+    line += '"';
+}
+
+void AppendString(DumpState& state, uint32_t id) {
+    if (id < state.strings.size()) {
+        AppendQuoted(state.line, state.strings[id], state.csv);
+    } else {
+        AppendFormat(state.line, "#%" PRIu32, id);
+    }
+}
+
+// Значение поля index по его типу. DOUBLE берет и следующее поле
+void AppendField(DumpState& state, const EventRecord& record, FieldType type, size_t index) {
+    const uint32_t raw = record.payload[index];
+    switch (type) {
+        case FieldType::NONE:
+            break;
+        case FieldType::UINT:
+            AppendFormat(state.line, "%" PRIu32, raw);
+            break;
+        case FieldType::INT:
+            AppendFormat(state.line, "%" PRId32, static_cast<int32_t>(raw));
+            break;
+        case FieldType::FLOAT: {
+            float value;
+            std::memcpy(&value, &raw, sizeof(value));
+            AppendFormat(state.line, "%.9g", value);
+            break;
+        }
+        case FieldType::DOUBLE: {
+            double value;
+            std::memcpy(&value, &record.payload[index], sizeof(value));
+            AppendFormat(state.line, "%.17g", value);
+            break;
+        }
+        case FieldType::STRING:
+            AppendString(state, raw);
+            break;
+        case FieldType::COMMAND:
+            state.line += sim::GetCommandName(static_cast<sim::CommandType>(raw));
+            break;
+    }
+}
+
+void DumpRecord(DumpState& state, const EventRecord& record, std::string_view text) {
+    std::string& line = state.line;
+    line.clear();
+
+    const char* separator = state.csv ? "," : " ";
+    AppendFormat(line, "%" PRId64 ".%09" PRId64, record.timestamp / 1000000000, record.timestamp % 1000000000);
+    line += separator;
+
+    if (record.event >= EVENT_COUNT) {
+        AppendFormat(line, "EVENT_%u", static_cast<unsigned>(record.event));
+        AppendFormat(line, state.csv ? ",%" PRIu32 : " aircraft=%" PRIu32, record.aircraft);
+        for (size_t i = 0; i < EVENT_PAYLOAD_SIZE; ++i) {
+            AppendFormat(line, state.csv ? ",%" PRIu32 : " 0x%08" PRIx32, record.payload[i]);
+        }
+    } else {
+        const EventSchema& schema = EVENT_SCHEMAS[record.event];
+        line += schema.name;
+        line += separator;
+        if (!state.csv) {
+            line += "aircraft=";
+        }
+        AppendFormat(line, "%" PRIu32, record.aircraft);
+
+        if (static_cast<EventId>(record.event) == EventId::STRING) {
+            line += separator;
+            if (!state.csv) {
+                line += "text=";
+            }
+            AppendQuoted(line, text, state.csv);
+            if (state.csv) {
+                line += ",,,";
+            }
+        } else {
+            for (size_t i = 0; i < EVENT_PAYLOAD_SIZE; ++i) {
+                // В тексте пустые поля и вторая половина DOUBLE не выводятся
+                if (!state.csv && schema.types[i] == FieldType::NONE) {
+                    continue;
+                }
+                line += separator;
+                if (!state.csv) {
+                    line += schema.fields[i];
+                    line += '=';
+                }
+                AppendField(state, record, schema.types[i], i);
+            }
+        }
+    }
+
+    line += '\n';
+    std::fwrite(line.data(), 1, line.size(), stdout);
+}
+
+// Сколько байтов осталось в файле после текущей позиции. Журнал
+// может еще дописываться, поэтому размер меряется при каждом вызове
+uint64_t GetRemainingSize(std::FILE* file) {
+    const long position = std::ftell(file);
+    if (position < 0 || std::fseek(file, 0, SEEK_END) != 0) {
+        return 0;
+    }
+    const long end = std::ftell(file);
+    std::fseek(file, position, SEEK_SET);
+    return end > position ? static_cast<uint64_t>(end - position) : 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* path = nullptr;
+    DumpState state;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--csv") == 0) {
+            state.csv = true;
+        } else if (path == nullptr) {
+            path = argv[i];
+        } else {
+            path = nullptr;
+            break;
+        }
+    }
+    if (path == nullptr) {
+        std::fprintf(stderr, "Usage: %s <events.bin> [--csv]\n", argv[0]);
+        return 2;
+    }
+
+    std::FILE* file = std::fopen(path, "rb");
+    if (file == nullptr) {
+        std::fprintf(stderr, "logdump: cannot open %s\n", path);
+        return 1;
+    }
+
+    EventLogHeader header;
+    if (std::fread(&header, sizeof(header), 1, file) != 1 || std::memcmp(header.magic, EVENT_LOG_MAGIC, sizeof(header.magic)) != 0
+        || header.record_size != sizeof(EventRecord)) {
+        std::fprintf(stderr, "logdump: %s is not an event log\n", path);
+        std::fclose(file);
+        return 1;
+    }
+
+    if (state.csv) {
+        std::fputs("time,event,aircraft,field1,field2,field3,field4\n", stdout);
+    } else {
+        std::printf("# started at %" PRId64 ".%09" PRId64 " (unix time)\n", header.start_time / 1000000000, header.start_time % 1000000000);
+    }
+
+    EventRecord record;
+    std::string text;
+    bool truncated = false;
+    bool invalid = false;
+    while (true) {
+        const size_t read = std::fread(&record, 1, sizeof(record), file);
+        if (read != sizeof(record)) {
+            truncated = read != 0;
+            break;
+        }
+        text.clear();
+        if (static_cast<EventId>(record.event) == EventId::STRING) {
+            // Номера строк выдаются подряд, а текст не длиннее остатка
+            // файла: иначе запись испорчена, и верить ей при выделении
+            // памяти нельзя
+            if (record.aircraft > state.strings.size() || record.payload[0] > GetRemainingSize(file)) {
+                invalid = true;
+                break;
+            }
+            text.resize(record.payload[0]);
+            if (std::fread(text.data(), 1, text.size(), file) != text.size()) {
+                truncated = true;
+                break;
+            }
+            if (record.aircraft == state.strings.size()) {
+                state.strings.push_back(text);
+            } else {
+                state.strings[record.aircraft] = text;
+            }
+        }
+        DumpRecord(state, record, text);
+    }
+    if (invalid) {
+        std::fprintf(stderr, "logdump: %s contains an invalid STRING record\n", path);
+        std::fclose(file);
+        return 1;
+    }
+    // Журнал, который еще пишется, может оборваться посреди записи
+    if (truncated) {
+        std::fprintf(stderr, "logdump: %s ends with an incomplete record\n", path);
+    }
+
+    std::fclose(file);
+    return 0;
+}
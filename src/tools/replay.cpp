@@ -0,0 +1,119 @@
+#include "../sim/session_replayer.h"
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/*
+   Утилита replay - воспроизведение записи сеанса (SessionRecorder)
+   без окна и без реального времени:
+     replay <файл> [--seek S] [--until S] [--verify]
+
+   --seek S   начать с модельного времени S: восстанавливается
+              ближайший опорный кадр не позже S, дальше досчет
+   --until S  остановиться на модельном времени S, а не в конце записи
+   --verify   сравнивать каждый встреченный опорный кадр записи с
+              пересчитанным состоянием; при несовпадении код возврата 1
+
+   Печатает число шагов и их скорость (шагов в секунду реального
+   времени) - запись можно использовать как повторяемый тест
+   производительности модели - и конечное состояние самолетов.
+*/
+
+namespace {
+
+const char* GetInstructionSetName(sim::InstructionSet instruction_set) {
+    switch (instruction_set) {
+        case sim::InstructionSet::SSE41:
+            return "sse4.1";
+        case sim::InstructionSet::AVX2:
+            return "avx2";
+        default:
+            return "scalar";
+    }
+}
+
+bool ParseTime(const char* text, double& value) {
+    char* end = nullptr;
+    value = std::strtod(text, &end);
+    return end != text && *end == '\0' && value >= 0.;
+}
+
+void PrintState(const sim::Simulation& simulation) {
+    const sim::Fleet& fleet = simulation.GetFleet();
+    std::printf("tick %" PRIu64 ", sim time %.3f s\n", simulation.GetTick(), simulation.GetSimTime());
+    for (size_t slot = 0; slot < fleet.Size(); ++slot) {
+        if (!fleet.IsActive(slot)) {
+            continue;
+        }
+        const sf::Vector2f position = fleet.GetPosition(slot);
+        std::printf("  aircraft %zu: x=%.3f y=%.3f alt=%.1f angle=%.3f speed=%.3f\n", slot, position.x, position.y,
+                    fleet.GetAltitude(slot), fleet.GetAngle(slot), fleet.GetSpeed(slot));
+    }
+    for (const sim::Conflict& conflict : simulation.GetConflicts()) {
+        std::printf("  conflict %u-%u: distance=%.3f vertical=%.1f\n", conflict.first, conflict.second, conflict.distance,
+                    conflict.vertical_distance);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* path = nullptr;
+    double seek = 0.;
+    double until = -1.;
+    bool verify = false;
+    bool usage = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--verify") == 0) {
+            verify = true;
+        } else if (std::strcmp(argv[i], "--seek") == 0 && i + 1 < argc) {
+            usage |= !ParseTime(argv[++i], seek);
+        } else if (std::strcmp(argv[i], "--until") == 0 && i + 1 < argc) {
+            usage |= !ParseTime(argv[++i], until);
+        } else if (path == nullptr) {
+            path = argv[i];
+        } else {
+            usage = true;
+        }
+    }
+    if (path == nullptr || usage) {
+        std::fprintf(stderr, "Usage: %s <session.rec> [--seek S] [--until S] [--verify]\n", argv[0]);
+        return 2;
+    }
+
+    sim::SessionReplayer replayer;
+    if (!replayer.Open(path)) {
+        std::fprintf(stderr, "replay: %s is not a session record\n", path);
+        return 1;
+    }
+    std::printf("# seed %" PRIu32 ", kernel %s, %zu keyframes, %zu commands, %" PRIu64 " ticks\n", replayer.GetSeed(),
+                GetInstructionSetName(replayer.GetRecordedInstructionSet()), replayer.GetKeyframeCount(),
+                replayer.GetCommandCount(), replayer.GetEndTick());
+    if (!replayer.Seek(seek)) {
+        std::fprintf(stderr, "replay: %s has no usable keyframe\n", path);
+        return 1;
+    }
+
+    const sim::Simulation& simulation = replayer.GetSimulation();
+    const uint64_t first_tick = simulation.GetTick();
+    const auto start = std::chrono::steady_clock::now();
+    while ((until < 0. || simulation.GetSimTime() < until) && replayer.Step()) {
+    }
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const uint64_t steps = simulation.GetTick() - first_tick;
+    std::printf("# %" PRIu64 " steps in %.3f s, %.0f steps/s\n", steps, elapsed, elapsed > 0. ? steps / elapsed : 0.);
+
+    PrintState(simulation);
+
+    if (verify) {
+        std::printf("# keyframes verified %zu, mismatched %zu\n", replayer.GetVerifiedCount(), replayer.GetMismatchCount());
+        if (replayer.GetMismatchCount() != 0) {
+            std::fprintf(stderr, "replay: state diverges from the record at tick %" PRIu64 "\n", replayer.GetFirstMismatchTick());
+            return 1;
+        }
+    }
+    return 0;
+}
\ No newline at end of file
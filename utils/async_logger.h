@@ -0,0 +1,281 @@
+#pragma once
+
+#include "log_ring.h"
+#include "log_rotation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <boost/log/trivial.hpp>
+
+/*
+   Здесь хранится класс AsyncLogger - асинхронный вывод журнала в
+   файл.
+
+   Вызывающий поток только занимает слот в кольцевом буфере LogRing
+   (без блокировок: писать могут любые потоки, читает один), записывает в
+   него время, уровень и текст сообщения и публикует слот. Числа
+   форматируются сразу в слот через std::to_chars, без std::string и
+   выделений памяти. Диск, форматирование времени и системные вызовы -
+   только в фоновом потоке, который забирает все готовые записи
+   пачкой и пишет их одним fwrite.
+
+   Файл журнала - log_rotation::LogFile: при заданной ротации фоновый
+   поток начинает новый файл по размеру или по времени, а старые части
+   сжимает и удаляет отдельный поток с низким приоритетом.
+
+   Если буфер заполнен, поведение задает OverflowPolicy:
+     BLOCK - ждать, пока фоновый поток освободит место;
+     DROP  - отбросить запись, только увеличить счетчик потерь;
+     COUNT - отбросить запись, а в журнал потом добавить строку с
+             числом потерянных записей.
+
+   Реализация здесь же.
+*/
+
+namespace utils {
+
+namespace async_logger {
+
+using LogLevel = boost::log::trivial::severity_level;
+
+enum class OverflowPolicy {
+    BLOCK,
+    DROP,
+    COUNT,
+};
+
+struct AsyncLogOptions {
+    // Число записей в буфере, округляется вверх до степени двойки
+    size_t capacity = 4096;
+    OverflowPolicy policy = OverflowPolicy::COUNT;
+    // Пауза фонового потока, когда записей нет, секунды
+    double flush_interval = 0.05;
+    // По умолчанию ротации нет, файл пишется с начала
+    log_rotation::RotationOptions rotation;
+};
+
+// Названия уровней, как их пишет Boost.Log
+inline std::string_view GetLevelName(LogLevel level) {
+    static constexpr std::string_view NAMES[] = { "trace", "debug", "info", "warning", "error", "fatal" };
+    const size_t index = static_cast<size_t>(level);
+    return index < std::size(NAMES) ? NAMES[index] : std::string_view("unknown");
+}
+
+// Длина текста одной записи, более длинные сообщения обрезаются
+constexpr size_t LOG_RECORD_TEXT_SIZE = 224;
+
+struct LogRecord {
+    // Наносекунды от эпохи system_clock
+    int64_t timestamp;
+    uint16_t length;
+    LogLevel level;
+    char text[LOG_RECORD_TEXT_SIZE];
+};
+
+// Дописывает части сообщения в текст записи, лишнее обрезается
+class RecordWriter {
+public:
+    explicit RecordWriter(LogRecord& record)
+        : record_(record) {
+        record_.length = 0;
+    }
+
+    void Append(std::string_view text) {
+        const size_t length = std::min(text.size(), LOG_RECORD_TEXT_SIZE - record_.length);
+        std::memcpy(record_.text + record_.length, text.data(), length);
+        record_.length += static_cast<uint16_t>(length);
+    }
+
+    void Append(const char* text) {
+        Append(std::string_view(text));
+    }
+
+    void Append(const std::string& text) {
+        Append(std::string_view(text));
+    }
+
+    void Append(char symbol) {
+        Append(std::string_view(&symbol, 1));
+    }
+
+    void Append(bool value) {
+        Append(value ? std::string_view("true") : std::string_view("false"));
+    }
+
+    template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+    void Append(T value) {
+        char* const end = record_.text + LOG_RECORD_TEXT_SIZE;
+        const std::to_chars_result result = std::to_chars(record_.text + record_.length, end, value);
+        if (result.ec == std::errc()) {
+            record_.length = static_cast<uint16_t>(result.ptr - record_.text);
+        }
+    }
+
+private:
+    LogRecord& record_;
+};
+
+class AsyncLogger {
+public:
+    AsyncLogger(const std::string& path, const AsyncLogOptions& options)
+        : ring_(options.capacity)
+        , policy_(options.policy)
+        , flush_interval_(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::duration<double>(options.flush_interval)))
+        , file_(path, options.rotation) {
+        batch_.reserve(ring_.GetCapacity() * 64);
+        writer_ = std::thread(&AsyncLogger::Run, this);
+    }
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    // Дописывает все оставшиеся записи и закрывает файл
+    ~AsyncLogger() {
+        running_.store(false, std::memory_order_release);
+        writer_.join();
+    }
+
+    // Части сообщения - строки, символы и числа - склеиваются прямо в
+    // слоте буфера. false, если запись отброшена из-за переполнения
+    template <typename... Parts>
+    bool Log(LogLevel level, const Parts&... parts) {
+        const int64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        auto fill = [&](LogRecord& record) {
+            record.timestamp = timestamp;
+            record.level = level;
+            RecordWriter writer(record);
+            (writer.Append(parts), ...);
+        };
+
+        while (!ring_.TryPush(fill)) {
+            if (policy_ != OverflowPolicy::BLOCK) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    // Число записей, отброшенных из-за переполнения
+    uint64_t GetDroppedCount() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    bool IsOpen() const {
+        return file_.IsOpen();
+    }
+
+private:
+    void Run() {
+        while (true) {
+            // Флаг читается до опустошения буфера: записи, добавленные
+            // до остановки, попадут в файл на последнем проходе
+            const bool running = running_.load(std::memory_order_acquire);
+
+            const size_t count = ring_.Drain([this](const LogRecord& record) {
+                FormatRecord(record);
+            }, ring_.GetCapacity());
+            ReportDropped();
+            WriteBatch();
+
+            if (!running) {
+                return;
+            }
+            if (count == 0) {
+                std::this_thread::sleep_for(flush_interval_);
+            }
+        }
+    }
+
+    // [ГГГГ-ММ-ДД ЧЧ:ММ:СС.мммммм] [уровень] текст - как у файла Boost.Log
+    void FormatRecord(const LogRecord& record) {
+        const int64_t seconds = record.timestamp / 1000000000;
+        const int64_t microseconds = record.timestamp % 1000000000 / 1000;
+        AppendTimePrefix(seconds);
+
+        char digits[6];
+        int64_t rest = microseconds;
+        for (size_t i = sizeof(digits); i > 0; --i) {
+            digits[i - 1] = static_cast<char>('0' + rest % 10);
+            rest /= 10;
+        }
+        batch_.append(digits, sizeof(digits));
+        batch_ += "] [";
+        batch_ += GetLevelName(record.level);
+        batch_ += "] ";
+        batch_.append(record.text, record.length);
+        batch_ += '\n';
+    }
+
+    // Дата и время до секунд меняются редко, поэтому strftime только
+    // при смене секунды
+    void AppendTimePrefix(int64_t seconds) {
+        if (seconds != prefix_seconds_) {
+            prefix_seconds_ = seconds;
+            const std::tm local = log_rotation::ToLocalTime(static_cast<std::time_t>(seconds));
+            char buffer[32];
+            const size_t length = std::strftime(buffer, sizeof(buffer), "[%Y-%m-%d %H:%M:%S.", &local);
+            prefix_.assign(buffer, length);
+        }
+        batch_ += prefix_;
+    }
+
+    void ReportDropped() {
+        if (policy_ != OverflowPolicy::COUNT) {
+            return;
+        }
+        const uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+        if (dropped == reported_dropped_) {
+            return;
+        }
+
+        LogRecord record;
+        record.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        record.level = LogLevel::warning;
+        RecordWriter writer(record);
+        writer.Append(dropped - reported_dropped_);
+        writer.Append(" log records have been dropped: queue is full");
+        FormatRecord(record);
+        reported_dropped_ = dropped;
+    }
+
+    // Вызывается и с пустой пачкой: ротация по времени не ждет записей
+    void WriteBatch() {
+        file_.Write(batch_.data(), batch_.size());
+        batch_.clear();
+    }
+
+private:
+    log_ring::LogRing<LogRecord> ring_;
+    OverflowPolicy policy_;
+    std::chrono::microseconds flush_interval_;
+    std::atomic<uint64_t> dropped_{ 0 };
+    std::atomic<bool> running_{ true };
+
+    // Дальше - только фоновый поток
+    log_rotation::LogFile file_;
+    std::string batch_;
+    std::string prefix_;
+    int64_t prefix_seconds_ = -1;
+    uint64_t reported_dropped_ = 0;
+
+    std::thread writer_;
+};
+
+} // namespace async_logger
+
+} // namespace utils
@@ -1,58 +1,283 @@
 #pragma once
 
-#include <boost/property_tree/json_parser.hpp>
-#include <boost/property_tree/ptree.hpp>
+#include "flight_table.h"
+#include "json_reader.h"
+
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
 #include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
 #include <SFML/Network.hpp>
 #include <random>
 
+/*
+   Здесь хранится класс AviationHandler, который готовит данные о
+   рейсах (пока генерирует их случайно).
+
+   Refresh() вызывается фоновым потоком RefreshScheduler. Пока файл
+   outfile_path моложе cache_ttl секунд, данные не генерируются
+   заново, а читаются из него. Текст разбирается из памяти потоковым
+   JsonReader, без промежуточного дерева. Рейсы собираются в новую
+   FlightTable (столбцы с типизированными значениями и индексами) и
+   публикуются целиком (атомарная замена указателя).
+
+   Генератор рейсов создается один раз от зерна seed, поэтому при
+   том же зерне (SetSeed до запуска опросов) рейсы те же - зерно
+   сохраняется в записи сеанса.
+
+   Реализация здесь же.
+*/
+
 namespace utils {
 
 namespace aviation_handler {
 
 class AviationHandler {
 public:
-    AviationHandler() {
+    AviationHandler()
+        : seed(std::random_device{}())
+        , gen(seed) {
         ParseSettingsFile();
     }
 
-    void Initialize() {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        GenerateJSON(gen);
-        ProcessAviationValues();
+    // Один опрос: из файла кеша, если он свежее TTL, иначе заново.
+    // false, если данных получить не удалось
+    bool Refresh() {
+        try {
+            bool loaded = true;
+            if (IsCacheFresh()) {
+                loaded = ReadCache();
+            }
+            else {
+                GenerateJSON(gen);
+            }
+            if (!loaded || !ProcessAviationValues(buffer)) {
+                ++failures;
+                return false;
+            }
+            return true;
+        }
+        catch (const std::exception&) {
+            ++failures;
+            return false;
+        }
+    }
+
+    // Последние опубликованные данные, nullptr до первого успешного опроса
+    std::shared_ptr<const flight_table::FlightTable> GetData() const {
+        return std::atomic_load(&data);
+    }
+
+    // Растет с каждой публикацией
+    uint64_t GetVersion() const {
+        return version.load(std::memory_order_acquire);
+    }
+
+    uint64_t GetFailureCount() const {
+        return failures.load(std::memory_order_relaxed);
+    }
+
+    double GetRefreshInterval() const {
+        return refresh_interval;
+    }
+
+    uint32_t GetSeed() const {
+        return seed;
+    }
+
+    // Вызывать до запуска опросов: генератор начинается заново
+    void SetSeed(uint32_t new_seed) {
+        seed = new_seed;
+        gen.seed(seed);
     }
 
 private:
+    std::shared_ptr<const flight_table::FlightTable> data;
+    std::atomic<uint64_t> version{ 0 };
+    std::atomic<uint64_t> failures{ 0 };
+
     const std::string settings_path = "../utils/aviation_settings.txt";
     std::string outfile_path;
+    size_t fcount = 0;
+    double refresh_interval = 300.;
+    double cache_ttl = 120.;
 
-public:
-    size_t fcount;
+    std::string buffer;
 
-    std::vector<std::string> flight_numbers;
-    std::vector<std::string> departure_times;
-    std::vector<std::string> arrival_times;
-    std::vector<std::string> flight_statuses;
+    uint32_t seed;
+    std::mt19937 gen;
 
 private:
-    void ProcessAviationValues() {
-        boost::property_tree::ptree pt;
-        boost::property_tree::read_json(outfile_path, pt);
+    bool IsCacheFresh() const {
+        std::error_code error;
+        const auto modified = std::filesystem::last_write_time(outfile_path, error);
+        if (error) {
+            return false;
+        }
+        const std::chrono::duration<double> age = std::filesystem::file_time_type::clock::now() - modified;
+        return age.count() < cache_ttl;
+    }
 
-        for (const auto& element : pt) {
-            const auto& child = element.second;
-            flight_numbers.push_back(child.get<std::string>("flight_number"));
-            departure_times.push_back(child.get<std::string>("departure_time"));
-            arrival_times.push_back(child.get<std::string>("arrival_time"));
-            flight_statuses.push_back(child.get<std::string>("flight_status"));
+    bool ReadCache() {
+        std::ifstream cache{ outfile_path, std::ios::binary };
+        if (!cache.is_open()) {
+            return false;
         }
+        buffer.assign(std::istreambuf_iterator<char>(cache), std::istreambuf_iterator<char>());
+        return true;
     }
 
-    void GenerateJSON(std::mt19937& gen) {
-        std::ofstream outfile{ "../utils/aviation.json" };
+    // Пишем во временный файл и переименовываем, чтобы в кеше не
+    // остался обрезанный файл. Кеш не записался - не беда, данные
+    // уже в памяти
+    void WriteCache() const {
+        const std::string temporary_path = outfile_path + ".tmp";
+        std::ofstream outfile{ temporary_path, std::ios::binary };
+        outfile << buffer;
+        outfile.close();
+        if (outfile) {
+            std::rename(temporary_path.c_str(), outfile_path.c_str());
+        }
+    }
 
-        std::string buffer = "[";
+    // Обработчик событий JsonReader: массив объектов, по объекту на
+    // рейс. Значения сразу переводятся в типы таблицы, строки не
+    // копируются (кроме первой встречи номера рейса)
+    class FlightsJsonHandler {
+    public:
+        explicit FlightsJsonHandler(flight_table::FlightTable& table)
+            : table(table) {
+        }
+
+        void StartObject() {
+            ++depth;
+            if (depth == 2) {
+                found = 0;
+            }
+        }
+
+        void EndObject() {
+            if (depth == 2) {
+                if (found == ALL_FIELDS) {
+                    table.AddFlight(id, departure, arrival, status);
+                }
+                else {
+                    valid = false;
+                }
+            }
+            --depth;
+        }
+
+        void StartArray() {
+            ++depth;
+        }
+
+        void EndArray() {
+            --depth;
+        }
+
+        void Key(std::string_view key) {
+            field = Field::NONE;
+            if (depth != 2) {
+                return;
+            }
+            if (key == "flight_number") {
+                field = Field::NUMBER;
+            }
+            else if (key == "departure_time") {
+                field = Field::DEPARTURE;
+            }
+            else if (key == "arrival_time") {
+                field = Field::ARRIVAL;
+            }
+            else if (key == "flight_status") {
+                field = Field::STATUS;
+            }
+        }
+
+        void String(std::string_view value) {
+            switch (field) {
+                case Field::NONE:
+                    return;
+                case Field::NUMBER:
+                    id = table.InternFlightNumber(value);
+                    break;
+                case Field::DEPARTURE:
+                    if (!flight_table::ParseTime(value, departure)) {
+                        valid = false;
+                    }
+                    break;
+                case Field::ARRIVAL:
+                    if (!flight_table::ParseTime(value, arrival)) {
+                        valid = false;
+                    }
+                    break;
+                case Field::STATUS:
+                    status = flight_table::ParseStatus(value);
+                    break;
+            }
+            found |= 1u << (static_cast<uint32_t>(field) - 1);
+            field = Field::NONE;
+        }
+
+        void Number(std::string_view) {
+            field = Field::NONE;
+        }
+
+        void Bool(bool) {
+            field = Field::NONE;
+        }
+
+        void Null() {
+            field = Field::NONE;
+        }
+
+        bool IsValid() const {
+            return valid;
+        }
+
+    private:
+        enum class Field { NONE, NUMBER, DEPARTURE, ARRIVAL, STATUS };
+        static constexpr uint32_t ALL_FIELDS = (1u << 4) - 1;
+
+    private:
+        flight_table::FlightTable& table;
+        size_t depth = 0;
+        Field field = Field::NONE;
+        uint32_t found = 0;
+        bool valid = true;
+
+        // Поля текущего рейса
+        flight_table::FlightId id = 0;
+        flight_table::FlightTime departure = 0;
+        flight_table::FlightTime arrival = 0;
+        flight_table::FlightStatus status = flight_table::FlightStatus::UNKNOWN;
+    };
+
+    // Разбирает рейсы, строит индексы таблицы и публикует ее. false,
+    // если текст некорректен или у рейса не хватает полей
+    bool ProcessAviationValues(std::string_view text) {
+        auto table = std::make_shared<flight_table::FlightTable>();
+        table->Reserve(fcount);
+        FlightsJsonHandler handler(*table);
+        json_reader::JsonReader reader(text);
+        if (!reader.Parse(handler) || !handler.IsValid()) {
+            return false;
+        }
+        table->BuildIndexes();
+
+        std::atomic_store(&data, std::shared_ptr<const flight_table::FlightTable>(std::move(table)));
+        version.fetch_add(1, std::memory_order_release);
+        return true;
+    }
+
+    void GenerateJSON(std::mt19937& gen) {
+        buffer = "[";
 
         for (int i = 0; i < fcount; ++i) {
             std::string flight_number = GenerateRandomFlightNumber(gen);
@@ -75,27 +300,32 @@ private:
 
         buffer += "]";
 
-        outfile << buffer;
-
-        outfile.close();
+        WriteCache();
     }
 
     int ParseSettingsFile() {
         std::ifstream settings{ settings_path };
 
         if (settings.is_open()) {
-            const char EQUAL_SIGN = '=';
-            size_t i = 0;
-            std::array<std::string, 3> params;
+            const std::string SEPARATOR = " = ";
+            std::map<std::string, std::string> params;
 
             std::string line;
             while (std::getline(settings, line)) {
-                std::string param = line.substr(line.find(EQUAL_SIGN) + 2);
-                params[i++] = param;
+                const size_t separator = line.find(SEPARATOR);
+                if (separator != std::string::npos) {
+                    params[line.substr(0, separator)] = line.substr(separator + SEPARATOR.size());
+                }
             }
 
-            fcount = std::stoi(params[0]);
-            outfile_path = params[1];
+            fcount = std::stoi(params["aviation-flights-number"]);
+            outfile_path = params["aviation-outfile-path"];
+            if (!params["aviation-refresh-interval"].empty()) {
+                refresh_interval = std::stod(params["aviation-refresh-interval"]);
+            }
+            if (!params["aviation-cache-ttl"].empty()) {
+                cache_ttl = std::stod(params["aviation-cache-ttl"]);
+            }
 
             settings.close();
             return 0;
@@ -136,9 +366,8 @@ private:
     }
 
     std::string GenerateRandomFlightStatus(std::mt19937& gen) const {
-        const std::array<std::string, 3> statuses = { "В пути", "Задержан", "Отменен" };
-        std::uniform_int_distribution<int> distribution(0, 2);
-        return statuses[distribution(gen)];
+        std::uniform_int_distribution<int> distribution(0, static_cast<int>(flight_table::FLIGHT_STATUS_COUNT) - 2);
+        return std::string(flight_table::GetStatusName(static_cast<flight_table::FlightStatus>(distribution(gen))));
     }
 };
 
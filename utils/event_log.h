@@ -0,0 +1,326 @@
+#pragma once
+
+#include "log_ring.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+
+/*
+   Здесь хранится класс EventLog - двоичный журнал событий со
+   структурой: вместо строки текста каждое событие - запись
+   EventRecord фиксированного размера (32 байта) с номером события,
+   временем, номером самолета и четырьмя 32-битными полями.
+   Назначение полей каждого события описано в EVENT_SCHEMAS, по ним
+   журнал разбирает утилита logdump.
+
+   Редко меняющийся текст (сообщения, пункты меню) интернируется в
+   таблицу строк: строка попадает в файл один раз записью STRING, а
+   события ссылаются на нее номером.
+
+   Запись события - только занятие слота в LogRing без блокировок;
+   фоновый поток пишет готовые записи в файл пачками как есть, без
+   форматирования. При переполнении событие отбрасывается, а число
+   потерь попадает в журнал событием DROPPED. Записи STRING не
+   отбрасываются никогда.
+
+   Формат файла (little-endian):
+     char[8]  "AEVLOG1\0"
+     uint32   размер записи (32)
+     uint32   резерв
+     int64    время начала журнала, нс от эпохи system_clock
+     далее записи EventRecord; за записью STRING сразу идут
+     payload[0] байт ее текста
+
+   Реализация здесь же.
+*/
+
+namespace utils {
+
+namespace event_log {
+
+enum class EventId : uint16_t {
+    // Текст строки таблицы: aircraft - номер строки, payload[0] - длина
+    // текста, который идет в файле сразу за записью
+    STRING,
+    DROPPED,
+    MESSAGE,
+    SIM_STEP,
+    COMMAND,
+    AIRCRAFT_STATE,
+};
+
+constexpr size_t EVENT_COUNT = 6;
+constexpr size_t EVENT_PAYLOAD_SIZE = 4;
+
+// Как понимать поле события. DOUBLE занимает и следующее поле
+enum class FieldType : uint8_t {
+    NONE,
+    UINT,
+    INT,
+    FLOAT,
+    DOUBLE,
+    STRING,
+    // Номер sim::CommandType
+    COMMAND,
+};
+
+struct EventSchema {
+    std::string_view name;
+    std::array<std::string_view, EVENT_PAYLOAD_SIZE> fields;
+    std::array<FieldType, EVENT_PAYLOAD_SIZE> types;
+};
+
+// Описание полей каждого события, по номеру EventId
+constexpr std::array<EventSchema, EVENT_COUNT> EVENT_SCHEMAS = { {
+    { "STRING", { "length" }, { FieldType::UINT } },
+    { "DROPPED", { "count" }, { FieldType::UINT } },
+    { "MESSAGE", { "text" }, { FieldType::STRING } },
+    { "SIM_STEP", { "tick", "sim_time", "", "step" }, { FieldType::UINT, FieldType::DOUBLE, FieldType::NONE, FieldType::FLOAT } },
+    { "COMMAND", { "type", "x", "y", "value" }, { FieldType::COMMAND, FieldType::FLOAT, FieldType::FLOAT, FieldType::FLOAT } },
+    { "AIRCRAFT_STATE", { "x", "y", "altitude", "heading" }, { FieldType::FLOAT, FieldType::FLOAT, FieldType::FLOAT, FieldType::FLOAT } },
+} };
+
+constexpr char EVENT_LOG_MAGIC[8] = { 'A', 'E', 'V', 'L', 'O', 'G', '1', '\0' };
+
+struct EventLogHeader {
+    char magic[8];
+    uint32_t record_size;
+    uint32_t reserved;
+    int64_t start_time;
+};
+
+struct EventRecord {
+    uint16_t event;
+    uint16_t reserved;
+    uint32_t aircraft;
+    // Наносекунды от начала журнала
+    int64_t timestamp;
+    uint32_t payload[EVENT_PAYLOAD_SIZE];
+};
+
+static_assert(sizeof(EventRecord) == 32, "EventRecord is a part of the file format");
+
+using Payload = std::array<uint32_t, EVENT_PAYLOAD_SIZE>;
+
+// Складывает значения в поля события по порядку: float и double - их
+// битами (double - в два поля), целые - как uint32_t
+class PayloadBuilder {
+public:
+    template <typename... Values>
+    static Payload Make(Values... values) {
+        Payload payload{};
+        size_t index = 0;
+        (Store(payload, index, values), ...);
+        return payload;
+    }
+
+private:
+    static void Store(Payload& payload, size_t& index, float value) {
+        std::memcpy(&payload[index++], &value, sizeof(value));
+    }
+
+    static void Store(Payload& payload, size_t& index, double value) {
+        std::memcpy(&payload[index], &value, sizeof(value));
+        index += 2;
+    }
+
+    template <typename T, typename = std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T>>>
+    static void Store(Payload& payload, size_t& index, T value) {
+        payload[index++] = static_cast<uint32_t>(value);
+    }
+};
+
+class EventLog {
+public:
+    EventLog(const std::string& path, size_t capacity, double flush_interval)
+        : ring_(capacity)
+        , flush_interval_(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::duration<double>(flush_interval)))
+        , start_(std::chrono::steady_clock::now()) {
+        file_ = std::fopen(path.c_str(), "wb");
+        if (file_ != nullptr) {
+            EventLogHeader header{};
+            std::memcpy(header.magic, EVENT_LOG_MAGIC, sizeof(header.magic));
+            header.record_size = sizeof(EventRecord);
+            header.start_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            std::fwrite(&header, sizeof(header), 1, file_);
+        }
+        batch_.reserve(ring_.GetCapacity() * sizeof(EventRecord));
+        writer_ = std::thread(&EventLog::Run, this);
+    }
+
+    EventLog(const EventLog&) = delete;
+    EventLog& operator=(const EventLog&) = delete;
+
+    // Дописывает все оставшиеся записи и закрывает файл
+    ~EventLog() {
+        running_.store(false, std::memory_order_release);
+        writer_.join();
+        if (file_ != nullptr) {
+            std::fclose(file_);
+        }
+    }
+
+    // Время для записи, нс от начала журнала. Пачку событий одного
+    // момента можно записать с одним временем
+    int64_t Now() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+    }
+
+    // false, если событие отброшено из-за переполнения
+    bool Write(EventId event, uint32_t aircraft, const Payload& payload, int64_t timestamp) {
+        const bool pushed = ring_.TryPush([&](EventRecord& record) {
+            Fill(record, event, aircraft, payload, timestamp);
+        });
+        if (!pushed) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return pushed;
+    }
+
+    bool Write(EventId event, uint32_t aircraft, const Payload& payload) {
+        return Write(event, aircraft, payload, Now());
+    }
+
+    // Номер строки в таблице. Новая строка сразу отправляется в
+    // журнал, поэтому события с ее номером всегда идут после нее
+    uint32_t InternString(std::string_view text) {
+        std::lock_guard<std::mutex> lock(strings_mutex_);
+        const auto found = string_ids_.find(text);
+        if (found != string_ids_.end()) {
+            return found->second;
+        }
+
+        const uint32_t id = static_cast<uint32_t>(strings_.size());
+        strings_.emplace_back(text);
+        string_ids_.emplace(strings_.back(), id);
+
+        // Под мьютексом: другой поток получит номер только после того,
+        // как определение строки займет место в буфере. Фоновый поток
+        // берет текст по адресу из payload[2..3], не трогая мьютекс:
+        // deque не переносит строки, а сама строка больше не меняется
+        Payload payload = PayloadBuilder::Make(static_cast<uint32_t>(text.size()));
+        const std::string* address = &strings_.back();
+        std::memcpy(&payload[2], &address, sizeof(address));
+        const int64_t timestamp = Now();
+        while (!ring_.TryPush([&](EventRecord& record) {
+            Fill(record, EventId::STRING, id, payload, timestamp);
+        })) {
+            std::this_thread::yield();
+        }
+        return id;
+    }
+
+    bool Message(std::string_view text) {
+        return Write(EventId::MESSAGE, 0, PayloadBuilder::Make(InternString(text)));
+    }
+
+    uint64_t GetDroppedCount() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    bool IsOpen() const {
+        return file_ != nullptr;
+    }
+
+private:
+    static void Fill(EventRecord& record, EventId event, uint32_t aircraft, const Payload& payload, int64_t timestamp) {
+        record.event = static_cast<uint16_t>(event);
+        record.reserved = 0;
+        record.aircraft = aircraft;
+        record.timestamp = timestamp;
+        std::memcpy(record.payload, payload.data(), sizeof(record.payload));
+    }
+
+    void Run() {
+        while (true) {
+            // Флаг читается до опустошения буфера: события, записанные
+            // до остановки, попадут в файл на последнем проходе
+            const bool running = running_.load(std::memory_order_acquire);
+
+            const size_t count = ring_.Drain([this](const EventRecord& record) {
+                Append(record);
+            }, ring_.GetCapacity());
+            ReportDropped();
+            WriteBatch();
+
+            if (!running) {
+                return;
+            }
+            if (count == 0) {
+                std::this_thread::sleep_for(flush_interval_);
+            }
+        }
+    }
+
+    void Append(const EventRecord& record) {
+        if (record.event != static_cast<uint16_t>(EventId::STRING)) {
+            batch_.append(reinterpret_cast<const char*>(&record), sizeof(record));
+            return;
+        }
+
+        // Адрес текста нужен только в памяти, в файл вместо него нули
+        const std::string* text;
+        std::memcpy(&text, &record.payload[2], sizeof(text));
+        EventRecord definition = record;
+        definition.payload[2] = 0;
+        definition.payload[3] = 0;
+        batch_.append(reinterpret_cast<const char*>(&definition), sizeof(definition));
+        batch_ += *text;
+    }
+
+    void ReportDropped() {
+        const uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+        if (dropped == reported_dropped_) {
+            return;
+        }
+        EventRecord record;
+        Fill(record, EventId::DROPPED, 0, PayloadBuilder::Make(static_cast<uint32_t>(dropped - reported_dropped_)), Now());
+        Append(record);
+        reported_dropped_ = dropped;
+    }
+
+    void WriteBatch() {
+        if (batch_.empty()) {
+            return;
+        }
+        if (file_ != nullptr) {
+            std::fwrite(batch_.data(), 1, batch_.size(), file_);
+            std::fflush(file_);
+        }
+        batch_.clear();
+    }
+
+private:
+    log_ring::LogRing<EventRecord> ring_;
+    std::chrono::microseconds flush_interval_;
+    std::chrono::steady_clock::time_point start_;
+    std::atomic<uint64_t> dropped_{ 0 };
+    std::atomic<bool> running_{ true };
+
+    std::mutex strings_mutex_;
+    std::deque<std::string> strings_;
+    std::unordered_map<std::string_view, uint32_t> string_ids_;
+
+    // Дальше - только фоновый поток
+    std::FILE* file_ = nullptr;
+    std::string batch_;
+    uint64_t reported_dropped_ = 0;
+
+    std::thread writer_;
+};
+
+} // namespace event_log
+
+} // namespace utils
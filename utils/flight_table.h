@@ -0,0 +1,225 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/*
+   Здесь хранится класс FlightTable - таблица рейсов по столбцам с
+   типизированными значениями вместо строк:
+     - номер рейса интернируется в FlightId (строка хранится один раз);
+     - время вылета и прилета - минуты от полуночи;
+     - статус - перечисление FlightStatus.
+
+   После заполнения BuildIndexes строит индексы: порядок строк по
+   времени вылета (сортировка подсчетом по минутам) и по статусу (в
+   пределах статуса - тоже по вылету). Сортировка, фильтр и вывод
+   таблицы идут по целым числам, без сравнения строк и выделений
+   памяти на строку.
+
+   Реализация здесь же.
+*/
+
+namespace utils {
+
+namespace flight_table {
+
+using FlightId = uint32_t;
+
+// Минуты от полуночи
+using FlightTime = uint16_t;
+
+constexpr FlightTime MINUTES_PER_DAY = 24 * 60;
+
+enum class FlightStatus : uint8_t {
+    EN_ROUTE,
+    DELAYED,
+    CANCELLED,
+    UNKNOWN,
+};
+
+constexpr size_t FLIGHT_STATUS_COUNT = 4;
+
+// Текст статуса для табло
+inline std::string_view GetStatusName(FlightStatus status) {
+    static constexpr std::array<std::string_view, FLIGHT_STATUS_COUNT> NAMES = { "В пути", "Задержан", "Отменен", "Неизвестно" };
+    return NAMES[static_cast<size_t>(status)];
+}
+
+// Статус по тексту источника, неизвестный текст - UNKNOWN
+inline FlightStatus ParseStatus(std::string_view text) {
+    for (size_t i = 0; i + 1 < FLIGHT_STATUS_COUNT; ++i) {
+        const FlightStatus status = static_cast<FlightStatus>(i);
+        if (text == GetStatusName(status)) {
+            return status;
+        }
+    }
+    return FlightStatus::UNKNOWN;
+}
+
+// Время "ЧЧ:ММ" в минуты, false если текст не такого вида
+inline bool ParseTime(std::string_view text, FlightTime& time) {
+    auto digit = [&](size_t i) {
+        return static_cast<unsigned>(text[i] - '0');
+    };
+    if (text.size() != 5 || text[2] != ':' || digit(0) > 9 || digit(1) > 9 || digit(3) > 9 || digit(4) > 9) {
+        return false;
+    }
+    const unsigned hours = digit(0) * 10 + digit(1);
+    const unsigned minutes = digit(3) * 10 + digit(4);
+    if (hours >= 24 || minutes >= 60) {
+        return false;
+    }
+    time = static_cast<FlightTime>(hours * 60 + minutes);
+    return true;
+}
+
+class FlightTable {
+public:
+    // Непрерывный участок индекса - номера строк таблицы
+    struct Rows {
+        const uint32_t* first;
+        const uint32_t* last;
+
+        const uint32_t* begin() const {
+            return first;
+        }
+
+        const uint32_t* end() const {
+            return last;
+        }
+
+        size_t size() const {
+            return static_cast<size_t>(last - first);
+        }
+    };
+
+    FlightTable() = default;
+
+    // Вид в словаре номеров ссылается на строки names_, которые при
+    // копировании остались бы в старой таблице
+    FlightTable(const FlightTable&) = delete;
+    FlightTable& operator=(const FlightTable&) = delete;
+    FlightTable(FlightTable&&) = default;
+    FlightTable& operator=(FlightTable&&) = default;
+
+    void Reserve(size_t count) {
+        flight_ids_.reserve(count);
+        departure_times_.reserve(count);
+        arrival_times_.reserve(count);
+        statuses_.reserve(count);
+    }
+
+    // Номер рейса в FlightId; строка копируется только при первой встрече
+    FlightId InternFlightNumber(std::string_view number) {
+        const auto found = ids_.find(number);
+        if (found != ids_.end()) {
+            return found->second;
+        }
+        const FlightId id = static_cast<FlightId>(names_.size());
+        names_.emplace_back(number);
+        ids_.emplace(names_.back(), id);
+        return id;
+    }
+
+    // Индексы после добавления устаревают до следующего BuildIndexes
+    void AddFlight(FlightId id, FlightTime departure, FlightTime arrival, FlightStatus status) {
+        flight_ids_.push_back(id);
+        departure_times_.push_back(departure);
+        arrival_times_.push_back(arrival);
+        statuses_.push_back(status);
+    }
+
+    void BuildIndexes() {
+        const size_t count = GetSize();
+
+        // Сортировка подсчетом по минуте вылета: устойчива, O(n + минут в сутках)
+        std::vector<uint32_t> starts(MINUTES_PER_DAY + 1, 0);
+        for (FlightTime time : departure_times_) {
+            ++starts[time + 1];
+        }
+        for (size_t minute = 0; minute < MINUTES_PER_DAY; ++minute) {
+            starts[minute + 1] += starts[minute];
+        }
+        by_departure_.resize(count);
+        for (size_t row = 0; row < count; ++row) {
+            by_departure_[starts[departure_times_[row]]++] = static_cast<uint32_t>(row);
+        }
+
+        // Раскладка по статусам в порядке вылета, начало каждого
+        // статуса - в status_starts_
+        status_starts_.fill(0);
+        for (FlightStatus status : statuses_) {
+            ++status_starts_[static_cast<size_t>(status) + 1];
+        }
+        for (size_t status = 0; status < FLIGHT_STATUS_COUNT; ++status) {
+            status_starts_[status + 1] += status_starts_[status];
+        }
+        std::array<uint32_t, FLIGHT_STATUS_COUNT> cursor;
+        std::copy(status_starts_.begin(), status_starts_.end() - 1, cursor.begin());
+        by_status_.resize(count);
+        for (uint32_t row : by_departure_) {
+            by_status_[cursor[static_cast<size_t>(statuses_[row])]++] = row;
+        }
+    }
+
+    size_t GetSize() const {
+        return flight_ids_.size();
+    }
+
+    FlightId GetFlightId(size_t row) const {
+        return flight_ids_[row];
+    }
+
+    const std::string& GetFlightNumber(size_t row) const {
+        return names_[flight_ids_[row]];
+    }
+
+    FlightTime GetDepartureTime(size_t row) const {
+        return departure_times_[row];
+    }
+
+    FlightTime GetArrivalTime(size_t row) const {
+        return arrival_times_[row];
+    }
+
+    FlightStatus GetStatus(size_t row) const {
+        return statuses_[row];
+    }
+
+    // Все строки по возрастанию времени вылета
+    Rows GetByDeparture() const {
+        return { by_departure_.data(), by_departure_.data() + by_departure_.size() };
+    }
+
+    // Строки одного статуса по возрастанию времени вылета
+    Rows GetByStatus(FlightStatus status) const {
+        const size_t index = static_cast<size_t>(status);
+        return { by_status_.data() + status_starts_[index], by_status_.data() + status_starts_[index + 1] };
+    }
+
+private:
+    std::vector<FlightId> flight_ids_;
+    std::vector<FlightTime> departure_times_;
+    std::vector<FlightTime> arrival_times_;
+    std::vector<FlightStatus> statuses_;
+
+    // deque не переносит строки при добавлении, поэтому виды в ids_
+    // остаются действительными
+    std::deque<std::string> names_;
+    std::unordered_map<std::string_view, FlightId> ids_;
+
+    std::vector<uint32_t> by_departure_;
+    std::vector<uint32_t> by_status_;
+    std::array<uint32_t, FLIGHT_STATUS_COUNT + 1> status_starts_{};
+};
+
+} // namespace flight_table
+
+} // namespace utils
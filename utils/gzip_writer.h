@@ -0,0 +1,314 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#ifdef LOG_ROTATION_ZLIB
+#include <zlib.h>
+#endif
+
+/*
+   Здесь хранится сжатие файла в формат gzip (RFC 1951, RFC 1952) -
+   CompressFile. Результат читается обычными gzip, zcat и zless.
+
+   Если при сборке найден zlib (макрос LOG_ROTATION_ZLIB), сжимает
+   zlib. Иначе работает свой кодировщик GzipWriter: LZ77 с окном
+   32 КБ и поиском совпадений по хеш-цепочкам (жадно, без отложенного
+   выбора) и фиксированные коды Хаффмана deflate. Он сжимает хуже
+   zlib, но для текста журналов выигрыш все равно в разы, а сторонних
+   библиотек не нужно.
+
+   Реализация здесь же.
+*/
+
+namespace utils {
+
+namespace gzip {
+
+inline uint32_t UpdateCrc32(uint32_t crc, const uint8_t* data, size_t size) {
+    static const std::array<uint32_t, 256> TABLE = [] {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+            }
+            table[i] = value;
+        }
+        return table;
+    }();
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) {
+        crc = TABLE[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+// Поток gzip из одного блока deflate с фиксированными кодами. Данные
+// подаются кусками через Write, сжатые байты копятся в GetOutput,
+// вызывающий забирает их и очищает
+class GzipWriter {
+public:
+    GzipWriter()
+        : head_(HASH_SIZE, NO_POSITION)
+        , prev_(WINDOW_SIZE, NO_POSITION) {
+        // Заголовок gzip: deflate, без имени и времени, ОС неизвестна
+        static constexpr uint8_t HEADER[10] = { 0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF };
+        output_.append(reinterpret_cast<const char*>(HEADER), sizeof(HEADER));
+        // BFINAL = 1, BTYPE = 01 (фиксированные коды)
+        PutBits(1, 1);
+        PutBits(1, 2);
+    }
+
+    void Write(const uint8_t* data, size_t size) {
+        crc_ = UpdateCrc32(crc_, data, size);
+        input_size_ += size;
+        window_.insert(window_.end(), data, data + size);
+        // Последние MAX_MATCH байт ждут следующего куска, чтобы
+        // совпадение не обрывалось на границе
+        if (window_.size() > MAX_MATCH) {
+            Encode(window_.size() - MAX_MATCH);
+        }
+    }
+
+    // Дописывает остаток, конец блока и хвост gzip
+    void Finish() {
+        Encode(window_.size());
+        PutLiteralOrLength(END_OF_BLOCK);
+        if (bit_count_ > 0) {
+            output_ += static_cast<char>(bits_);
+            bits_ = 0;
+            bit_count_ = 0;
+        }
+        PutUint32(crc_);
+        PutUint32(static_cast<uint32_t>(input_size_));
+    }
+
+    std::string& GetOutput() {
+        return output_;
+    }
+
+private:
+    static constexpr size_t WINDOW_SIZE = 32768;
+    static constexpr size_t HASH_SIZE = 1 << 15;
+    static constexpr size_t MIN_MATCH = 3;
+    static constexpr size_t MAX_MATCH = 258;
+    static constexpr size_t MAX_CHAIN = 32;
+    static constexpr uint16_t END_OF_BLOCK = 256;
+    static constexpr int64_t NO_POSITION = -1;
+
+    static constexpr uint16_t LENGTH_BASES[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                                   35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    static constexpr uint8_t LENGTH_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                                  3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    static constexpr uint16_t DISTANCE_BASES[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129,
+                                                     193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097,
+                                                     6145, 8193, 12289, 16385, 24577 };
+    static constexpr uint8_t DISTANCE_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6,
+                                                    6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+    // Кодирует window_ до позиции end и оставляет в окне не больше
+    // WINDOW_SIZE уже закодированных байт для будущих совпадений
+    void Encode(size_t end) {
+        size_t position = encoded_;
+        while (position < end) {
+            size_t distance = 0;
+            const size_t length = FindMatch(position, distance);
+            if (length >= MIN_MATCH) {
+                PutMatch(length, distance);
+                for (size_t i = 0; i < length; ++i) {
+                    Insert(position + i);
+                }
+                position += length;
+            } else {
+                PutLiteralOrLength(window_[position]);
+                Insert(position);
+                ++position;
+            }
+        }
+        encoded_ = position;
+
+        if (encoded_ > 2 * WINDOW_SIZE) {
+            const size_t drop = encoded_ - WINDOW_SIZE;
+            window_.erase(window_.begin(), window_.begin() + static_cast<std::ptrdiff_t>(drop));
+            base_ += drop;
+            encoded_ -= drop;
+        }
+    }
+
+    size_t Hash(size_t position) const {
+        const uint32_t value = window_[position] | (window_[position + 1] << 8) | (window_[position + 2] << 16);
+        return (value * 2654435761u) >> (32 - 15);
+    }
+
+    // Позиции в head_ и prev_ - от начала потока, поэтому не меняются
+    // при сдвиге окна
+    void Insert(size_t position) {
+        if (position + MIN_MATCH > window_.size()) {
+            return;
+        }
+        const int64_t absolute = static_cast<int64_t>(base_ + position);
+        int64_t& head = head_[Hash(position)];
+        prev_[static_cast<size_t>(absolute) & (WINDOW_SIZE - 1)] = head;
+        head = absolute;
+    }
+
+    size_t FindMatch(size_t position, size_t& distance) const {
+        const size_t available = window_.size() - position;
+        if (available < MIN_MATCH) {
+            return 0;
+        }
+        const size_t limit = available < MAX_MATCH ? available : MAX_MATCH;
+        const int64_t absolute = static_cast<int64_t>(base_ + position);
+
+        size_t best = 0;
+        int64_t candidate = head_[Hash(position)];
+        for (size_t chain = 0; chain < MAX_CHAIN && candidate != NO_POSITION; ++chain) {
+            if (absolute - candidate > static_cast<int64_t>(WINDOW_SIZE) || candidate < static_cast<int64_t>(base_)) {
+                break;
+            }
+            const uint8_t* current = &window_[position];
+            const uint8_t* previous = &window_[static_cast<size_t>(candidate) - base_];
+            size_t length = 0;
+            while (length < limit && current[length] == previous[length]) {
+                ++length;
+            }
+            if (length > best) {
+                best = length;
+                distance = static_cast<size_t>(absolute - candidate);
+                if (length == limit) {
+                    break;
+                }
+            }
+            candidate = prev_[static_cast<size_t>(candidate) & (WINDOW_SIZE - 1)];
+        }
+        return best;
+    }
+
+    // Младшие биты - первыми, как требует deflate
+    void PutBits(uint32_t value, unsigned count) {
+        bits_ |= static_cast<uint64_t>(value) << bit_count_;
+        bit_count_ += count;
+        while (bit_count_ >= 8) {
+            output_ += static_cast<char>(bits_ & 0xFF);
+            bits_ >>= 8;
+            bit_count_ -= 8;
+        }
+    }
+
+    // Коды Хаффмана пишутся со старшего бита
+    void PutCode(uint32_t code, unsigned length) {
+        uint32_t reversed = 0;
+        for (unsigned i = 0; i < length; ++i) {
+            reversed = (reversed << 1) | ((code >> i) & 1);
+        }
+        PutBits(reversed, length);
+    }
+
+    void PutLiteralOrLength(uint16_t symbol) {
+        if (symbol < 144) {
+            PutCode(0x30 + symbol, 8);
+        } else if (symbol < 256) {
+            PutCode(0x190 + symbol - 144, 9);
+        } else if (symbol < 280) {
+            PutCode(symbol - 256, 7);
+        } else {
+            PutCode(0xC0 + symbol - 280, 8);
+        }
+    }
+
+    void PutMatch(size_t length, size_t distance) {
+        size_t code = 28;
+        while (LENGTH_BASES[code] > length) {
+            --code;
+        }
+        PutLiteralOrLength(static_cast<uint16_t>(257 + code));
+        PutBits(static_cast<uint32_t>(length - LENGTH_BASES[code]), LENGTH_EXTRA[code]);
+
+        code = 29;
+        while (DISTANCE_BASES[code] > distance) {
+            --code;
+        }
+        PutCode(static_cast<uint32_t>(code), 5);
+        PutBits(static_cast<uint32_t>(distance - DISTANCE_BASES[code]), DISTANCE_EXTRA[code]);
+    }
+
+    void PutUint32(uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            output_ += static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+    }
+
+private:
+    std::vector<uint8_t> window_;
+    // Позиция window_[0] от начала потока
+    size_t base_ = 0;
+    size_t encoded_ = 0;
+    std::vector<int64_t> head_;
+    std::vector<int64_t> prev_;
+
+    std::string output_;
+    uint64_t bits_ = 0;
+    unsigned bit_count_ = 0;
+    uint32_t crc_ = 0;
+    uint64_t input_size_ = 0;
+};
+
+// Сжимает source в destination. false при ошибке чтения или записи,
+// тогда destination может остаться недописанным
+inline bool CompressFile(const std::string& source, const std::string& destination) {
+    std::FILE* input = std::fopen(source.c_str(), "rb");
+    if (input == nullptr) {
+        return false;
+    }
+    std::vector<uint8_t> chunk(1 << 18);
+    bool ok = true;
+
+#ifdef LOG_ROTATION_ZLIB
+    gzFile output = gzopen(destination.c_str(), "wb6");
+    if (output == nullptr) {
+        std::fclose(input);
+        return false;
+    }
+    size_t read;
+    while ((read = std::fread(chunk.data(), 1, chunk.size(), input)) > 0) {
+        if (gzwrite(output, chunk.data(), static_cast<unsigned>(read)) != static_cast<int>(read)) {
+            ok = false;
+            break;
+        }
+    }
+    ok = gzclose(output) == Z_OK && ok;
+#else
+    std::FILE* output = std::fopen(destination.c_str(), "wb");
+    if (output == nullptr) {
+        std::fclose(input);
+        return false;
+    }
+    GzipWriter writer;
+    size_t read;
+    while (ok && (read = std::fread(chunk.data(), 1, chunk.size(), input)) > 0) {
+        writer.Write(chunk.data(), read);
+        std::string& compressed = writer.GetOutput();
+        ok = std::fwrite(compressed.data(), 1, compressed.size(), output) == compressed.size();
+        compressed.clear();
+    }
+    if (ok) {
+        writer.Finish();
+        std::string& compressed = writer.GetOutput();
+        ok = std::fwrite(compressed.data(), 1, compressed.size(), output) == compressed.size();
+    }
+    ok = std::fclose(output) == 0 && ok;
+#endif
+
+    ok = !std::ferror(input) && ok;
+    std::fclose(input);
+    return ok;
+}
+
+} // namespace gzip
+
+} // namespace utils
@@ -0,0 +1,410 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+/*
+   Здесь хранится класс JsonReader - потоковый (SAX) разбор JSON
+   прямо из буфера ответа, без дерева узлов.
+
+   Parse(handler) проходит текст один раз и вызывает у обработчика:
+     StartObject(), EndObject(), StartArray(), EndArray(),
+     Key(std::string_view), String(std::string_view),
+     Number(std::string_view) - текст числа как есть,
+     Bool(bool), Null().
+   Строки без escape-последовательностей передаются видом прямо в
+   исходный буфер, остальные раскодируются в общий рабочий буфер.
+   Поэтому вид действителен только до следующего вызова обработчика:
+   ключ нужно сразу перевести в номер поля, а значение - скопировать
+   или разобрать.
+
+   Реализация здесь же.
+*/
+
+namespace utils {
+
+namespace json_reader {
+
+// Целое из текста числа, false если это не целое
+inline bool ToInt(std::string_view text, int& value) {
+    const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+inline bool ToInt(std::string_view text, int64_t& value) {
+    const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+// Вещественное из текста числа. from_chars для float есть не во всех
+// стандартных библиотеках, поэтому через strtof на копии в стеке
+inline bool ToFloat(std::string_view text, float& value) {
+    char buffer[64];
+    if (text.empty() || text.size() >= sizeof(buffer)) {
+        return false;
+    }
+    std::memcpy(buffer, text.data(), text.size());
+    buffer[text.size()] = '\0';
+
+    char* end = nullptr;
+    value = std::strtof(buffer, &end);
+    return end == buffer + text.size();
+}
+
+class JsonReader {
+public:
+    explicit JsonReader(std::string_view text)
+        : text_(text) {
+    }
+
+    // false, если текст не является корректным JSON. Обработчик к
+    // этому моменту мог получить часть событий
+    template <typename Handler>
+    bool Parse(Handler& handler) {
+        position_ = 0;
+        SkipSpace();
+        if (!ParseValue(handler, 0)) {
+            return false;
+        }
+        SkipSpace();
+        return position_ == text_.size();
+    }
+
+    // Смещение, на котором остановился разбор
+    size_t GetOffset() const {
+        return position_;
+    }
+
+private:
+    // Глубина вложенности, после которой текст считается некорректным
+    static constexpr size_t MAX_DEPTH = 256;
+
+    template <typename Handler>
+    bool ParseValue(Handler& handler, size_t depth) {
+        if (position_ >= text_.size()) {
+            return false;
+        }
+
+        switch (text_[position_]) {
+            case '{':
+                return ParseObject(handler, depth + 1);
+            case '[':
+                return ParseArray(handler, depth + 1);
+            case '"': {
+                std::string_view value;
+                if (!ParseString(value)) {
+                    return false;
+                }
+                handler.String(value);
+                return true;
+            }
+            case 't':
+                if (!ParseLiteral("true")) {
+                    return false;
+                }
+                handler.Bool(true);
+                return true;
+            case 'f':
+                if (!ParseLiteral("false")) {
+                    return false;
+                }
+                handler.Bool(false);
+                return true;
+            case 'n':
+                if (!ParseLiteral("null")) {
+                    return false;
+                }
+                handler.Null();
+                return true;
+            default: {
+                std::string_view value;
+                if (!ParseNumber(value)) {
+                    return false;
+                }
+                handler.Number(value);
+                return true;
+            }
+        }
+    }
+
+    template <typename Handler>
+    bool ParseObject(Handler& handler, size_t depth) {
+        if (depth > MAX_DEPTH) {
+            return false;
+        }
+        ++position_;
+        handler.StartObject();
+
+        SkipSpace();
+        if (Consume('}')) {
+            handler.EndObject();
+            return true;
+        }
+
+        while (true) {
+            std::string_view key;
+            if (position_ >= text_.size() || text_[position_] != '"' || !ParseString(key)) {
+                return false;
+            }
+            handler.Key(key);
+
+            SkipSpace();
+            if (!Consume(':')) {
+                return false;
+            }
+            SkipSpace();
+            if (!ParseValue(handler, depth)) {
+                return false;
+            }
+
+            SkipSpace();
+            if (Consume('}')) {
+                handler.EndObject();
+                return true;
+            }
+            if (!Consume(',')) {
+                return false;
+            }
+            SkipSpace();
+        }
+    }
+
+    template <typename Handler>
+    bool ParseArray(Handler& handler, size_t depth) {
+        if (depth > MAX_DEPTH) {
+            return false;
+        }
+        ++position_;
+        handler.StartArray();
+
+        SkipSpace();
+        if (Consume(']')) {
+            handler.EndArray();
+            return true;
+        }
+
+        while (true) {
+            if (!ParseValue(handler, depth)) {
+                return false;
+            }
+
+            SkipSpace();
+            if (Consume(']')) {
+                handler.EndArray();
+                return true;
+            }
+            if (!Consume(',')) {
+                return false;
+            }
+            SkipSpace();
+        }
+    }
+
+    // Курсор стоит на открывающей кавычке
+    bool ParseString(std::string_view& value) {
+        const size_t begin = ++position_;
+
+        // Быстрый путь: строка без escape-последовательностей
+        while (position_ < text_.size()) {
+            const char symbol = text_[position_];
+            if (symbol == '"') {
+                value = text_.substr(begin, position_ - begin);
+                ++position_;
+                return true;
+            }
+            if (symbol == '\\') {
+                break;
+            }
+            if (static_cast<unsigned char>(symbol) < 0x20) {
+                return false;
+            }
+            ++position_;
+        }
+        if (position_ >= text_.size()) {
+            return false;
+        }
+
+        scratch_.assign(text_.data() + begin, position_ - begin);
+        while (position_ < text_.size()) {
+            const char symbol = text_[position_++];
+            if (symbol == '"') {
+                value = scratch_;
+                return true;
+            }
+            if (static_cast<unsigned char>(symbol) < 0x20) {
+                return false;
+            }
+            if (symbol != '\\') {
+                scratch_.push_back(symbol);
+                continue;
+            }
+            if (position_ >= text_.size()) {
+                return false;
+            }
+
+            switch (text_[position_++]) {
+                case '"':
+                    scratch_.push_back('"');
+                    break;
+                case '\\':
+                    scratch_.push_back('\\');
+                    break;
+                case '/':
+                    scratch_.push_back('/');
+                    break;
+                case 'b':
+                    scratch_.push_back('\b');
+                    break;
+                case 'f':
+                    scratch_.push_back('\f');
+                    break;
+                case 'n':
+                    scratch_.push_back('\n');
+                    break;
+                case 'r':
+                    scratch_.push_back('\r');
+                    break;
+                case 't':
+                    scratch_.push_back('\t');
+                    break;
+                case 'u': {
+                    uint32_t code;
+                    if (!ParseHex(code)) {
+                        return false;
+                    }
+                    // Суррогатная пара UTF-16
+                    if (code >= 0xD800 && code <= 0xDBFF) {
+                        uint32_t low;
+                        if (!Consume('\\') || !Consume('u') || !ParseHex(low) || low < 0xDC00 || low > 0xDFFF) {
+                            return false;
+                        }
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    AppendUtf8(code);
+                    break;
+                }
+                default:
+                    return false;
+            }
+        }
+        return false;
+    }
+
+    bool ParseHex(uint32_t& code) {
+        if (position_ + 4 > text_.size()) {
+            return false;
+        }
+        code = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            const char symbol = text_[position_++];
+            code <<= 4;
+            if (symbol >= '0' && symbol <= '9') {
+                code |= symbol - '0';
+            }
+            else if (symbol >= 'a' && symbol <= 'f') {
+                code |= symbol - 'a' + 10;
+            }
+            else if (symbol >= 'A' && symbol <= 'F') {
+                code |= symbol - 'A' + 10;
+            }
+            else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void AppendUtf8(uint32_t code) {
+        if (code < 0x80) {
+            scratch_.push_back(static_cast<char>(code));
+        }
+        else if (code < 0x800) {
+            scratch_.push_back(static_cast<char>(0xC0 | (code >> 6)));
+            scratch_.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+        else if (code < 0x10000) {
+            scratch_.push_back(static_cast<char>(0xE0 | (code >> 12)));
+            scratch_.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            scratch_.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+        else {
+            scratch_.push_back(static_cast<char>(0xF0 | (code >> 18)));
+            scratch_.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+            scratch_.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            scratch_.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+    }
+
+    // Грамматика числа JSON: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+    bool ParseNumber(std::string_view& value) {
+        const size_t begin = position_;
+        Consume('-');
+
+        if (!Consume('0') && !SkipDigits()) {
+            return false;
+        }
+        if (Consume('.') && !SkipDigits()) {
+            return false;
+        }
+        if (Consume('e') || Consume('E')) {
+            if (!Consume('+')) {
+                Consume('-');
+            }
+            if (!SkipDigits()) {
+                return false;
+            }
+        }
+
+        value = text_.substr(begin, position_ - begin);
+        return true;
+    }
+
+    bool SkipDigits() {
+        const size_t begin = position_;
+        while (position_ < text_.size() && text_[position_] >= '0' && text_[position_] <= '9') {
+            ++position_;
+        }
+        return position_ > begin;
+    }
+
+    bool ParseLiteral(std::string_view literal) {
+        if (text_.compare(position_, literal.size(), literal) != 0) {
+            return false;
+        }
+        position_ += literal.size();
+        return true;
+    }
+
+    bool Consume(char symbol) {
+        if (position_ < text_.size() && text_[position_] == symbol) {
+            ++position_;
+            return true;
+        }
+        return false;
+    }
+
+    void SkipSpace() {
+        while (position_ < text_.size()) {
+            const char symbol = text_[position_];
+            if (symbol != ' ' && symbol != '\n' && symbol != '\r' && symbol != '\t') {
+                return;
+            }
+            ++position_;
+        }
+    }
+
+private:
+    std::string_view text_;
+    size_t position_ = 0;
+
+    // Раскодированная строка с escape-последовательностями
+    std::string scratch_;
+};
+
+} // namespace json_reader
+
+} // namespace utils
@@ -1,7 +1,11 @@
 #pragma once
 
+#include "async_logger.h"
+
 #include <iostream>
 #include <fstream>
+#include <memory>
+#include <string>
 #include <boost/log/trivial.hpp>
 #include <boost/log/utility/setup/file.hpp>
 #include <boost/log/utility/setup/console.hpp>
@@ -12,6 +16,10 @@
    Здесь хранятся определения методов класса LogHandler,
    который отвечает за логгирование процессов, 
    происходящих во время работы программы.
+
+   В асинхронном режиме (конструктор с AsyncLogOptions) записи уходят
+   в AsyncLogger: вызывающий поток не касается диска, а Log склеивает
+   сообщение из частей прямо в буфере записи, без std::to_string.
    
    Реализация здесь же.
 */
@@ -36,6 +44,11 @@ public:
         InitFileLogging(filename);
     }
 
+    // Асинхронный вывод в файл через AsyncLogger
+    LogHandler(const std::string& filename, const async_logger::AsyncLogOptions& options)
+        : async_(std::make_unique<async_logger::AsyncLogger>(filename, options)) {
+    }
+
     // Деструктор, очищает поток вывода логгера
     // Вызывается при разрушении объекта
     ~LogHandler() {
@@ -50,14 +63,40 @@ public:
     //
     // 2. Сообщение, которое будет выводиться при логгах
     void LogTrivial(logging::trivial::severity_level level, const std::string& message) {
+        if (async_) {
+            async_->Log(level, message);
+            return;
+        }
         // Вызывается стандартый макрос из Boost.Log
         BOOST_LOG_SEV(logger_, level) << message;
     }
 
+    // Сообщение из частей: строк, символов и чисел. В асинхронном
+    // режиме без выделений памяти и за время копирования в буфер
+    template <typename... Parts>
+    void Log(logging::trivial::severity_level level, const Parts&... parts) {
+        if (async_) {
+            async_->Log(level, parts...);
+            return;
+        }
+        async_logger::LogRecord record;
+        async_logger::RecordWriter writer(record);
+        (writer.Append(parts), ...);
+        BOOST_LOG_SEV(logger_, level) << std::string(record.text, record.length);
+    }
+
+    // Записи, отброшенные асинхронным режимом из-за переполнения буфера
+    uint64_t GetDroppedCount() const {
+        return async_ ? async_->GetDroppedCount() : 0;
+    }
+
 private:
     // Поле самого логгера
     logging::sources::severity_logger<logging::trivial::severity_level> logger_;
 
+    // Асинхронный режим, nullptr - синхронный вывод через Boost.Log
+    std::unique_ptr<async_logger::AsyncLogger> async_;
+
     // Метод вывода в консоль
     void InitConsoleLogging() {
         logging::register_simple_formatter_factory<logging::trivial::severity_level, char>("Severity");
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/*
+   Здесь хранится класс LogRing - кольцевой буфер записей
+   фиксированного размера для журналов: много писателей, один
+   читатель, без блокировок.
+
+   У каждого слота свой номер последовательности. Писатель занимает
+   слот сдвигом общего счетчика через compare_exchange, заполняет
+   запись прямо в слоте и публикует ее новым номером; читатель
+   забирает записи по порядку и возвращает слоты писателям. Запись
+   копируется один раз - при заполнении.
+
+   Реализация здесь же.
+*/
+
+namespace utils {
+
+namespace log_ring {
+
+template <typename Record>
+class LogRing {
+public:
+    explicit LogRing(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        mask_ = size - 1;
+        slots_ = std::make_unique<Slot[]>(size);
+        for (size_t i = 0; i < size; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Занимает слот, заполняет его через fill(Record&) и публикует.
+    // false, если буфер заполнен
+    template <typename Fill>
+    bool TryPush(Fill&& fill) {
+        size_t position = enqueue_.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots_[position & mask_];
+            const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                if (enqueue_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (difference < 0) {
+                return false;
+            }
+            else {
+                position = enqueue_.load(std::memory_order_relaxed);
+            }
+        }
+
+        fill(slot->record);
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Только для читателя: передает handler(const Record&) готовые
+    // записи по порядку, но не больше max_count. Возвращает их число
+    template <typename Handler>
+    size_t Drain(Handler&& handler, size_t max_count) {
+        size_t count = 0;
+        while (count < max_count) {
+            Slot& slot = slots_[dequeue_ & mask_];
+            if (slot.sequence.load(std::memory_order_acquire) != dequeue_ + 1) {
+                break;
+            }
+            handler(static_cast<const Record&>(slot.record));
+            slot.sequence.store(dequeue_ + mask_ + 1, std::memory_order_release);
+            ++dequeue_;
+            ++count;
+        }
+        return count;
+    }
+
+    size_t GetCapacity() const {
+        return mask_ + 1;
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<size_t> sequence;
+        Record record;
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_ = 0;
+
+    // Счетчики писателей и читателя на разных строках кеша
+    alignas(64) std::atomic<size_t> enqueue_{ 0 };
+    alignas(64) size_t dequeue_ = 0;
+};
+
+} // namespace log_ring
+
+} // namespace utils
@@ -0,0 +1,391 @@
+#pragma once
+
+#include "gzip_writer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__) || defined(__MINGW32__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/*
+   Здесь хранятся ротация файла журнала и архивация старых частей.
+
+   LogFile - активный файл журнала. Перед записью он проверяет, не
+   пора ли начать новый файл: по размеру (max_size) или при переходе
+   границы времени (interval, границы отсчитываются от местной
+   полуночи, например 86400 - каждые сутки в 00:00). Старый файл
+   переименовывается в часть "имя.ГГГГММДД-ЧЧММСС.расширение" и
+   передается SegmentArchiver, а запись сразу продолжается в новый
+   файл.
+
+   SegmentArchiver - фоновый поток с пониженным приоритетом: сжимает
+   части в .gz (gzip_writer.h) и удаляет самые старые, оставляя keep
+   последних. Сжатие никогда не задерживает запись в активный файл.
+   Части, не успевшие сжаться до выхода программы, сжимаются при
+   следующем запуске.
+
+   Реализация здесь же.
+*/
+
+namespace utils {
+
+namespace log_rotation {
+
+struct RotationOptions {
+    // Размер файла в байтах, после которого начинается новый; 0 - без ограничения
+    uint64_t max_size = 0;
+    // Период ротации по времени в секундах от местной полуночи; 0 - выключена
+    int64_t interval = 0;
+    // Сколько последних частей хранить; 0 - все
+    size_t keep = 0;
+    bool compress = true;
+
+    bool IsEnabled() const {
+        return max_size > 0 || interval > 0;
+    }
+};
+
+inline std::tm ToLocalTime(std::time_t time) {
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &time);
+#else
+    localtime_r(&time, &local);
+#endif
+    return local;
+}
+
+// Просит планировщик давать потоку время, только когда остальным оно
+// не нужно. Если система не позволяет, поток остается как был
+inline void LowerThreadPriority() {
+#if defined(__linux__)
+    sched_param param{};
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#elif defined(__unix__) || defined(__APPLE__) || defined(__MINGW32__)
+    sched_param param{};
+    param.sched_priority = sched_get_priority_min(SCHED_OTHER);
+    pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+#endif
+}
+
+// Имена частей журнала path: "stem.<время>[_N]ext" и они же с .gz
+class SegmentNames {
+public:
+    explicit SegmentNames(const std::filesystem::path& path)
+        : directory_(path.has_parent_path() ? path.parent_path() : std::filesystem::path("."))
+        , prefix_(path.stem().string() + ".")
+        , extension_(path.extension().string()) {
+    }
+
+    // Новое имя части по времени ротации, не занятое ни сжатой, ни
+    // несжатой частью. Номер внутри секунды только растет, даже если
+    // прежние части этой секунды уже удалены
+    std::filesystem::path Make(std::time_t time) {
+        char buffer[32];
+        const std::tm local = ToLocalTime(time);
+        std::strftime(buffer, sizeof(buffer), "%Y%m%d-%H%M%S", &local);
+        const std::string stamp = buffer;
+
+        unsigned long index = 0;
+        if (stamp == last_stamp_) {
+            index = last_index_ + 1;
+        }
+        std::filesystem::path segment;
+        do {
+            segment = directory_ / (prefix_ + stamp + (index > 0 ? "_" + std::to_string(index) : std::string()) + extension_);
+            ++index;
+        } while (Exists(segment));
+
+        last_stamp_ = stamp;
+        last_index_ = index - 1;
+        return segment;
+    }
+
+    // Все части в каталоге журнала, от старых к новым
+    std::vector<std::filesystem::path> List() const {
+        std::vector<std::filesystem::path> segments;
+        std::error_code error;
+        for (std::filesystem::directory_iterator it(directory_, error), end; !error && it != end; it.increment(error)) {
+            if (IsSegment(it->path().filename().string())) {
+                segments.push_back(it->path());
+            }
+        }
+        // Время в имени с ведущими нулями, поэтому порядок имен -
+        // порядок ротаций
+        std::sort(segments.begin(), segments.end(), [](const auto& left, const auto& right) {
+            return left.filename().string() < right.filename().string();
+        });
+        return segments;
+    }
+
+    static bool IsCompressed(const std::filesystem::path& segment) {
+        return segment.extension() == ".gz";
+    }
+
+private:
+    bool Exists(const std::filesystem::path& segment) const {
+        std::error_code error;
+        return std::filesystem::exists(segment, error) || std::filesystem::exists(segment.string() + ".gz", error);
+    }
+
+    bool IsSegment(const std::string& name) const {
+        std::string_view rest(name);
+        if (rest.substr(0, prefix_.size()) != prefix_) {
+            return false;
+        }
+        rest.remove_prefix(prefix_.size());
+        if (rest.size() > 3 && rest.substr(rest.size() - 3) == ".gz") {
+            rest.remove_suffix(3);
+        }
+        if (rest.size() <= extension_.size() || rest.substr(rest.size() - extension_.size()) != extension_) {
+            return false;
+        }
+        return std::isdigit(static_cast<unsigned char>(rest.front())) != 0;
+    }
+
+private:
+    std::filesystem::path directory_;
+    std::string prefix_;
+    std::string extension_;
+
+    std::string last_stamp_;
+    unsigned long last_index_ = 0;
+};
+
+class SegmentArchiver {
+public:
+    SegmentArchiver(const SegmentNames& names, const RotationOptions& options)
+        : names_(names)
+        , options_(options) {
+        // Части, оставшиеся несжатыми с прошлого запуска
+        if (options_.compress) {
+            for (const std::filesystem::path& segment : names_.List()) {
+                if (!SegmentNames::IsCompressed(segment)) {
+                    queue_.push_back(segment);
+                }
+            }
+        }
+        worker_ = std::thread(&SegmentArchiver::Run, this);
+    }
+
+    SegmentArchiver(const SegmentArchiver&) = delete;
+    SegmentArchiver& operator=(const SegmentArchiver&) = delete;
+
+    // Дожидается только текущей части, остальные сожмутся при
+    // следующем запуске
+    ~SegmentArchiver() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            running_ = false;
+        }
+        condition_.notify_one();
+        worker_.join();
+    }
+
+    // Вызывается писателем журнала после ротации, не ждет сжатия
+    void Add(const std::filesystem::path& segment) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(segment);
+        }
+        condition_.notify_one();
+    }
+
+private:
+    void Run() {
+        LowerThreadPriority();
+        EnforceRetention();
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            condition_.wait(lock, [this] {
+                return !running_ || !queue_.empty();
+            });
+            if (!running_) {
+                return;
+            }
+            const std::filesystem::path segment = queue_.front();
+            queue_.pop_front();
+
+            lock.unlock();
+            if (options_.compress) {
+                Compress(segment);
+            }
+            EnforceRetention();
+            lock.lock();
+        }
+    }
+
+    // Сжатый файл сначала пишется во временный, поэтому прерванное
+    // сжатие не оставляет битой части
+    void Compress(const std::filesystem::path& segment) {
+        const std::string compressed = segment.string() + ".gz";
+        const std::string temporary = compressed + ".tmp";
+        std::error_code error;
+        if (gzip::CompressFile(segment.string(), temporary)) {
+            std::filesystem::rename(temporary, compressed, error);
+            if (!error) {
+                std::filesystem::remove(segment, error);
+            }
+        } else {
+            std::filesystem::remove(temporary, error);
+        }
+    }
+
+    void EnforceRetention() {
+        if (options_.keep == 0) {
+            return;
+        }
+        const std::vector<std::filesystem::path> segments = names_.List();
+        std::error_code error;
+        for (size_t i = 0; i + options_.keep < segments.size(); ++i) {
+            std::filesystem::remove(segments[i], error);
+        }
+    }
+
+private:
+    SegmentNames names_;
+    RotationOptions options_;
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::deque<std::filesystem::path> queue_;
+    bool running_ = true;
+
+    std::thread worker_;
+};
+
+// Активный файл журнала. Все методы, кроме IsOpen, вызывает один поток
+// - писатель журнала
+class LogFile {
+public:
+    LogFile(const std::string& path, const RotationOptions& options)
+        : path_(path)
+        , names_(path_)
+        , options_(options) {
+        if (!options_.IsEnabled()) {
+            Open("w");
+            return;
+        }
+
+        // Файл прошлого запуска становится первой частью, а не затирается
+        const std::time_t now = std::time(nullptr);
+        std::error_code error;
+        if (std::filesystem::file_size(path_, error) > 0 && !error) {
+            std::filesystem::rename(path_, names_.Make(now), error);
+        }
+        archiver_ = std::make_unique<SegmentArchiver>(names_, options_);
+        Open("w");
+        next_rotation_ = NextBoundary(now);
+    }
+
+    LogFile(const LogFile&) = delete;
+    LogFile& operator=(const LogFile&) = delete;
+
+    ~LogFile() {
+        if (file_ != nullptr) {
+            std::fclose(file_);
+        }
+    }
+
+    // Пишет data в активный файл, при необходимости начав новый. С
+    // пустыми данными только проверяет границу времени
+    void Write(const char* data, size_t size) {
+        if (options_.IsEnabled() && NeedsRotation(size)) {
+            Rotate();
+        }
+        if (size == 0 || file_ == nullptr) {
+            return;
+        }
+        std::fwrite(data, 1, size, file_);
+        std::fflush(file_);
+        size_ += size;
+    }
+
+    bool IsOpen() const {
+        return open_.load(std::memory_order_relaxed);
+    }
+
+private:
+    void Open(const char* mode) {
+        file_ = std::fopen(path_.string().c_str(), mode);
+        size_ = 0;
+        open_.store(file_ != nullptr, std::memory_order_relaxed);
+    }
+
+    bool NeedsRotation(size_t incoming) {
+        if (options_.interval > 0 && std::time(nullptr) >= next_rotation_) {
+            return true;
+        }
+        return options_.max_size > 0 && size_ > 0 && size_ + incoming > options_.max_size;
+    }
+
+    // Пустой файл не становится частью, только сдвигается граница
+    void Rotate() {
+        const std::time_t now = std::time(nullptr);
+        if (options_.interval > 0) {
+            next_rotation_ = NextBoundary(now);
+        }
+        if (size_ == 0) {
+            return;
+        }
+
+        if (file_ != nullptr) {
+            std::fclose(file_);
+        }
+        const std::filesystem::path segment = names_.Make(now);
+        std::error_code error;
+        std::filesystem::rename(path_, segment, error);
+        if (!error) {
+            archiver_->Add(segment);
+        }
+        Open(error ? "a" : "w");
+    }
+
+    // Первая граница позже now: полночь + k * interval
+    std::time_t NextBoundary(std::time_t now) const {
+        if (options_.interval <= 0) {
+            return 0;
+        }
+        std::tm midnight = ToLocalTime(now);
+        midnight.tm_hour = 0;
+        midnight.tm_min = 0;
+        midnight.tm_sec = 0;
+        midnight.tm_isdst = -1;
+        const std::time_t start = std::mktime(&midnight);
+        return start + ((now - start) / options_.interval + 1) * options_.interval;
+    }
+
+private:
+    std::filesystem::path path_;
+    SegmentNames names_;
+    RotationOptions options_;
+
+    std::FILE* file_ = nullptr;
+    std::atomic<bool> open_{ false };
+    uint64_t size_ = 0;
+    std::time_t next_rotation_ = 0;
+
+    std::unique_ptr<SegmentArchiver> archiver_;
+};
+
+} // namespace log_rotation
+
+} // namespace utils
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+/*
+   Здесь хранится класс RefreshScheduler, который в фоновом потоке
+   периодически опрашивает источники данных (погоду, рейсы).
+
+   Задача источника возвращает true при успехе. После успеха
+   следующий опрос через interval секунд, после неудачи - через
+   retry_delay, и каждая следующая неудача подряд удваивает паузу до
+   max_backoff. Каждая пауза случайно растягивается или сжимается на
+   долю jitter, чтобы источники не опрашивались в один момент.
+
+   Реализация здесь же.
+*/
+
+namespace utils {
+
+namespace refresh_scheduler {
+
+class RefreshScheduler {
+public:
+    RefreshScheduler(double jitter = 0.1, double retry_delay = 5., double max_backoff = 600.)
+        : jitter_(jitter)
+        , retry_delay_(retry_delay)
+        , max_backoff_(max_backoff)
+        , random_(std::random_device{}()) {
+    }
+
+    ~RefreshScheduler() {
+        Stop();
+    }
+
+    // Добавляет источник. Первый опрос - сразу после Start
+    void Add(std::function<bool()> task, double interval) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.push_back({ std::move(task), interval, 0., Clock::now() });
+        wakeup_.notify_one();
+    }
+
+    void Start() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            running_ = true;
+            thread_ = std::thread(&RefreshScheduler::Run, this);
+        }
+    }
+
+    // Ждет завершения опроса, который идет прямо сейчас
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_) {
+                return;
+            }
+            running_ = false;
+            wakeup_.notify_one();
+        }
+        thread_.join();
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        std::function<bool()> task;
+        double interval;
+        double backoff;
+        Clock::time_point next;
+    };
+
+    void Run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (running_) {
+            if (entries_.empty()) {
+                wakeup_.wait(lock);
+                continue;
+            }
+
+            const auto due = std::min_element(entries_.begin(), entries_.end(), [](const Entry& a, const Entry& b) {
+                return a.next < b.next;
+            });
+            if (Clock::now() < due->next) {
+                wakeup_.wait_until(lock, due->next);
+                continue;
+            }
+
+            // Опрос идет без блокировки, чтобы Stop и Add не ждали сеть
+            const size_t index = static_cast<size_t>(due - entries_.begin());
+            std::function<bool()> task = entries_[index].task;
+            lock.unlock();
+            const bool success = task();
+            lock.lock();
+
+            Entry& entry = entries_[index];
+            if (success) {
+                entry.backoff = 0.;
+                entry.next = Clock::now() + Jitter(entry.interval);
+            }
+            else {
+                entry.backoff = entry.backoff == 0. ? retry_delay_ : std::min(entry.backoff * 2., max_backoff_);
+                entry.next = Clock::now() + Jitter(entry.backoff);
+            }
+        }
+    }
+
+    Clock::duration Jitter(double seconds) {
+        std::uniform_real_distribution<double> distribution(1. - jitter_, 1. + jitter_);
+        return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds * distribution(random_)));
+    }
+
+private:
+    double jitter_;
+    double retry_delay_;
+    double max_backoff_;
+    std::mt19937 random_;
+
+    std::vector<Entry> entries_;
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::thread thread_;
+    bool running_ = false;
+};
+
+} // namespace refresh_scheduler
+
+} // namespace utils
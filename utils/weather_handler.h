@@ -1,44 +1,136 @@
 #pragma once
 
-#include <boost/property_tree/json_parser.hpp>
-#include <boost/property_tree/ptree.hpp>
+#include "json_reader.h"
+
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
 #include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
 #include <SFML/Network.hpp>
 
+/*
+   Здесь хранится класс WeatherHandler, который получает погоду с
+   сайта weatherapi.com.
+
+   Refresh() вызывается фоновым потоком RefreshScheduler. Ответ
+   разбирается прямо из тела HTTP-ответа потоковым JsonReader и
+   заодно сохраняется в файл outfile_path; пока файл моложе cache_ttl
+   секунд, запрос не отправляется и разбирается файл - перезапуск
+   программы в пределах TTL обходится без сети. Значения собираются в новый
+   WeatherData и публикуются целиком (атомарная замена указателя),
+   поэтому интерфейс никогда не видит наполовину обновленные данные.
+
+   Адрес сервера (weather-host, weather-port) берется из настроек,
+   так что вместо weatherapi.com можно поднять локальный сервер,
+   отдающий /v1/current.json, и проверять обновление без сети.
+
+   Реализация здесь же.
+*/
+
 namespace utils {
 
 namespace weather_handler {
 
+// Один опрос погоды. Значения хранятся числами, в текст они
+// переводятся только при выводе
+struct WeatherData {
+    float temperature = 0.f;
+    float pressure = 0.f;
+    int humidity = 0;
+    float wind_kph = 0.f;
+    int wind_angle = 0;
+    bool is_day = true;
+    std::string timezone;
+    // Сдвиг местного времени от UTC, секунды. Часы интерфейса
+    // считаются от него, переменная TZ процесса не трогается
+    int utc_offset = 0;
+
+    // Румб, откуда дует ветер
+    std::string_view GetWindDirection() const {
+        static constexpr std::array<std::string_view, 9> directions = { "С", "СВ", "В", "ЮВ", "Ю", "ЮЗ", "З", "СЗ", "С" };
+        const size_t index = static_cast<size_t>((wind_angle + 22.5) / 45) % 8;
+        return directions[index];
+    }
+
+    std::string_view GetTimesOfDay() const {
+        return is_day ? "День" : "Вечер";
+    }
+
+    // Приземный ветер в ENU (восток, север), м/с. wind_degree - откуда
+    // дует ветер, поэтому вектор направлен в обратную сторону
+    sf::Vector2f GetWindVector() const {
+        const float speed = wind_kph / 3.6f;
+        const float angle = wind_angle * static_cast<float>(M_PI) / 180.f;
+        return { -speed * std::sin(angle), -speed * std::cos(angle) };
+    }
+};
+
 class WeatherHandler {
 public:
     WeatherHandler() {
         ParseSettingsFile();
     }
 
-    void Initialize() {
-        SendRequest();
-        ProcessWeatherValues();
+    // Один опрос: из файла кеша, если он свежее TTL, иначе запросом.
+    // false, если данных получить не удалось
+    bool Refresh() {
+        try {
+            const bool loaded = IsCacheFresh() ? ReadCache() : SendRequest();
+            if (!loaded || !ProcessWeatherValues(buffer)) {
+                ++failures;
+                return false;
+            }
+            return true;
+        }
+        catch (const std::exception&) {
+            ++failures;
+            return false;
+        }
     }
 
-private:
-    char is_day;
-    int wind_angle;
+    // Последние опубликованные данные, nullptr до первого успешного опроса
+    std::shared_ptr<const WeatherData> GetData() const {
+        return std::atomic_load(&data);
+    }
 
-public:
-    std::string temperature;
-    std::string pressure;
-    std::string humidity;
-    std::string wind_speed;
-    std::string wind_dir;
-    std::string times_of_day;
-    std::string timezone;
+    // Растет с каждой публикацией
+    uint64_t GetVersion() const {
+        return version.load(std::memory_order_acquire);
+    }
+
+    uint64_t GetFailureCount() const {
+        return failures.load(std::memory_order_relaxed);
+    }
+
+    double GetRefreshInterval() const {
+        return refresh_interval;
+    }
 
 private:
+    std::shared_ptr<const WeatherData> data;
+    std::atomic<uint64_t> version{ 0 };
+    std::atomic<uint64_t> failures{ 0 };
+
     const std::string settings_path = "../utils/weather_settings.txt";
 
+    // Без ограничения зависший запрос держал бы поток обновления вечно
+    const sf::Time request_timeout = sf::seconds(10.f);
+
     std::string api_key;
     std::string region;
     std::string outfile_path;
+    std::string host = "http://api.weatherapi.com";
+    unsigned short port = 0;
+    double refresh_interval = 600.;
+    double cache_ttl = 300.;
 
     std::string buffer;
 
@@ -46,19 +138,32 @@ private:
         std::ifstream settings{ settings_path };
 
         if (settings.is_open()) {
-            const char EQUAL_SIGN = '=';
-            size_t i = 0;
-            std::array<std::string, 3> params;
+            const std::string SEPARATOR = " = ";
+            std::map<std::string, std::string> params;
 
             std::string line;
             while (std::getline(settings, line)) {
-                std::string param = line.substr(line.find(EQUAL_SIGN) + 2);
-                params[i++] = param;
+                const size_t separator = line.find(SEPARATOR);
+                if (separator != std::string::npos) {
+                    params[line.substr(0, separator)] = line.substr(separator + SEPARATOR.size());
+                }
             }
 
-            api_key = params[0];
-            region = params[1];
-            outfile_path = params[2];
+            api_key = params["weather-api-key"];
+            region = params["weather-region"];
+            outfile_path = params["weather-outfile-path"];
+            if (!params["weather-host"].empty()) {
+                host = params["weather-host"];
+            }
+            if (!params["weather-port"].empty()) {
+                port = static_cast<unsigned short>(std::stoi(params["weather-port"]));
+            }
+            if (!params["weather-refresh-interval"].empty()) {
+                refresh_interval = std::stod(params["weather-refresh-interval"]);
+            }
+            if (!params["weather-cache-ttl"].empty()) {
+                cache_ttl = std::stod(params["weather-cache-ttl"]);
+            }
 
             settings.close();
             return 0;
@@ -67,56 +172,266 @@ private:
         return -1;
     }
 
-    void SendRequest() {
-        std::ofstream outfile{ outfile_path };
+    bool IsCacheFresh() const {
+        std::error_code error;
+        const auto modified = std::filesystem::last_write_time(outfile_path, error);
+        if (error) {
+            return false;
+        }
+        const std::chrono::duration<double> age = std::filesystem::file_time_type::clock::now() - modified;
+        return age.count() < cache_ttl;
+    }
 
+    bool SendRequest() {
         sf::Http::Request request("/v1/current.json?key=" + api_key + "&q=" + region + "&aqi=no");
-        sf::Http http("http://api.weatherapi.com");
+        sf::Http http(host, port);
 
-        sf::Http::Response response = http.sendRequest(request);
-        if (response.getStatus() == sf::Http::Response::Ok) {
-            buffer = response.getBody();
-            outfile << buffer << '\n';
+        sf::Http::Response response = http.sendRequest(request, request_timeout);
+        if (response.getStatus() != sf::Http::Response::Ok) {
+            return false;
         }
-        else {
-            outfile << "Request failed with status code: " << response.getStatus() << '\n';
+
+        buffer = response.getBody();
+        WriteCache();
+        return true;
+    }
+
+    bool ReadCache() {
+        std::ifstream cache{ outfile_path, std::ios::binary };
+        if (!cache.is_open()) {
+            return false;
         }
+        buffer.assign(std::istreambuf_iterator<char>(cache), std::istreambuf_iterator<char>());
+        return true;
+    }
 
+    // Пишем во временный файл и переименовываем, чтобы в кеше не
+    // остался обрезанный ответ. Кеш не записался - не беда, данные
+    // уже в памяти
+    void WriteCache() const {
+        const std::string temporary_path = outfile_path + ".tmp";
+        std::ofstream outfile{ temporary_path, std::ios::binary };
+        outfile << buffer;
         outfile.close();
+        if (outfile) {
+            std::rename(temporary_path.c_str(), outfile_path.c_str());
+        }
     }
 
-    std::string GetWindDirection(int wind_angle) const {
-        std::array<std::string, 9> directions = { "С", "СВ", "В", "ЮВ", "Ю", "ЮЗ", "З", "СЗ", "С" };
-        size_t index = static_cast<int>((wind_angle + 22.5) / 45) % 8;
-        return directions[index];
-    }
+    // Обработчик событий JsonReader: из всего ответа нужны несколько
+    // полей объектов current и location
+    class WeatherJsonHandler {
+    public:
+        explicit WeatherJsonHandler(WeatherData& values)
+            : values(values) {
+        }
+
+        void StartObject() {
+            ++depth;
+            if (depth == 2) {
+                section = pending_section;
+            }
+        }
+
+        void EndObject() {
+            if (depth == 2) {
+                section = Section::NONE;
+            }
+            --depth;
+        }
+
+        void StartArray() {
+            ++depth;
+        }
+
+        void EndArray() {
+            --depth;
+        }
+
+        void Key(std::string_view key) {
+            field = Field::NONE;
+            if (depth == 1) {
+                pending_section = key == "current" ? Section::CURRENT : key == "location" ? Section::LOCATION : Section::NONE;
+            }
+            else if (depth == 2 && section == Section::CURRENT) {
+                if (key == "temp_c") {
+                    field = Field::TEMPERATURE;
+                }
+                else if (key == "pressure_mb") {
+                    field = Field::PRESSURE;
+                }
+                else if (key == "humidity") {
+                    field = Field::HUMIDITY;
+                }
+                else if (key == "wind_kph") {
+                    field = Field::WIND_KPH;
+                }
+                else if (key == "wind_degree") {
+                    field = Field::WIND_DEGREE;
+                }
+                else if (key == "is_day") {
+                    field = Field::IS_DAY;
+                }
+            }
+            else if (depth == 2 && section == Section::LOCATION) {
+                if (key == "tz_id") {
+                    field = Field::TIMEZONE;
+                }
+                else if (key == "localtime_epoch") {
+                    field = Field::LOCAL_EPOCH;
+                }
+                else if (key == "localtime") {
+                    field = Field::LOCAL_TIME;
+                }
+            }
+        }
 
-    void ProcessWeatherValues() {
-        boost::property_tree::ptree pt;
-        boost::property_tree::read_json(outfile_path, pt);
+        // Числа разбираются из текста, поэтому строка и число
+        // обрабатываются одинаково
+        void String(std::string_view value) {
+            Value(value);
+        }
+
+        void Number(std::string_view value) {
+            Value(value);
+        }
+
+        void Bool(bool) {
+            field = Field::NONE;
+        }
 
-        temperature = std::move(pt.get<std::string>("current.temp_c"));
-        pressure = std::move(pt.get<std::string>("current.pressure_mb"));
-        humidity = std::move(pt.get<std::string>("current.humidity"));
-        wind_speed = std::move(pt.get<std::string>("current.wind_kph"));
+        void Null() {
+            field = Field::NONE;
+        }
+
+        bool IsComplete() const {
+            return (found & REQUIRED_FIELDS) == REQUIRED_FIELDS;
+        }
+
+        // Сдвиг от UTC по местному времени и моменту UTC из ответа,
+        // 0 без них. Местное время дано с точностью до минуты, поэтому
+        // сдвиг округляется до 15 минут - шага реальных поясов
+        int GetUtcOffset() const {
+            if ((found & LOCAL_TIME_FIELDS) != LOCAL_TIME_FIELDS) {
+                return 0;
+            }
+            const double quarters = std::round(static_cast<double>(local_time - local_epoch) / 900.);
+            return static_cast<int>(quarters) * 900;
+        }
+
+    private:
+        enum class Section { NONE, CURRENT, LOCATION };
+        enum class Field { NONE, TEMPERATURE, PRESSURE, HUMIDITY, WIND_KPH, WIND_DEGREE, IS_DAY, TIMEZONE, LOCAL_EPOCH, LOCAL_TIME };
+        static constexpr uint32_t REQUIRED_FIELDS = (1u << 7) - 1;
+        static constexpr uint32_t LOCAL_TIME_FIELDS = (1u << 7) | (1u << 8);
+
+        // "2024-05-01 9:05" в секунды от эпохи, как если бы это было UTC
+        static bool ParseLocalTime(std::string_view text, int64_t& seconds) {
+            int year = 0, month = 0, day = 0, hour = 0, minute = 0;
+            const char* position = text.data();
+            const char* end = text.data() + text.size();
+            const auto read = [&](int& value, char separator) {
+                const auto result = std::from_chars(position, end, value);
+                if (result.ec != std::errc() || (separator != '\0' && (result.ptr == end || *result.ptr != separator))) {
+                    return false;
+                }
+                position = separator != '\0' ? result.ptr + 1 : result.ptr;
+                return true;
+            };
+            if (!read(year, '-') || !read(month, '-') || !read(day, ' ') || !read(hour, ':') || !read(minute, '\0')
+                || position != end || month < 1 || month > 12) {
+                return false;
+            }
+
+            // Число дней от 1970-01-01 по григорианскому календарю
+            const int shifted_year = month <= 2 ? year - 1 : year;
+            const int era = (shifted_year >= 0 ? shifted_year : shifted_year - 399) / 400;
+            const int year_of_era = shifted_year - era * 400;
+            const int day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+            const int day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+            const int64_t days = static_cast<int64_t>(era) * 146097 + day_of_era - 719468;
+            seconds = days * 86400 + hour * 3600 + minute * 60;
+            return true;
+        }
+
+        void Value(std::string_view value) {
+            switch (field) {
+                case Field::NONE:
+                    return;
+                case Field::TEMPERATURE:
+                    if (!json_reader::ToFloat(value, values.temperature)) {
+                        return;
+                    }
+                    break;
+                case Field::PRESSURE:
+                    if (!json_reader::ToFloat(value, values.pressure)) {
+                        return;
+                    }
+                    break;
+                case Field::HUMIDITY:
+                    if (!json_reader::ToInt(value, values.humidity)) {
+                        return;
+                    }
+                    break;
+                case Field::WIND_KPH:
+                    if (!json_reader::ToFloat(value, values.wind_kph)) {
+                        return;
+                    }
+                    break;
+                case Field::WIND_DEGREE:
+                    if (!json_reader::ToInt(value, values.wind_angle)) {
+                        return;
+                    }
+                    break;
+                case Field::IS_DAY:
+                    values.is_day = value != "0";
+                    break;
+                case Field::TIMEZONE:
+                    values.timezone.assign(value);
+                    break;
+                case Field::LOCAL_EPOCH:
+                    if (!json_reader::ToInt(value, local_epoch)) {
+                        return;
+                    }
+                    break;
+                case Field::LOCAL_TIME:
+                    if (!ParseLocalTime(value, local_time)) {
+                        return;
+                    }
+                    break;
+            }
+            found |= 1u << (static_cast<uint32_t>(field) - 1);
+            field = Field::NONE;
+        }
 
-        wind_angle = pt.get<int>("current.wind_degree");
-        wind_dir = std::move(GetWindDirection(wind_angle));
+    private:
+        WeatherData& values;
+        size_t depth = 0;
+        Section section = Section::NONE;
+        Section pending_section = Section::NONE;
+        Field field = Field::NONE;
+        uint32_t found = 0;
+        int64_t local_epoch = 0;
+        int64_t local_time = 0;
+    };
 
-        is_day = pt.get<char>("current.is_day");
-        switch(is_day) {
-            case '0':
-                times_of_day = std::move("Вечер");
-                break;
-            case '1':
-                times_of_day = std::move("День");
-                break;
+    // Разбирает ответ и публикует его. false, если ответ некорректен
+    // или в нем нет нужных полей
+    bool ProcessWeatherValues(std::string_view body) {
+        auto values = std::make_shared<WeatherData>();
+        WeatherJsonHandler handler(*values);
+        json_reader::JsonReader reader(body);
+        if (!reader.Parse(handler) || !handler.IsComplete()) {
+            return false;
         }
+        values->utc_offset = handler.GetUtcOffset();
 
-        timezone = pt.get<std::string>("location.tz_id");
+        std::atomic_store(&data, std::shared_ptr<const WeatherData>(std::move(values)));
+        version.fetch_add(1, std::memory_order_release);
+        return true;
     }
 };
 
 } // namespace weather_handler
 
-} // namespace utils
\ No newline at end of file
+} // namespace utils